@@ -0,0 +1,1085 @@
+// Copyright (c) 2020-2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Speed and accuracy of the loc_geometry entry points.
+//
+// usage: loc_geometry_benchmark [-n calls] [-a]
+//   -n  calls per entry point and distribution, 200000 by default
+//   -a  accuracy checks only
+//
+// Output is one JSON object per line, so that runs can be compared with jq or diff:
+//   {"kind":"timing","entry":...,"set":...,"calls":...,"ns_per_call":...,"calls_per_sec":...}
+//   {"kind":"accuracy","entry":...,"set":...,"cases":...,"max_error":...,"limit":...,"unit":...,"pass":...}
+// Accuracy is checked against loc_geometry_reference.h (see make_geometry_reference.py),
+// and the exit status is 1 if any check fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <loc_geometry.h>
+#include <loc_geohash.h>
+
+#include "loc_geometry_reference.h"
+
+#define DEFAULT_CALLS       200000
+#define TIMING_REPEATS      3
+#define METERS_PER_DEGREE   111319.49
+
+#define RTCEP_ENGINE_REFS   256
+#define ARRAY_SIZE(a)       ((int)(sizeof(a) / sizeof((a)[0])))
+
+typedef enum {
+    SET_MID_LATITUDE,
+    SET_POLAR,
+    SET_ANTIMERIDIAN,
+    SET_ZONE_EDGE,
+    SET_GLOBAL,
+    SET_NEAR_ANTIPODAL
+} BenchmarkSetId;
+
+// Pairs of positions of one distribution, in every layout the entry points take
+typedef struct {
+    BenchmarkSetId id;
+    int size;
+    GEOCoordinates *from;
+    GEOCoordinates *to;
+    double *from_lat, *from_lon, *to_lat, *to_lon;
+    // positions around from[0], for the local projection, statistics and tracks
+    GEOCoordinates *near;
+    double *near_lat, *near_lon;
+    UTMCoordinates *utm;
+    ECEFCoordinates *ecef;
+    GEOCoordinatesE7 *e7;
+    LocalOffset *offsets;
+    LocalProjection *local;
+    double *out, *out2;
+    GEOCoordinates *out_geo;
+    ECEFCoordinates *out_ecef;
+    ENUCoordinates *out_enu;
+} BenchmarkData;
+
+typedef struct {
+    const char *name;
+    void (*run)(BenchmarkData *data);
+} BenchmarkEntry;
+
+typedef struct {
+    DISTANCE_MODE mode;
+    const char *category;
+    double limit;
+    int relative;
+} DistanceLimit;
+
+static const char *s_setNames[] = {
+    "mid_latitude",
+    "polar",
+    "antimeridian",
+    "zone_edge",
+    "global",
+    "near_antipodal"
+};
+
+static const char *s_modeNames[] = {
+    "equirectangular",
+    "haversine",
+    "andoyer_lambert",
+    "vincenty",
+    "geodesic"
+};
+
+// Documented worst case errors of each mode, where they are documented to hold
+static const DistanceLimit s_distanceLimits[] = {
+    { DISTANCE_MODE_EQUIRECTANGULAR, "local", 6e-3, 1 },
+    { DISTANCE_MODE_EQUIRECTANGULAR, "regional", 6e-3, 1 },
+    { DISTANCE_MODE_EQUIRECTANGULAR, "antimeridian", 6e-3, 1 },
+    { DISTANCE_MODE_EQUIRECTANGULAR, "zone_edge", 6e-3, 1 },
+    { DISTANCE_MODE_HAVERSINE, "local", 6e-3, 1 },
+    { DISTANCE_MODE_HAVERSINE, "regional", 6e-3, 1 },
+    { DISTANCE_MODE_HAVERSINE, "global", 6e-3, 1 },
+    { DISTANCE_MODE_HAVERSINE, "antimeridian", 6e-3, 1 },
+    { DISTANCE_MODE_HAVERSINE, "zone_edge", 6e-3, 1 },
+    { DISTANCE_MODE_HAVERSINE, "near_antipodal", 6e-3, 1 },
+    { DISTANCE_MODE_ANDOYER_LAMBERT, "local", 1.5e-6, 1 },
+    { DISTANCE_MODE_ANDOYER_LAMBERT, "regional", 1.5e-6, 1 },
+    { DISTANCE_MODE_ANDOYER_LAMBERT, "antimeridian", 1.5e-6, 1 },
+    { DISTANCE_MODE_ANDOYER_LAMBERT, "zone_edge", 1.5e-6, 1 },
+    { DISTANCE_MODE_ANDOYER_LAMBERT, "global", 2e-4, 1 },
+    { DISTANCE_MODE_VINCENTY, "local", 1e-4, 0 },
+    { DISTANCE_MODE_VINCENTY, "regional", 1e-4, 0 },
+    { DISTANCE_MODE_VINCENTY, "global", 1e-4, 0 },
+    { DISTANCE_MODE_VINCENTY, "polar", 1e-4, 0 },
+    { DISTANCE_MODE_VINCENTY, "antimeridian", 1e-4, 0 },
+    { DISTANCE_MODE_VINCENTY, "zone_edge", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "local", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "regional", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "global", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "polar", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "antimeridian", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "zone_edge", 1e-4, 0 },
+    { DISTANCE_MODE_GEODESIC, "near_antipodal", 1e-4, 0 }
+};
+
+static volatile double s_sink;
+static int s_failures;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double random_range(double min, double max)
+{
+    return min + (max - min) * (rand() / (double) RAND_MAX);
+}
+
+static double wrap_longitude(double longitude)
+{
+    if (longitude >= 180.0)
+        return longitude - 360.0;
+    if (longitude < -180.0)
+        return longitude + 360.0;
+
+    return longitude;
+}
+
+static void make_pair(BenchmarkSetId id, GEOCoordinates *from, GEOCoordinates *to)
+{
+    double edge, sign;
+
+    switch (id) {
+    case SET_MID_LATITUDE:
+        from->latitude = random_range(-60.0, 60.0);
+        from->longitude = random_range(-180.0, 180.0);
+        to->latitude = from->latitude + random_range(-0.05, 0.05);
+        to->longitude = wrap_longitude(from->longitude + random_range(-0.1, 0.1));
+        break;
+    case SET_POLAR:
+        sign = (rand() & 1) ? 1.0 : -1.0;
+        from->latitude = sign * random_range(80.0, 89.99);
+        from->longitude = random_range(-180.0, 180.0);
+        to->latitude = sign * random_range(80.0, 89.99);
+        to->longitude = wrap_longitude(from->longitude + random_range(-30.0, 30.0));
+        break;
+    case SET_ANTIMERIDIAN:
+        from->latitude = random_range(-60.0, 60.0);
+        from->longitude = 180.0 - random_range(1e-6, 0.05);
+        to->latitude = from->latitude + random_range(-0.05, 0.05);
+        to->longitude = -180.0 + random_range(0.0, 0.05);
+        break;
+    case SET_ZONE_EDGE:
+        edge = -180.0 + 6.0 * (1 + rand() % 59);
+        from->latitude = random_range(-60.0, 60.0);
+        from->longitude = edge - random_range(1e-6, 0.05);
+        to->latitude = from->latitude + random_range(-0.05, 0.05);
+        to->longitude = edge + random_range(0.0, 0.05);
+        break;
+    case SET_NEAR_ANTIPODAL:
+        from->latitude = random_range(-60.0, 60.0);
+        from->longitude = random_range(-180.0, 180.0);
+        to->latitude = -from->latitude + random_range(-0.5, 0.5);
+        to->longitude = wrap_longitude(from->longitude + 180.0 + random_range(-0.5, 0.5));
+        break;
+    case SET_GLOBAL:
+    default:
+        from->latitude = random_range(-85.0, 85.0);
+        from->longitude = random_range(-180.0, 180.0);
+        to->latitude = random_range(-85.0, 85.0);
+        to->longitude = random_range(-180.0, 180.0);
+        break;
+    }
+}
+
+static void *alloc_or_exit(size_t size)
+{
+    void *p = malloc(size);
+
+    if (!p) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+
+    return p;
+}
+
+static void data_init(BenchmarkData *data, BenchmarkSetId id, int size)
+{
+    int i;
+
+    data->id = id;
+    data->size = size;
+    data->from = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    data->to = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    data->from_lat = alloc_or_exit(sizeof(double) * size);
+    data->from_lon = alloc_or_exit(sizeof(double) * size);
+    data->to_lat = alloc_or_exit(sizeof(double) * size);
+    data->to_lon = alloc_or_exit(sizeof(double) * size);
+    data->near = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    data->near_lat = alloc_or_exit(sizeof(double) * size);
+    data->near_lon = alloc_or_exit(sizeof(double) * size);
+    data->utm = alloc_or_exit(sizeof(UTMCoordinates) * size);
+    data->ecef = alloc_or_exit(sizeof(ECEFCoordinates) * size);
+    data->e7 = alloc_or_exit(sizeof(GEOCoordinatesE7) * size);
+    data->offsets = alloc_or_exit(sizeof(LocalOffset) * size);
+    data->out = alloc_or_exit(sizeof(double) * size);
+    data->out2 = alloc_or_exit(sizeof(double) * size);
+    data->out_geo = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    data->out_ecef = alloc_or_exit(sizeof(ECEFCoordinates) * size);
+    data->out_enu = alloc_or_exit(sizeof(ENUCoordinates) * size);
+
+    for (i = 0; i < size; i++) {
+        make_pair(id, &data->from[i], &data->to[i]);
+        data->from_lat[i] = data->from[i].latitude;
+        data->from_lon[i] = data->from[i].longitude;
+        data->to_lat[i] = data->to[i].latitude;
+        data->to_lon[i] = data->to[i].longitude;
+    }
+
+    for (i = 0; i < size; i++) {
+        data->near[i].latitude = fmax(-89.99, fmin(89.99, data->from[0].latitude + random_range(-0.25, 0.25)));
+        data->near[i].longitude = wrap_longitude(data->from[0].longitude + random_range(-0.25, 0.25));
+        data->near_lat[i] = data->near[i].latitude;
+        data->near_lon[i] = data->near[i].longitude;
+    }
+
+    // inputs of the inverse conversions and unpacking
+    loc_geometry_convert_wgs84_to_utm_batch(data->to, data->utm, size);
+    loc_geometry_convert_wgs84_to_ecef_batch(data->to, NULL, data->ecef, size);
+    loc_geometry_pack_e7(data->to, data->e7, size);
+    data->local = loc_geometry_local_create(&data->from[0]);
+    loc_geometry_local_pack(&data->local, data->near, data->offsets, size);
+}
+
+static void data_free(BenchmarkData *data)
+{
+    free(data->from);
+    free(data->to);
+    free(data->from_lat);
+    free(data->from_lon);
+    free(data->to_lat);
+    free(data->to_lon);
+    free(data->near);
+    free(data->near_lat);
+    free(data->near_lon);
+    free(data->utm);
+    free(data->ecef);
+    free(data->e7);
+    free(data->offsets);
+    free(data->out);
+    free(data->out2);
+    free(data->out_geo);
+    free(data->out_ecef);
+    free(data->out_enu);
+    loc_geometry_local_destroy(&data->local);
+}
+
+/*
+ * Timed entry points, each over all the pairs of a set
+ */
+
+static void run_calc_distance(BenchmarkData *d)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < d->size; i++)
+        sum += loc_geometry_calc_distance(d->from[i].latitude, d->from[i].longitude,
+                                          d->to[i].latitude, d->to[i].longitude);
+    s_sink = sum;
+}
+
+static void run_distance_mode(BenchmarkData *d, DISTANCE_MODE mode)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < d->size; i++)
+        sum += loc_geometry_calc_distance_mode(d->from[i].latitude, d->from[i].longitude,
+                                               d->to[i].latitude, d->to[i].longitude, mode);
+    s_sink = sum;
+}
+
+static void run_mode_equirectangular(BenchmarkData *d) { run_distance_mode(d, DISTANCE_MODE_EQUIRECTANGULAR); }
+static void run_mode_haversine(BenchmarkData *d) { run_distance_mode(d, DISTANCE_MODE_HAVERSINE); }
+static void run_mode_andoyer_lambert(BenchmarkData *d) { run_distance_mode(d, DISTANCE_MODE_ANDOYER_LAMBERT); }
+static void run_mode_vincenty(BenchmarkData *d) { run_distance_mode(d, DISTANCE_MODE_VINCENTY); }
+static void run_mode_geodesic(BenchmarkData *d) { run_distance_mode(d, DISTANCE_MODE_GEODESIC); }
+
+static void run_distance_batch(BenchmarkData *d)
+{
+    loc_geometry_calc_distance_batch(d->from, d->to, d->out, d->size);
+}
+
+static void run_distance_one_to_many(BenchmarkData *d)
+{
+    loc_geometry_calc_distance_one_to_many(d->from[0], d->to, d->out, d->size);
+}
+
+static void run_distance_batch_soa(BenchmarkData *d)
+{
+    loc_geometry_calc_distance_batch_soa(d->from_lat, d->from_lon, d->to_lat, d->to_lon, d->out, d->size);
+}
+
+static void run_distance_one_to_many_soa(BenchmarkData *d)
+{
+    loc_geometry_calc_distance_one_to_many_soa(d->from[0], d->to_lat, d->to_lon, d->out, d->size);
+}
+
+// Positions around from[0] taken as one track, a second apart
+static void run_polyline_length(BenchmarkData *d)
+{
+    s_sink = loc_geometry_calc_polyline_length(d->near, d->size);
+}
+
+static void run_polyline(BenchmarkData *d)
+{
+    long long *timestamps = alloc_or_exit(sizeof(long long) * d->size);
+    int i;
+
+    for (i = 0; i < d->size; i++)
+        timestamps[i] = i * 1000LL;
+
+    s_sink = loc_geometry_calc_polyline(d->near, timestamps, d->out, d->out2, d->size);
+    free(timestamps);
+}
+
+static void run_wgs84_to_utm(BenchmarkData *d)
+{
+    UTMCoordinates utm;
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < d->size; i++) {
+        utm = loc_geometry_convert_wgs84_to_utm(d->to[i]);
+        sum += utm.easting;
+    }
+    s_sink = sum;
+}
+
+static void run_utm_to_wgs84(BenchmarkData *d)
+{
+    GEOCoordinates geo;
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < d->size; i++) {
+        geo = loc_geometry_convert_utm_to_wgs84(d->utm[i]);
+        sum += geo.latitude;
+    }
+    s_sink = sum;
+}
+
+static void run_wgs84_to_utm_batch(BenchmarkData *d)
+{
+    UTMCoordinates *utm = alloc_or_exit(sizeof(UTMCoordinates) * d->size);
+
+    loc_geometry_convert_wgs84_to_utm_batch(d->to, utm, d->size);
+    s_sink = utm[d->size - 1].easting;
+    free(utm);
+}
+
+static void run_utm_to_wgs84_batch(BenchmarkData *d)
+{
+    loc_geometry_convert_utm_to_wgs84_batch(d->utm, d->out_geo, d->size);
+}
+
+static void run_wgs84_to_ecef_batch(BenchmarkData *d)
+{
+    loc_geometry_convert_wgs84_to_ecef_batch(d->to, NULL, d->out_ecef, d->size);
+}
+
+static void run_ecef_to_wgs84_batch(BenchmarkData *d)
+{
+    loc_geometry_convert_ecef_to_wgs84_batch(d->ecef, d->out_geo, d->out, d->size);
+}
+
+static void run_local_project(BenchmarkData *d)
+{
+    double east, north, sum = 0;
+    int i;
+
+    for (i = 0; i < d->size; i++) {
+        loc_geometry_local_project(&d->local, &d->near[i], &east, &north);
+        sum += east + north;
+    }
+    s_sink = sum;
+}
+
+static void run_local_project_soa(BenchmarkData *d)
+{
+    loc_geometry_local_project_soa(&d->local, d->near_lat, d->near_lon, d->out, d->out2, d->size);
+}
+
+static void run_local_ecef_to_enu(BenchmarkData *d)
+{
+    loc_geometry_local_ecef_to_enu(&d->local, d->ecef, d->out_enu, d->size);
+}
+
+static void run_local_enu_to_ecef(BenchmarkData *d)
+{
+    loc_geometry_local_ecef_to_enu(&d->local, d->ecef, d->out_enu, d->size);
+    loc_geometry_local_enu_to_ecef(&d->local, d->out_enu, d->out_ecef, d->size);
+}
+
+static void run_pack_e7(BenchmarkData *d)
+{
+    GEOCoordinatesE7 *e7 = alloc_or_exit(sizeof(GEOCoordinatesE7) * d->size);
+
+    loc_geometry_pack_e7(d->to, e7, d->size);
+    s_sink = e7[d->size - 1].latitude;
+    free(e7);
+}
+
+static void run_unpack_e7(BenchmarkData *d)
+{
+    loc_geometry_unpack_e7(d->e7, d->out_geo, d->size);
+}
+
+static void run_local_pack(BenchmarkData *d)
+{
+    LocalOffset *offsets = alloc_or_exit(sizeof(LocalOffset) * d->size);
+
+    loc_geometry_local_pack(&d->local, d->near, offsets, d->size);
+    s_sink = offsets[d->size - 1].east;
+    free(offsets);
+}
+
+static void run_local_unpack(BenchmarkData *d)
+{
+    loc_geometry_local_unpack(&d->local, d->offsets, d->out_geo, d->size);
+}
+
+static void run_calculate_cep(BenchmarkData *d)
+{
+    s_sink = loc_geometry_calculate_cep(d->near, d->size, &d->from[0]);
+}
+
+static void run_calculate_drms_local(BenchmarkData *d)
+{
+    s_sink = loc_geometry_calculate_drms_with_projection(d->near, d->size, &d->from[0], STATS_PROJECTION_LOCAL);
+}
+
+static void run_calculate_statistics(BenchmarkData *d)
+{
+    ErrorStatistics stats;
+
+    loc_geometry_calculate_statistics(d->near, d->size, &d->from[0], STATS_PROJECTION_UTM, &stats);
+    s_sink = stats.cep;
+}
+
+static void run_calculate_statistics_local(BenchmarkData *d)
+{
+    ErrorStatistics stats;
+
+    loc_geometry_calculate_statistics(d->near, d->size, &d->from[0], STATS_PROJECTION_LOCAL, &stats);
+    s_sink = stats.cep;
+}
+
+static void run_rtcep(BenchmarkData *d, STATS_PROJECTION projection, RTCEP_ESTIMATE estimate, int window)
+{
+    RTCEPCalculator *rtcep = loc_geometry_rtcep_create(&d->from[0]);
+    int i;
+
+    loc_geometry_rtcep_set_projection(&rtcep, projection);
+    loc_geometry_rtcep_set_estimate(&rtcep, estimate);
+    loc_geometry_rtcep_set_window(&rtcep, window, 0);
+
+    for (i = 0; i < d->size; i++)
+        loc_geometry_rtcep_update_with_time(&rtcep, &d->near[i], i);
+
+    s_sink = loc_geometry_rtcep_get_cep(&rtcep);
+    loc_geometry_rtcep_destroy(&rtcep);
+}
+
+static void run_rtcep_update(BenchmarkData *d) { run_rtcep(d, STATS_PROJECTION_UTM, RTCEP_ESTIMATE_GAUSSIAN, 0); }
+static void run_rtcep_update_local(BenchmarkData *d) { run_rtcep(d, STATS_PROJECTION_LOCAL, RTCEP_ESTIMATE_GAUSSIAN, 0); }
+static void run_rtcep_update_quantile(BenchmarkData *d) { run_rtcep(d, STATS_PROJECTION_LOCAL, RTCEP_ESTIMATE_QUANTILE, 0); }
+static void run_rtcep_update_window(BenchmarkData *d) { run_rtcep(d, STATS_PROJECTION_LOCAL, RTCEP_ESTIMATE_QUANTILE, 1000); }
+
+static void run_rtcep_update_batch(BenchmarkData *d)
+{
+    RTCEPCalculator *rtcep = loc_geometry_rtcep_create(&d->from[0]);
+
+    loc_geometry_rtcep_update_batch(&rtcep, d->near, d->size);
+    s_sink = loc_geometry_rtcep_get_drms(&rtcep);
+    loc_geometry_rtcep_destroy(&rtcep);
+}
+
+// Fixes spread round robin over references taken from the same positions
+static void run_rtcep_engine(BenchmarkData *d, STATS_PROJECTION projection)
+{
+    int num_refs = (d->size < RTCEP_ENGINE_REFS) ? d->size : RTCEP_ENGINE_REFS;
+    RTCEPEngine *engine = loc_geometry_rtcep_engine_create(d->near, num_refs);
+    int *indexes = alloc_or_exit(sizeof(int) * d->size);
+    int i;
+
+    for (i = 0; i < d->size; i++)
+        indexes[i] = i % num_refs;
+
+    loc_geometry_rtcep_engine_set_projection(&engine, projection);
+    loc_geometry_rtcep_engine_update_batch(&engine, indexes, d->near, d->size);
+    s_sink = loc_geometry_rtcep_engine_get_drms(&engine, 0);
+    loc_geometry_rtcep_engine_destroy(&engine);
+    free(indexes);
+}
+
+static void run_rtcep_engine_update_batch(BenchmarkData *d) { run_rtcep_engine(d, STATS_PROJECTION_UTM); }
+static void run_rtcep_engine_update_batch_local(BenchmarkData *d) { run_rtcep_engine(d, STATS_PROJECTION_LOCAL); }
+
+static void run_cluster_dbscan(BenchmarkData *d)
+{
+    int *labels = alloc_or_exit(sizeof(int) * d->size);
+
+    s_sink = loc_geometry_cluster_dbscan(d->near, d->size, 500.0, 4, labels);
+    free(labels);
+}
+
+static void run_geohash_encode_batch(BenchmarkData *d)
+{
+    uint64_t *cells = alloc_or_exit(sizeof(uint64_t) * d->size);
+
+    loc_geohash_encode_batch(d->to, cells, d->size, 9);
+    s_sink = (double)cells[d->size - 1];
+    free(cells);
+}
+
+static void run_simplifier_add(BenchmarkData *d)
+{
+    TrajectorySimplifier *simplifier = loc_geometry_simplifier_create(5.0, 0);
+    GEOCoordinates kept;
+    int i, count = 0;
+
+    for (i = 0; i < d->size; i++)
+        count += loc_geometry_simplifier_add(&simplifier, &d->near[i], &kept);
+
+    s_sink = count;
+    loc_geometry_simplifier_destroy(&simplifier);
+}
+
+// Entry points that follow the global precision, run at the fast precision
+static void run_fast(BenchmarkData *d, void (*run)(BenchmarkData *data))
+{
+    loc_geometry_set_precision(GEOMETRY_PRECISION_FAST);
+    run(d);
+    loc_geometry_set_precision(GEOMETRY_PRECISION_EXACT);
+}
+
+static void run_calc_distance_fast(BenchmarkData *d) { run_fast(d, run_calc_distance); }
+static void run_distance_batch_fast(BenchmarkData *d) { run_fast(d, run_distance_batch); }
+static void run_distance_one_to_many_fast(BenchmarkData *d) { run_fast(d, run_distance_one_to_many); }
+static void run_wgs84_to_utm_fast(BenchmarkData *d) { run_fast(d, run_wgs84_to_utm); }
+static void run_utm_to_wgs84_fast(BenchmarkData *d) { run_fast(d, run_utm_to_wgs84); }
+static void run_wgs84_to_utm_batch_fast(BenchmarkData *d) { run_fast(d, run_wgs84_to_utm_batch); }
+static void run_utm_to_wgs84_batch_fast(BenchmarkData *d) { run_fast(d, run_utm_to_wgs84_batch); }
+static void run_wgs84_to_ecef_batch_fast(BenchmarkData *d) { run_fast(d, run_wgs84_to_ecef_batch); }
+static void run_ecef_to_wgs84_batch_fast(BenchmarkData *d) { run_fast(d, run_ecef_to_wgs84_batch); }
+
+static const BenchmarkEntry s_entries[] = {
+    { "calc_distance", run_calc_distance },
+    { "calc_distance_mode/equirectangular", run_mode_equirectangular },
+    { "calc_distance_mode/haversine", run_mode_haversine },
+    { "calc_distance_mode/andoyer_lambert", run_mode_andoyer_lambert },
+    { "calc_distance_mode/vincenty", run_mode_vincenty },
+    { "calc_distance_mode/geodesic", run_mode_geodesic },
+    { "calc_distance_batch", run_distance_batch },
+    { "calc_distance_one_to_many", run_distance_one_to_many },
+    { "calc_distance_batch_soa", run_distance_batch_soa },
+    { "calc_distance_one_to_many_soa", run_distance_one_to_many_soa },
+    { "calc_polyline_length", run_polyline_length },
+    { "calc_polyline", run_polyline },
+    { "convert_wgs84_to_utm", run_wgs84_to_utm },
+    { "convert_utm_to_wgs84", run_utm_to_wgs84 },
+    { "convert_wgs84_to_utm_batch", run_wgs84_to_utm_batch },
+    { "convert_utm_to_wgs84_batch", run_utm_to_wgs84_batch },
+    { "convert_wgs84_to_ecef_batch", run_wgs84_to_ecef_batch },
+    { "convert_ecef_to_wgs84_batch", run_ecef_to_wgs84_batch },
+    { "local_project", run_local_project },
+    { "local_project_soa", run_local_project_soa },
+    { "local_ecef_to_enu", run_local_ecef_to_enu },
+    { "local_ecef_to_enu+enu_to_ecef", run_local_enu_to_ecef },
+    { "pack_e7", run_pack_e7 },
+    { "unpack_e7", run_unpack_e7 },
+    { "local_pack", run_local_pack },
+    { "local_unpack", run_local_unpack },
+    { "calculate_cep", run_calculate_cep },
+    { "calculate_drms_with_projection/local", run_calculate_drms_local },
+    { "calculate_statistics", run_calculate_statistics },
+    { "calculate_statistics/local", run_calculate_statistics_local },
+    { "rtcep_update", run_rtcep_update },
+    { "rtcep_update/local", run_rtcep_update_local },
+    { "rtcep_update/quantile", run_rtcep_update_quantile },
+    { "rtcep_update/window", run_rtcep_update_window },
+    { "rtcep_update_batch", run_rtcep_update_batch },
+    { "rtcep_engine_update_batch", run_rtcep_engine_update_batch },
+    { "rtcep_engine_update_batch/local", run_rtcep_engine_update_batch_local },
+    { "simplifier_add", run_simplifier_add },
+    { "cluster_dbscan", run_cluster_dbscan },
+    { "geohash_encode_batch", run_geohash_encode_batch },
+    { "calc_distance/fast", run_calc_distance_fast },
+    { "calc_distance_batch/fast", run_distance_batch_fast },
+    { "calc_distance_one_to_many/fast", run_distance_one_to_many_fast },
+    { "convert_wgs84_to_utm/fast", run_wgs84_to_utm_fast },
+    { "convert_utm_to_wgs84/fast", run_utm_to_wgs84_fast },
+    { "convert_wgs84_to_utm_batch/fast", run_wgs84_to_utm_batch_fast },
+    { "convert_utm_to_wgs84_batch/fast", run_utm_to_wgs84_batch_fast },
+    { "convert_wgs84_to_ecef_batch/fast", run_wgs84_to_ecef_batch_fast },
+    { "convert_ecef_to_wgs84_batch/fast", run_ecef_to_wgs84_batch_fast }
+};
+
+static void run_timing(int calls)
+{
+    BenchmarkData data;
+    double start, elapsed, best;
+    int set, entry, repeat;
+
+    for (set = SET_MID_LATITUDE; set <= SET_NEAR_ANTIPODAL; set++) {
+        data_init(&data, set, calls);
+
+        for (entry = 0; entry < ARRAY_SIZE(s_entries); entry++) {
+            best = 0;
+            for (repeat = 0; repeat < TIMING_REPEATS; repeat++) {
+                start = now_ns();
+                s_entries[entry].run(&data);
+                elapsed = now_ns() - start;
+
+                if (repeat == 0 || elapsed < best)
+                    best = elapsed;
+            }
+
+            printf("{\"kind\":\"timing\",\"entry\":\"%s\",\"set\":\"%s\",\"calls\":%d,"
+                   "\"ns_per_call\":%.2f,\"calls_per_sec\":%.4e}\n",
+                   s_entries[entry].name, s_setNames[set], calls, best / calls, calls * 1e9 / best);
+        }
+
+        data_free(&data);
+    }
+}
+
+/*
+ * Accuracy against the reference values
+ */
+
+static void report(const char *entry, const char *set, int cases, double max_error, double limit, const char *unit)
+{
+    int pass = (max_error <= limit);
+
+    if (!pass)
+        s_failures++;
+
+    printf("{\"kind\":\"accuracy\",\"entry\":\"%s\",\"set\":\"%s\",\"cases\":%d,"
+           "\"max_error\":%.4e,\"limit\":%.4e,\"unit\":\"%s\",\"pass\":%s}\n",
+           entry, set, cases, max_error, limit, unit, pass ? "true" : "false");
+}
+
+static double relative_error(double value, double reference)
+{
+    return (reference > 0) ? fabs(value - reference) / reference : fabs(value);
+}
+
+// The batch kernels compute the same Vincenty distances as loc_geometry_calc_distance, bit for bit
+static void check_distance_batch(const char *entry)
+{
+    const ReferenceDistance *ref;
+    GEOCoordinates from, to;
+    double distance, max_error, batch;
+    int i, cases;
+
+    max_error = 0;
+    cases = 0;
+    for (i = 0; i < ARRAY_SIZE(s_refDistances); i++) {
+        ref = &s_refDistances[i];
+        from.latitude = ref->lat1;
+        from.longitude = ref->lon1;
+        to.latitude = ref->lat2;
+        to.longitude = ref->lon2;
+
+        distance = loc_geometry_calc_distance(ref->lat1, ref->lon1, ref->lat2, ref->lon2);
+        loc_geometry_calc_distance_batch(&from, &to, &batch, 1);
+        max_error = fmax(max_error, fabs(batch - distance));
+        loc_geometry_calc_distance_one_to_many(from, &to, &batch, 1);
+        max_error = fmax(max_error, fabs(batch - distance));
+        loc_geometry_calc_distance_batch_soa(&ref->lat1, &ref->lon1, &ref->lat2, &ref->lon2, &batch, 1);
+        max_error = fmax(max_error, fabs(batch - distance));
+        loc_geometry_calc_distance_one_to_many_soa(from, &ref->lat2, &ref->lon2, &batch, 1);
+        max_error = fmax(max_error, fabs(batch - distance));
+        cases++;
+    }
+    report(entry, "all", cases, max_error, 0, "m");
+}
+
+// The same, on all the reference pairs in one batch, which takes the SIMD lanes at the fast precision.
+// Bit for bit unless multiply-adds are fused, then within the last digits.
+static void check_distance_lanes(const char *entry)
+{
+    const ReferenceDistance *ref;
+    GEOCoordinates *from, *to;
+    double *batch, *one_to_many, distance, max_error;
+    int i, size = ARRAY_SIZE(s_refDistances);
+
+    from = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    to = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    batch = alloc_or_exit(sizeof(double) * size);
+    one_to_many = alloc_or_exit(sizeof(double) * size);
+
+    for (i = 0; i < size; i++) {
+        ref = &s_refDistances[i];
+        from[i].latitude = ref->lat1;
+        from[i].longitude = ref->lon1;
+        to[i].latitude = ref->lat2;
+        to[i].longitude = ref->lon2;
+    }
+
+    loc_geometry_calc_distance_batch(from, to, batch, size);
+    loc_geometry_calc_distance_one_to_many(from[0], to, one_to_many, size);
+
+    max_error = 0;
+    for (i = 0; i < size; i++) {
+        distance = loc_geometry_calc_distance(from[i].latitude, from[i].longitude, to[i].latitude, to[i].longitude);
+        max_error = fmax(max_error, fabs(batch[i] - distance));
+        distance = loc_geometry_calc_distance(from[0].latitude, from[0].longitude, to[i].latitude, to[i].longitude);
+        max_error = fmax(max_error, fabs(one_to_many[i] - distance));
+    }
+    report(entry, "all", size, max_error, 1e-8, "m");
+
+    free(from);
+    free(to);
+    free(batch);
+    free(one_to_many);
+}
+
+static void check_distances(void)
+{
+    const ReferenceDistance *ref;
+    const DistanceLimit *limit;
+    double distance, error, max_error;
+    char entry[64];
+    int i, l, cases, fast;
+
+    // Vincenty and the geodesic have the same limits at the fast precision
+    for (fast = 0; fast <= 1; fast++) {
+        loc_geometry_set_precision(fast ? GEOMETRY_PRECISION_FAST : GEOMETRY_PRECISION_EXACT);
+
+        for (l = 0; l < ARRAY_SIZE(s_distanceLimits); l++) {
+            limit = &s_distanceLimits[l];
+            if (fast && limit->mode != DISTANCE_MODE_VINCENTY && limit->mode != DISTANCE_MODE_GEODESIC)
+                continue;
+
+            max_error = 0;
+            cases = 0;
+
+            for (i = 0; i < ARRAY_SIZE(s_refDistances); i++) {
+                ref = &s_refDistances[i];
+                if (strcmp(ref->category, limit->category) != 0)
+                    continue;
+
+                distance = loc_geometry_calc_distance_mode(ref->lat1, ref->lon1, ref->lat2, ref->lon2, limit->mode);
+                error = limit->relative ? relative_error(distance, ref->distance) : fabs(distance - ref->distance);
+                max_error = fmax(max_error, error);
+                cases++;
+            }
+
+            snprintf(entry, sizeof(entry), "calc_distance_mode/%s%s", s_modeNames[limit->mode], fast ? "/fast" : "");
+            report(entry, limit->category, cases, max_error, limit->limit, limit->relative ? "relative" : "m");
+        }
+    }
+
+    // the fast precision against the exact one, within its documented bound
+    max_error = 0;
+    for (i = 0; i < ARRAY_SIZE(s_refDistances); i++) {
+        ref = &s_refDistances[i];
+        distance = loc_geometry_calc_distance_with_precision(ref->lat1, ref->lon1, ref->lat2, ref->lon2,
+                                                             GEOMETRY_PRECISION_EXACT);
+        error = fabs(loc_geometry_calc_distance_with_precision(ref->lat1, ref->lon1, ref->lat2, ref->lon2,
+                                                               GEOMETRY_PRECISION_FAST) - distance);
+        max_error = fmax(max_error, error);
+    }
+    report("calc_distance_with_precision/fast", "all", ARRAY_SIZE(s_refDistances), max_error, 1e-6, "m");
+
+    loc_geometry_set_precision(GEOMETRY_PRECISION_EXACT);
+    check_distance_batch("calc_distance_batch/scalar");
+    loc_geometry_set_precision(GEOMETRY_PRECISION_FAST);
+    check_distance_batch("calc_distance_batch/scalar/fast");
+    check_distance_lanes("calc_distance_batch/lanes/fast");
+    loc_geometry_set_precision(GEOMETRY_PRECISION_EXACT);
+}
+
+static void check_utm_case(const ReferenceUTM *ref, GEOMETRY_PRECISION precision,
+                           double *forward_error, double *inverse_error)
+{
+    UTMCoordinates utm;
+    GEOCoordinates geo;
+    double error;
+
+    geo.latitude = ref->latitude;
+    geo.longitude = ref->longitude;
+    utm = loc_geometry_convert_wgs84_to_utm_with_precision(geo, precision);
+
+    if (utm.grid_zone != ref->grid_zone || utm.hemisphere != ref->hemisphere)
+        error = INFINITY;
+    else
+        error = fmax(fabs(utm.easting - ref->easting), fabs(utm.northing - ref->northing));
+    *forward_error = fmax(*forward_error, error);
+
+    utm.easting = ref->easting;
+    utm.northing = ref->northing;
+    utm.grid_zone = ref->grid_zone;
+    utm.hemisphere = ref->hemisphere;
+    geo = loc_geometry_convert_utm_to_wgs84_with_precision(utm, precision);
+
+    error = METERS_PER_DEGREE * fmax(fabs(geo.latitude - ref->latitude),
+                                     fabs(wrap_longitude(geo.longitude - ref->longitude)) *
+                                     cos(ref->latitude * M_PI / 180));
+    *inverse_error = fmax(*inverse_error, error);
+}
+
+// The batches on all the reference coordinates, which take the SIMD lanes at the fast precision,
+// against one at a time. Bit for bit unless multiply-adds are fused, then within the last digits.
+static void check_utm_lanes(void)
+{
+    GEOCoordinates *geo, *batch_geo, one_geo;
+    UTMCoordinates *utm, *batch_utm, one_utm;
+    double forward_error = 0, inverse_error = 0;
+    int i, size = ARRAY_SIZE(s_refUTM);
+
+    geo = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    batch_geo = alloc_or_exit(sizeof(GEOCoordinates) * size);
+    utm = alloc_or_exit(sizeof(UTMCoordinates) * size);
+    batch_utm = alloc_or_exit(sizeof(UTMCoordinates) * size);
+
+    for (i = 0; i < size; i++) {
+        geo[i].latitude = s_refUTM[i].latitude;
+        geo[i].longitude = s_refUTM[i].longitude;
+        utm[i].easting = s_refUTM[i].easting;
+        utm[i].northing = s_refUTM[i].northing;
+        utm[i].grid_zone = s_refUTM[i].grid_zone;
+        utm[i].hemisphere = s_refUTM[i].hemisphere;
+    }
+
+    loc_geometry_set_precision(GEOMETRY_PRECISION_FAST);
+    loc_geometry_convert_wgs84_to_utm_batch(geo, batch_utm, size);
+    loc_geometry_convert_utm_to_wgs84_batch(utm, batch_geo, size);
+    loc_geometry_set_precision(GEOMETRY_PRECISION_EXACT);
+
+    for (i = 0; i < size; i++) {
+        one_utm = loc_geometry_convert_wgs84_to_utm_with_precision(geo[i], GEOMETRY_PRECISION_FAST);
+        if (one_utm.grid_zone != batch_utm[i].grid_zone || one_utm.hemisphere != batch_utm[i].hemisphere)
+            forward_error = INFINITY;
+        else
+            forward_error = fmax(forward_error, fmax(fabs(one_utm.easting - batch_utm[i].easting),
+                                                     fabs(one_utm.northing - batch_utm[i].northing)));
+
+        one_geo = loc_geometry_convert_utm_to_wgs84_with_precision(utm[i], GEOMETRY_PRECISION_FAST);
+        inverse_error = fmax(inverse_error, METERS_PER_DEGREE * fmax(fabs(one_geo.latitude - batch_geo[i].latitude),
+                                                                     fabs(one_geo.longitude - batch_geo[i].longitude)));
+    }
+    report("convert_wgs84_to_utm_batch/lanes/fast", "all", size, forward_error, 1e-8, "m");
+    report("convert_utm_to_wgs84_batch/lanes/fast", "all", size, inverse_error, 1e-8, "m");
+
+    free(geo);
+    free(batch_geo);
+    free(utm);
+    free(batch_utm);
+}
+
+static void check_utm(void)
+{
+    const ReferenceUTM *ref;
+    const char *category = NULL;
+    double forward_error[2] = {0}, inverse_error[2] = {0};
+    int i, cases = 0;
+
+    for (i = 0; i <= ARRAY_SIZE(s_refUTM); i++) {
+        ref = (i < ARRAY_SIZE(s_refUTM)) ? &s_refUTM[i] : NULL;
+
+        // report each category as it ends
+        if (category && (!ref || strcmp(ref->category, category) != 0)) {
+            report("convert_wgs84_to_utm", category, cases, forward_error[0], 1e-6, "m");
+            report("convert_utm_to_wgs84", category, cases, inverse_error[0], 1e-6, "m");
+            report("convert_wgs84_to_utm/fast", category, cases, forward_error[1], 1e-6, "m");
+            report("convert_utm_to_wgs84/fast", category, cases, inverse_error[1], 1e-6, "m");
+            forward_error[0] = forward_error[1] = inverse_error[0] = inverse_error[1] = 0;
+            cases = 0;
+        }
+
+        if (!ref)
+            break;
+
+        category = ref->category;
+        check_utm_case(ref, GEOMETRY_PRECISION_EXACT, &forward_error[0], &inverse_error[0]);
+        check_utm_case(ref, GEOMETRY_PRECISION_FAST, &forward_error[1], &inverse_error[1]);
+        cases++;
+    }
+}
+
+static void check_local(void)
+{
+    const ReferenceLocal *ref;
+    LocalProjection *local;
+    LocalOffset offset;
+    GEOCoordinates origin, position, unpacked;
+    GEOCoordinatesE7 e7;
+    ECEFCoordinates ecef, back;
+    ENUCoordinates enu;
+    double east, north, height;
+    double project_error = 0, pack_error = 0, e7_error = 0, enu_error = 0, ecef_error = 0;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(s_refLocal); i++) {
+        ref = &s_refLocal[i];
+        origin.latitude = ref->origin_latitude;
+        origin.longitude = ref->origin_longitude;
+        position.latitude = ref->latitude;
+        position.longitude = ref->longitude;
+
+        local = loc_geometry_local_create(&origin);
+        loc_geometry_local_project(&local, &position, &east, &north);
+        project_error = fmax(project_error, fmax(fabs(east - ref->east), fabs(north - ref->north)));
+
+        loc_geometry_local_pack(&local, &position, &offset, 1);
+        loc_geometry_local_unpack(&local, &offset, &unpacked, 1);
+        pack_error = fmax(pack_error, loc_geometry_calc_distance(position.latitude, position.longitude,
+                                                                 unpacked.latitude, unpacked.longitude));
+
+        ecef = loc_geometry_convert_wgs84_to_ecef(position, 0);
+        loc_geometry_local_ecef_to_enu(&local, &ecef, &enu, 1);
+        enu_error = fmax(enu_error, fmax(fabs(enu.east - ref->east), fabs(enu.north - ref->north)));
+        loc_geometry_local_enu_to_ecef(&local, &enu, &back, 1);
+        unpacked = loc_geometry_convert_ecef_to_wgs84(back, &height);
+        ecef_error = fmax(ecef_error, fmax(fabs(height),
+                                           loc_geometry_calc_distance(position.latitude, position.longitude,
+                                                                      unpacked.latitude, unpacked.longitude)));
+        loc_geometry_local_destroy(&local);
+
+        loc_geometry_pack_e7(&position, &e7, 1);
+        loc_geometry_unpack_e7(&e7, &unpacked, 1);
+        e7_error = fmax(e7_error, fmax(fabs(unpacked.latitude - position.latitude),
+                                       fabs(unpacked.longitude - position.longitude)));
+    }
+
+    report("local_project", "within_50km", ARRAY_SIZE(s_refLocal), project_error, 1e-6, "m");
+    report("local_ecef_to_enu", "within_50km", ARRAY_SIZE(s_refLocal), enu_error, 1e-6, "m");
+    report("ecef/enu round trip", "within_50km", ARRAY_SIZE(s_refLocal), ecef_error, 1e-6, "m");
+    report("local_pack/unpack", "within_50km", ARRAY_SIZE(s_refLocal), pack_error, 5e-3, "m");
+    report("pack_e7/unpack_e7", "within_50km", ARRAY_SIZE(s_refLocal), e7_error, 0.5e-7 * (1 + 1e-9), "deg");
+}
+
+static void check_statistics(void)
+{
+    const ReferenceStatistics *ref;
+    GEOCoordinates position = s_refStatisticsPosition;
+    GEOCoordinates *measures = (GEOCoordinates *)s_refStatisticsMeasures;
+    int size = ARRAY_SIZE(s_refStatisticsMeasures);
+    RTCEPCalculator *rtcep;
+    RTCEPEngine *engine;
+    GEOCoordinates refs[2];
+    int indexes[ARRAY_SIZE(s_refStatisticsMeasures)];
+    ErrorStatistics stats;
+    double error;
+    const char *set;
+    int i, j;
+
+    // the reference of the measures second, after one of no measures
+    refs[0] = s_refStatisticsMeasures[0];
+    refs[1] = position;
+    for (j = 0; j < size; j++)
+        indexes[j] = 1;
+
+    for (i = 0; i < ARRAY_SIZE(s_refStatistics); i++) {
+        ref = &s_refStatistics[i];
+        set = (ref->projection == STATS_PROJECTION_LOCAL) ? "local" : "utm";
+
+        error = relative_error(loc_geometry_calculate_cep_with_projection(measures, size, &position,
+                                                                          ref->projection), ref->cep);
+        error = fmax(error, relative_error(loc_geometry_calculate_drms_with_projection(measures, size, &position,
+                                                                                       ref->projection), ref->drms));
+        error = fmax(error, relative_error(loc_geometry_calculate_2drms_with_projection(measures, size, &position,
+                                                                                        ref->projection), ref->twice_drms));
+        error = fmax(error, relative_error(loc_geometry_calculate_r95_with_projection(measures, size, &position,
+                                                                                      ref->projection), ref->r95));
+        report("calculate_cep/drms/2drms/r95", set, size, error, 1e-9, "relative");
+
+        loc_geometry_calculate_statistics(measures, size, &position, ref->projection, &stats);
+        error = relative_error(stats.cep, ref->cep);
+        error = fmax(error, relative_error(stats.drms, ref->drms));
+        error = fmax(error, relative_error(stats.twice_drms, ref->twice_drms));
+        error = fmax(error, relative_error(stats.r95, ref->r95));
+        report("calculate_statistics", set, size, error, 1e-9, "relative");
+
+        rtcep = loc_geometry_rtcep_create(&position);
+        loc_geometry_rtcep_set_projection(&rtcep, ref->projection);
+        loc_geometry_rtcep_update_batch(&rtcep, measures, size);
+        error = relative_error(loc_geometry_rtcep_get_cep(&rtcep), ref->cep);
+        error = fmax(error, relative_error(loc_geometry_rtcep_get_drms(&rtcep), ref->drms));
+        error = fmax(error, relative_error(loc_geometry_rtcep_get_2drms(&rtcep), ref->twice_drms));
+        error = fmax(error, relative_error(loc_geometry_rtcep_get_r95(&rtcep), ref->r95));
+        report("rtcep", set, size, error, 1e-9, "relative");
+        loc_geometry_rtcep_destroy(&rtcep);
+
+        engine = loc_geometry_rtcep_engine_create(refs, 2);
+        loc_geometry_rtcep_engine_set_projection(&engine, ref->projection);
+        loc_geometry_rtcep_engine_update_batch(&engine, indexes, measures, size);
+        error = relative_error(loc_geometry_rtcep_engine_get_cep(&engine, 1), ref->cep);
+        error = fmax(error, relative_error(loc_geometry_rtcep_engine_get_drms(&engine, 1), ref->drms));
+        error = fmax(error, relative_error(loc_geometry_rtcep_engine_get_2drms(&engine, 1), ref->twice_drms));
+        error = fmax(error, relative_error(loc_geometry_rtcep_engine_get_r95(&engine, 1), ref->r95));
+        report("rtcep_engine", set, size, error, 1e-9, "relative");
+        loc_geometry_rtcep_engine_destroy(&engine);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int calls = DEFAULT_CALLS;
+    int accuracy_only = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:a")) != -1) {
+        switch (opt) {
+        case 'n':
+            calls = atoi(optarg);
+            break;
+        case 'a':
+            accuracy_only = 1;
+            break;
+        default:
+            calls = 0;
+            break;
+        }
+    }
+
+    if (calls <= 0) {
+        fprintf(stderr, "usage: %s [-n calls] [-a]\n", argv[0]);
+        return 2;
+    }
+
+    check_distances();
+    check_utm();
+    check_utm_lanes();
+    check_local();
+    check_statistics();
+
+    if (!accuracy_only) {
+        srand(1);
+        run_timing(calls);
+    }
+
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,359 @@
+// Generated by make_geometry_reference.py, do not edit
+
+typedef struct {
+    const char *category;
+    double lat1, lon1, lat2, lon2;
+    double distance;
+} ReferenceDistance;
+
+typedef struct {
+    const char *category;
+    double latitude, longitude;
+    double easting, northing;
+    unsigned int grid_zone;
+    UTM_HEMISPHERE hemisphere;
+} ReferenceUTM;
+
+typedef struct {
+    double origin_latitude, origin_longitude;
+    double latitude, longitude;
+    double east, north;
+} ReferenceLocal;
+
+typedef struct {
+    STATS_PROJECTION projection;
+    double cep, drms, twice_drms, r95;
+} ReferenceStatistics;
+
+static const ReferenceDistance s_refDistances[] = {
+    { "local", -64.752988253121714, -153.30899601858201, -64.714796273528748, -153.31143274514253, 4259.5523812792699 },
+    { "local", -20.919445533197475, 8.2197186575901924, -20.871034996086806, 8.2799210385481956, 8243.814380864118 },
+    { "local", 30.935395587502072, 102.66969491238751, 30.890073572403278, 102.76722246453193, 10590.665681808283 },
+    { "local", -64.914465120348012, -60.532396873929159, -64.873436270395388, -60.631238810588286, 6545.2377887680068 },
+    { "local", 1.9808191957664718, 26.581320056670393, 1.9922697075579963, 26.54236087966197, 4515.475246407731 },
+    { "local", -31.800244158437835, 71.21785622712369, -31.771168472902055, 71.290352001613485, 7585.47339479312 },
+    { "local", 14.353182660922172, -111.21631002821093, 14.333571703809053, -111.218879703729, 2187.4387680876739 },
+    { "local", 42.330684603402943, 179.4527289123422, 42.331207303890949, 179.45682464173132, 342.52717668342825 },
+    { "local", 46.399783647859948, 145.23523121807017, 46.429578574586863, 145.32018595766743, 7323.2680429944458 },
+    { "local", -39.178545883765743, 21.099380676480507, -39.132291798336354, 21.020689891039098, 8522.4856179419512 },
+    { "local", -5.8719665159078147, -177.08537288692958, -5.8354869230633968, -177.15591795291473, 8792.450679395366 },
+    { "local", 13.413383385018875, 150.12565484187991, 13.42606818026012, 150.08099684530248, 5035.932156947626 },
+    { "local", -3.7097764989749891, 55.975502467760862, -3.7033018681347603, 55.915802565256342, 6670.4881461024934 },
+    { "local", -26.807728445593114, 135.91453752080372, -26.788801834903555, 135.89882741800375, 2614.9206531351265 },
+    { "local", -66.046596689319699, -167.45241695529043, -66.072516056211342, -167.39684578444025, 3832.7846974083368 },
+    { "local", -14.151886028559403, 137.94106878042453, -14.113255315155225, 137.85967531133667, 9772.4367928650736 },
+    { "local", -27.854674128558692, -138.06911540453117, -27.850202955482175, -137.97032551700408, 9742.9694722898039 },
+    { "local", 78.719971530782175, 49.961345325188745, 78.698458275685113, 49.88186714290498, 2964.7140354394792 },
+    { "local", 7.1886593684128286, -135.88296870596099, 7.1453043113221053, -135.9671656717604, 10463.244213715845 },
+    { "local", -46.283585827583231, -66.8684248320763, -46.264636139307733, -66.826578150417575, 3852.3949521918044 },
+    { "regional", -25.367278237695842, -159.06728163364517, -24.885490229233369, -159.09613268086994, 53449.207246700651 },
+    { "regional", -79.134902617523181, -26.991209934792465, -79.220623054140745, -26.908193211048939, 9728.0676408237996 },
+    { "regional", 69.229807896125152, -39.916944728348625, 69.410182384813893, -39.118284204129253, 37368.844659644019 },
+    { "regional", -9.7271260033131881, 81.131248987843719, -9.6228177555176373, 80.597224395083003, 59732.116971721829 },
+    { "regional", -55.98024175731959, -96.948375167076875, -55.645178314046561, -96.847325860633148, 37839.520621484982 },
+    { "regional", -79.303822061691278, -80.856454951494641, -79.29719066900617, -81.730489372083895, 18137.585086294806 },
+    { "regional", 83.434091533528971, 168.47623146680939, 83.44043100872149, 168.83489921343983, 4632.8265558175244 },
+    { "regional", -43.072261705644515, 106.4704976394986, -42.892176077431373, 106.41808199043055, 20457.846919722702 },
+    { "regional", 15.707748503827219, -133.10569893059997, 15.949843488528073, -133.07608445455219, 26976.678713630172 },
+    { "regional", 17.27086265894836, 147.44374555634482, 17.074413807468712, 146.69422867884214, 82650.175545435122 },
+    { "regional", -27.773616642374648, -55.184551509269781, -28.076913438483391, -54.261902137714713, 96835.777511579989 },
+    { "regional", 11.767051032905712, 77.855767550257951, 12.094914968147405, 78.644971123256028, 93305.569518522258 },
+    { "regional", 72.500580140068166, 116.102310757515, 72.330727478384802, 115.27279228637866, 33797.126272552639 },
+    { "regional", 45.705935917363746, 87.44853790316057, 45.309156086141655, 88.4229661158721, 87995.70579198061 },
+    { "regional", -4.2847317622993444, 55.168888350571621, -4.5917635118337348, 54.680060135347389, 64001.717435649793 },
+    { "regional", -36.82809419030329, -126.4969982397669, -37.117185848151905, -126.42796914676069, 32666.056412326194 },
+    { "regional", -49.885411702190829, -71.290623335618406, -49.959887856775929, -71.570927914727193, 21766.766630450824 },
+    { "regional", -32.54876508938171, 18.743341840088249, -32.587817496499071, 18.822732818618192, 8621.8711277594157 },
+    { "regional", -24.996619261365389, 91.543932731330358, -24.784755322202432, 90.864823922604387, 72518.896230016107 },
+    { "regional", 78.364261587087668, 71.498400745845515, 78.149885859925178, 70.679363857162798, 30321.144684125484 },
+    { "global", -20.27287492524836, -90.727425366364344, -75.446765404503182, -153.26806884110823, 7079938.9197885757 },
+    { "global", 62.931785469760484, -56.859086548132211, -10.226595620246783, -40.23950722151082, 8236668.337170125 },
+    { "global", -57.962682547996359, -46.612253087461227, 30.065626331094791, 146.84605110726363, 16737266.856062239 },
+    { "global", 81.270348331583335, 95.400615621544773, -68.486186821297366, 50.204992042096194, 16842377.181509726 },
+    { "global", 61.851049415398393, -64.691180090343067, 39.889997119186859, -142.11356803108217, 5561467.9621473318 },
+    { "global", 54.067892155737184, 38.4464861884436, 75.09005468450934, 76.536524897940467, 2863055.0429612123 },
+    { "global", 54.683457703412131, -136.89754684099157, 72.539292195389265, 163.03295441099687, 3360942.0032469807 },
+    { "global", -79.921850928362062, -82.070874999816766, -54.275856880962593, 84.989542103592385, 5087704.980230202 },
+    { "global", 26.246283461793695, -31.445318900499387, -22.711397932271197, 79.386838510196981, 13091535.762960359 },
+    { "global", 54.15301013420202, -116.05033599256421, 2.814895379742282, -155.7474346337093, 6735407.8457934083 },
+    { "global", 25.199725534565573, -45.538116443715921, 41.905182778386134, 97.581894157312604, 11666672.703186115 },
+    { "global", -14.245868566019283, -3.1914420712118101, 60.688573731158527, 129.80479983126469, 13624708.155633369 },
+    { "global", -80.557210150308265, -142.40683439091015, -44.552710098316595, -25.016420962098863, 5612958.947820086 },
+    { "global", 27.782718702779903, 84.47318292405896, -14.941774102361776, 158.24866658402073, 9246471.6920439117 },
+    { "global", 75.229002830724056, 81.632999125772926, 37.665265340631606, -128.62186067714896, 7289034.2562062945 },
+    { "global", -33.330063089797065, -138.67462793345013, -64.760847364836437, 18.34473929383401, 8947050.5298450328 },
+    { "global", -31.646555950843151, 169.97843921167896, -30.862413074470112, 99.541557297706163, 6582625.8164091874 },
+    { "global", 53.631533120057554, -112.08417803275185, 3.034964073344355, -65.474793830921399, 7029320.1371998824 },
+    { "global", -4.6859826354164937, 121.84755640371122, 15.780757926094765, 35.071250726434528, 9813582.9553600829 },
+    { "global", -16.955334151924632, 118.7527577526331, -39.729886212615909, -64.035324571975096, 13722405.54378414 },
+    { "polar", -85.452862685473093, -2.8340120074958861, -86.472143915191921, 3.8487209145944519, 125199.43275286595 },
+    { "polar", 87.411572413033582, 168.0082176881113, 85.045325152443084, 166.9117864357882, 264394.31040073565 },
+    { "polar", -85.310527272779282, -31.691923954116476, -87.857571502557391, -19.248739388472814, 294636.29224270367 },
+    { "polar", -85.560459578657117, -30.495983537600949, -85.843538794914721, -36.953661408593888, 62572.269607368311 },
+    { "polar", 89.777062110019969, -63.869407652638515, 86.709989248740214, -71.88147217343473, 342830.10729887977 },
+    { "polar", -86.274187959408337, 46.187114397653176, -87.95844890529122, 22.077786115985191, 227884.05209003674 },
+    { "polar", -87.689377099378603, -83.650524365531808, -85.075212724923745, -56.957807388462925, 339813.75468879624 },
+    { "polar", -87.352135066165474, -84.584987303078748, -85.035493200169981, -65.149217513830109, 292598.11247608619 },
+    { "polar", 87.467208719471756, 82.248227773775511, 87.301982058876249, 68.113418206488291, 74156.357671574006 },
+    { "polar", -87.753393550708296, -56.24921133749362, -89.293278949168482, -65.691316329375894, 173547.66587859869 },
+    { "polar", 85.484278334452469, 100.05255538371489, 89.010759500427724, 126.78538847831948, 408713.44082254783 },
+    { "polar", 85.382629308192207, -93.692880934528404, 88.108326776490259, -72.83465584609641, 327031.75869801029 },
+    { "polar", 88.552924875312556, -28.059795639700383, 89.744758184437885, -31.549667750578323, 133184.43184189728 },
+    { "polar", 89.331974089617859, 71.372673702397776, 88.369303677638214, 50.392385914984857, 115599.2172966401 },
+    { "polar", -89.352912149374305, 99.551087212431526, -85.075907103546697, 71.49157401165948, 487381.69779705722 },
+    { "polar", 88.401490326009835, 4.4086109920147294, 89.776011054571583, -10.586430412461766, 154512.75306547238 },
+    { "antimeridian", 4.8083808714559808, 179.97957424696102, 4.7796057475650526, -179.97539177646433, 5923.0564827030676 },
+    { "antimeridian", 33.172243090579158, 179.98906698526673, 33.190903941371459, -179.98032600103878, 3525.7998380012873 },
+    { "antimeridian", -35.872646293113512, 179.9745920035723, -35.921462221061113, -179.99127119975509, 6231.8744177862909 },
+    { "antimeridian", 58.172477896917471, 179.9862753023647, 58.217629882134901, -179.97635059593205, 5488.4284873012912 },
+    { "antimeridian", -13.350408412866685, 179.96356485881097, -13.320076955883696, -179.95318179270311, 9623.4543794070614 },
+    { "antimeridian", 56.277721118500367, 179.99176231556368, 56.302431320902507, -179.99528123039417, 2866.0034005061189 },
+    { "antimeridian", 54.295059749626702, 179.99308158876707, 54.308788516307935, -179.99385479217648, 1748.8636136104103 },
+    { "antimeridian", -31.807538965313267, 179.99181991812577, -31.843879178439497, -179.95686943339084, 6311.4171097837525 },
+    { "antimeridian", 42.995632992405135, 179.96864607142547, 43.043196433321569, -179.97580094964218, 6958.9442084327684 },
+    { "antimeridian", 32.962115620389127, 179.96076937812703, 32.970094645660517, -179.96207291304114, 7267.4668331145267 },
+    { "antimeridian", -53.137552256436585, 179.96289475898251, -53.174454519591031, -179.98058780015967, 5582.1088719035397 },
+    { "antimeridian", -10.011782194666651, 179.96315062193676, -10.036302202298522, -179.96226601540889, 8614.7238186124905 },
+    { "antimeridian", -44.261995417422497, 179.97916120051846, -44.263042914206835, -179.97682881406342, 3516.1990759543378 },
+    { "antimeridian", -48.777633748784709, 179.9500889384756, -48.73809666226348, -179.9878727467584, 6335.4330140246475 },
+    { "antimeridian", 27.451508332075989, 179.97147978080864, 27.435223929738189, -179.98002694549984, 5122.5254198360808 },
+    { "antimeridian", -1.1916457973764807, 179.95988737099637, -1.1523810981246017, -179.960459254037, 9871.2084137665061 },
+    { "zone_edge", 1.4635405126375218, 53.953456929976184, 1.4902963305333321, 54.040244021787998, 10100.892645369631 },
+    { "zone_edge", -32.827355957945919, -48.001552487250457, -32.821807701359809, -47.977957886763278, 2293.4270040436049 },
+    { "zone_edge", -21.348026623477253, 77.958707806715239, -21.372350747074361, 78.022549195056001, 7148.3167823527428 },
+    { "zone_edge", 21.552131017618379, 149.9593293446504, 21.592061997820412, 150.04635641648849, 10039.324490030582 },
+    { "zone_edge", 9.2873514109554378, 83.957691735982124, 9.2915899570132634, 84.049568869878954, 10105.343598560888 },
+    { "zone_edge", -30.270540824949876, -78.018214885948609, -30.229459068161201, -77.986442459241289, 5485.5544137346051 },
+    { "zone_edge", 42.33165460755832, -144.02853696503232, 42.317465572886483, -143.97641757448017, 4576.1081529768007 },
+    { "zone_edge", -45.572357094414471, 77.993910465795707, -45.556061055810858, 78.018595562443465, 2644.6716860918045 },
+    { "zone_edge", -24.388782323811178, -150.03512453038704, -24.423296152023909, -149.99188611405737, 5817.9576036061944 },
+    { "zone_edge", -59.497792653474292, 137.99644974372183, -59.50215295877959, 138.01830586280903, 1329.8206564712011 },
+    { "zone_edge", 55.760462184284719, 47.954994748097747, 55.780801762587544, 48.020051100979231, 4668.9994684055264 },
+    { "zone_edge", 4.373080943715749, 143.98097346278576, 4.3589557056396986, 144.02808847570401, 5457.980087259939 },
+    { "zone_edge", 40.636392002511585, 173.97312111360151, 40.662763882936993, 174.01923729087014, 4877.4892513426539 },
+    { "zone_edge", 59.091204234405595, 29.981449175815094, 59.085719509025132, 30.032723966279008, 3002.2970682099917 },
+    { "zone_edge", 59.107868006232536, 167.95127553472929, 59.063102148557007, 168.01372702127708, 6139.0484146783137 },
+    { "zone_edge", 22.502355745123211, -168.04584330988467, 22.531251210678445, -167.96321850262382, 9083.0391565178325 },
+    { "near_antipodal", -37.468441786546201, -131.61544890577301, 37.529659662654446, 48.560311355647798, 19994688.662909873 },
+    { "near_antipodal", 39.009071178115377, -113.96728022038808, -38.513572063126773, 66.493217191457234, 19940781.227468587 },
+    { "near_antipodal", 19.351979988033207, 122.18394215394972, -19.672290301523443, -58.093457723464439, 19964057.386601578 },
+    { "near_antipodal", 36.811885633014015, -170.91828100931531, -37.288722683930011, 8.7917995138917604, 19947575.513547868 },
+    { "near_antipodal", 56.353555742368826, -104.75252133136955, -56.101315599879534, 75.177700996846227, 19975654.324346162 },
+    { "near_antipodal", -22.004624469133269, 102.7992747348988, 22.35914403793937, -76.83104219867522, 19957291.47688121 },
+    { "near_antipodal", -29.032751315384651, 89.523936332005178, 29.53135229541623, -90.673661044799587, 19946941.337084088 },
+    { "near_antipodal", -49.052541699983848, -6.0498386501704147, 49.36842182304261, 174.37907252559069, 19961405.433637287 },
+    { "near_antipodal", -4.1098824556112206, 45.32297488728949, 4.5136862379936664, -134.41973995158281, 19955641.892892618 },
+    { "near_antipodal", -46.292065800917968, -48.987639322620623, 46.284165344670683, 131.21406212012562, 19999403.964062136 },
+    { "near_antipodal", 32.966401571779244, -149.99320105408196, -32.798593539990584, 29.931151225759123, 19984942.084639706 },
+    { "near_antipodal", 27.844462030349575, -101.84511960200365, -27.763172174534127, 78.274999284633395, 19993787.704990666 },
+    { "near_antipodal", 47.032357942888481, 84.481460445590415, -46.886421861060242, -95.893765027859502, 19979417.647486798 },
+    { "near_antipodal", 5.2441141748894751, 10.267174677381661, -4.9165138661339087, -169.4363579534886, 19962497.83599785 },
+    { "near_antipodal", 8.2253987701635225, 100.07814687905403, -7.7675207266372723, -79.959817184192616, 19953216.897215553 },
+    { "near_antipodal", -56.406601549961586, -114.345289247213, 56.512634823877164, 65.826271465960218, 19990415.02893718 },
+};
+
+static const ReferenceUTM s_refUTM[] = {
+    { "mid_latitude", -14.832049503522448, 43.448076510901359, 333009.25803448021, 8359670.9056574032, 38, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", 29.361861023928014, -66.446195694338712, 747912.00827053073, 3250787.9821307007, 19, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", -15.182675127708983, -68.984615448294463, 501652.54172264319, 8321469.1063483879, 19, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -18.617676380462179, 114.01312879472636, 184806.68624075316, 7938850.4061951395, 50, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -48.685639314765297, 34.380351984967632, 601595.03988864331, 4606569.9702061499, 36, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", 21.005601204291779, 79.000904690238883, 292212.60895966645, 2324067.2965139216, 44, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", 5.644837183659277, 100.42160787984841, 657443.30893811514, 624136.49858532764, 47, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", -54.412805023195844, 53.727075400158469, 676963.78484218486, 3967121.920191756, 39, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", 40.02985744668014, 15.291616480839366, 524881.46892441681, 4431111.8381027654, 33, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", -11.520958462439971, 84.929629895675134, 274185.73606456799, 8725601.8244427349, 45, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -44.668945634478689, 130.54764692975493, 622678.81630793167, 5052659.533646225, 52, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -7.468569447977174, 93.146301942759351, 516142.56102923059, 9174449.201806711, 46, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -46.457602040916179, 152.19817988450336, 438427.12138211908, 4854795.4295529705, 56, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", 54.562941030209203, 72.875441075874079, 362632.11179574736, 6048233.139947922, 43, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", 5.6227777637576253, 43.762167516297154, 362908.03183358104, 621650.99395245616, 38, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", -31.98629405397908, 122.18211987938361, 422734.20116334374, 6460791.3692255709, 51, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -58.527736664672965, 168.16940592811159, 335185.06182841596, 3509059.4520269404, 59, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", -13.280192091002426, 164.59571458922034, 456208.11589006853, 8531843.0626817308, 58, UTM_HEMISPHERE_SOUTHERN },
+    { "mid_latitude", 30.096818106211046, -40.957333731886564, 311384.83772876771, 3331129.6350794584, 24, UTM_HEMISPHERE_NORTHERN },
+    { "mid_latitude", 2.4823088999461618, 131.88779513462146, 821176.19471716671, 274722.21997289953, 52, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", -79.845436414800631, 78.72982161540159, 455328.90492186259, 1134794.5209574103, 44, UTM_HEMISPHERE_SOUTHERN },
+    { "high_latitude", 75.518273642159286, 179.76911991998168, 577271.97829911287, 8383242.2016888764, 60, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 78.275788965499586, -106.39729661080679, 468306.46567412734, 8689526.5021465942, 13, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 80.01056895788038, 17.979572773740898, 557676.33220979862, 8884242.7723812982, 33, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 80.665352024033112, 32.193738667499588, 485400.69684778753, 8955952.0865202695, 36, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 83.628337250572329, -135.03675534139228, 499544.59997005708, 9286602.9607935343, 8, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", -72.006617489351299, 125.48177391980897, 585545.4040835998, 2008566.9496685804, 51, UTM_HEMISPHERE_SOUTHERN },
+    { "high_latitude", -72.641729715516405, -49.666664742714573, 544396.9098652181, 1938992.4941707682, 22, UTM_HEMISPHERE_SOUTHERN },
+    { "high_latitude", -77.336935171018084, 121.11156831710792, 453794.81640703179, 1414884.0109749178, 51, UTM_HEMISPHERE_SOUTHERN },
+    { "high_latitude", 74.838462649752728, 72.992539415093887, 441404.19347143517, 8306574.5048988359, 43, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 81.456872414541238, 127.48234837860633, 474833.02099077107, 9044531.4792912062, 52, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 73.525524266401931, 13.269406746525988, 445227.05866490316, 8159898.3609462241, 33, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 75.178495918456832, -131.49833211980706, 428680.88218016265, 8345025.8625725312, 9, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", 80.545366829418143, 1.7050297315918215, 476253.99005261023, 8942722.7836924642, 31, UTM_HEMISPHERE_NORTHERN },
+    { "high_latitude", -73.225109291339592, -53.563861491877333, 417429.93399164866, 1872639.1865383091, 22, UTM_HEMISPHERE_SOUTHERN },
+    { "high_latitude", 74.756205237755765, 110.19778007383832, 476456.51144845912, 8296565.0379745392, 49, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -25.026872683955602, 156.00548274254191, 197800.94033526318, 7228733.8255096637, 57, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", -19.780135466118033, -36.002676255979537, 814079.95381785498, 7810066.6809256049, 24, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", 63.463574775076637, 47.999972103971153, 649500.56784220471, 7040743.7351564365, 38, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -74.846623870908545, 162.00163246397182, 412545.60075657995, 1691296.5068039293, 58, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", -49.493003966161538, 95.992489226793708, 716694.48120471451, 4513432.5726711294, 46, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", 56.283167497833915, -114.00812223439125, 685197.95114631345, 6241619.568211996, 11, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -71.177207287449306, -132.0025840583499, 607898.42032406759, 2100167.0135609773, 8, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", 63.834503994507173, 131.99523088307376, 647328.0974465966, 7082030.0778156621, 52, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -2.8652463413847613, -42.004768240521997, 833032.40507335623, 9682866.1047741938, 23, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", 0.44496869030716368, -53.994558438466512, 166637.79221250347, 49250.121618540754, 22, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", 11.773702368671181, 29.992636004861005, 826181.74890419608, 1303269.6219462852, 35, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", 31.123736917949543, -42.007777944447241, 785346.97885369055, 3447168.7375596049, 23, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", 29.666447871683999, 149.99867729928826, 790245.83976040944, 3285587.4653328191, 55, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -9.4962405168710973, 138.00457625579139, 171079.33283270869, 8948864.6160042789, 54, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", 12.821640486699735, 162.00790936780047, 175169.45489171028, 1419295.225133159, 58, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", 26.993670913428844, 23.993803684649482, 797127.47655033635, 2989259.7721180688, 34, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", 4.194263284497012, -144.00545943641356, 832481.71055174037, 464236.32379553007, 6, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -69.691180174722774, -113.99122959267611, 384173.11775922519, 2265728.7206460615, 12, UTM_HEMISPHERE_SOUTHERN },
+    { "zone_edge", 3.6884372226147946, -71.999415348279271, 166774.90537951852, 408250.27812185435, 19, UTM_HEMISPHERE_NORTHERN },
+    { "zone_edge", -49.244954302169923, -102.00287223372794, 718125.84494682797, 4540989.7750283303, 13, UTM_HEMISPHERE_SOUTHERN },
+    { "antimeridian", 5.4996732848499192, 179.99394092314455, 831776.52740457573, 608729.20282112795, 60, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", -33.246952798743557, 179.99958461106579, 779476.78652876592, 6317322.2740174914, 60, UTM_HEMISPHERE_SOUTHERN },
+    { "antimeridian", -20.808054819713917, 179.99121468817916, 811375.5654297251, 7696206.0454657888, 60, UTM_HEMISPHERE_SOUTHERN },
+    { "antimeridian", 33.195490084513366, 179.99410027472484, 779129.1995311348, 3676954.5529233208, 60, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", 8.8080151354909191, -179.99380772453432, 170623.15429951961, 974945.54865344439, 1, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", 24.635034584946666, -179.99265714257419, 197035.3876509945, 2727836.7362387432, 1, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", 11.151209550027687, 179.99530256875477, 827189.29127945111, 1234353.9687730731, 60, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", -47.675388777856313, 179.99385850484046, 724716.32515338855, 4715435.3578770431, 60, UTM_HEMISPHERE_SOUTHERN },
+    { "antimeridian", 50.28596899380625, 179.99304674065718, 713210.13454224286, 5574712.4394015875, 60, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", 46.774816357773545, 179.99735840904449, 728825.18016378244, 5184504.0361928409, 60, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", 50.721627699273355, -179.99277537433832, 288763.04943563434, 5623141.8173351511, 1, UTM_HEMISPHERE_NORTHERN },
+    { "antimeridian", 10.242644998181504, -179.99908114173681, 171419.42456000316, 1133770.5696235874, 1, UTM_HEMISPHERE_NORTHERN },
+    { "equator", -2.2829060317681527e-07, 95.333437821826124, 759725.49908535276, 9999999.9747459479, 46, UTM_HEMISPHERE_SOUTHERN },
+    { "equator", 0, -121.19439872644062, 700951.70317654358, 0, 10, UTM_HEMISPHERE_NORTHERN },
+    { "equator", -8.4726236369549809e-07, -44.862521949495402, 515297.87976089882, 9999999.9063517805, 23, UTM_HEMISPHERE_SOUTHERN },
+    { "equator", -9.8865793823555123e-08, 145.00241437085265, 277673.38401681941, 9999999.9890656695, 55, UTM_HEMISPHERE_SOUTHERN },
+    { "equator", 0, -82.887862928524129, 289889.8445275902, 0, 17, UTM_HEMISPHERE_NORTHERN },
+    { "equator", 3.2698984266004619e-07, 112.47458736581103, 664102.89362315298, 0.03615425604362256, 49, UTM_HEMISPHERE_NORTHERN },
+    { "equator", 0, -127.71593718053438, 642896.08564908244, 0, 9, UTM_HEMISPHERE_NORTHERN },
+    { "equator", 0, 40.561961679945227, 673828.90572156874, 0, 37, UTM_HEMISPHERE_NORTHERN },
+};
+
+static const ReferenceLocal s_refLocal[] = {
+    { 37.5, 127, 37.499187486328388, 127.00236089553712, 208.76549842745769, -90.175860145478424 },
+    { 37.5, 127, 37.566128685239271, 127.0999319180642, 8828.7211078970613, 7344.153399654032 },
+    { 37.5, 127, 37.696740747832571, 127.08100121907837, 7143.7316515059001, 21839.068509096833 },
+    { 37.5, 127, 37.30243150541893, 126.84747256565541, -13522.745143171049, -21916.17354547869 },
+    { 37.5, 127, 37.479347357017211, 127.02784617430443, 2462.9882421124048, -2291.8072263446797 },
+    { 37.5, 127, 37.580717117111199, 127.32760185587007, 28936.970765462251, 9008.973141893659 },
+    { 37.5, 127, 37.499072018281311, 127.00240349067822, 212.53236076514017, -102.99121929835675 },
+    { 37.5, 127, 37.525587450155498, 126.92237835167228, -6861.383836731, 2842.7107088099078 },
+    { 37.5, 127, 37.495660295029573, 126.96919731276427, -2723.8987930197154, -481.20508493151675 },
+    { 37.5, 127, 37.446128013640411, 126.90411848543702, -8484.4488743545317, -5974.742236517166 },
+    { -33.899999999999999, 151.19999999999999, -33.59872105853006, 151.49316329722228, 27210.397903348097, 33378.237356690901 },
+    { -33.899999999999999, 151.19999999999999, -33.992394831326116, 151.40751507438372, 19172.902181153953, -10267.926117380299 },
+    { -33.899999999999999, 151.19999999999999, -33.935566211892798, 151.28017478023563, 7412.5153587552013, -3947.928633375398 },
+    { -33.899999999999999, 151.19999999999999, -33.781446198331096, 151.0852729873107, -10626.090653272217, 13143.986849468463 },
+    { -33.899999999999999, 151.19999999999999, -33.947614787647126, 151.18475764084968, -1409.0258922517521, -5281.5842883146597 },
+    { -33.899999999999999, 151.19999999999999, -33.997421684842699, 151.174059895233, -2396.543350713087, -10806.452894429329 },
+    { -33.899999999999999, 151.19999999999999, -33.881029262336902, 151.68244493237867, 44632.084592685729, 1999.4372924123181 },
+    { -33.899999999999999, 151.19999999999999, -33.787899539018092, 151.25924590170013, 5486.9851178973731, 12432.544820330701 },
+    { -33.899999999999999, 151.19999999999999, -33.864922830857587, 151.4024136538689, 18729.450279152075, 3872.3164341935849 },
+    { -33.899999999999999, 151.19999999999999, -34.071280251328481, 151.09376602491471, -9806.192162844658, -19003.811943182838 },
+    { 64.099999999999994, -21.899999999999999, 64.297507815610558, -22.443059133539489, -26289.540047720555, 22130.284234640112 },
+    { 64.099999999999994, -21.899999999999999, 64.012176893712677, -21.966869236039884, -3270.6034515056422, -9788.6421292831255 },
+    { 64.099999999999994, -21.899999999999999, 64.119039640401795, -21.480847313137517, 20422.389490019301, 2189.7188617360148 },
+    { 64.099999999999994, -21.899999999999999, 64.079461740840017, -21.835129941764372, 3165.186983507469, -2287.9671906427457 },
+    { 64.099999999999994, -21.899999999999999, 64.153477542068302, -22.357307670208499, -22253.8056728593, 6041.5280507664856 },
+    { 64.099999999999994, -21.899999999999999, 63.917540350166604, -21.340510790822247, 27456.994787309599, -20219.51373070907 },
+    { 64.099999999999994, -21.899999999999999, 64.271409073564698, -21.900040992806929, -1.9863705584854736, 19108.69114908046 },
+    { 64.099999999999994, -21.899999999999999, 63.984762691589054, -21.567860336069874, 16260.930829028473, -12804.018089062998 },
+    { 64.099999999999994, -21.899999999999999, 63.998634539061904, -21.581849495910273, 15568.338007442771, -11261.141430098753 },
+    { 64.099999999999994, -21.899999999999999, 64.136929500958786, -21.739325581524966, 7823.5721038827178, 4126.7379922776918 },
+    { 0, 179.94999999999999, -0.042325328394737599, -179.9600545790064, 10012.671637961521, -4680.0921190519484 },
+    { 0, 179.94999999999999, 0.12610357762982216, 179.95992639950899, 1104.9990747944551, 13943.800743572367 },
+    { 0, 179.94999999999999, -0.26526203966142647, -179.85086715849846, 22167.085911252972, -29331.055261856742 },
+    { 0, 179.94999999999999, -0.00725299550757387, -179.98284449356501, 7475.715009143536, -801.99472368832267 },
+    { 0, 179.94999999999999, -0.028527257666148872, -179.81676418657065, 25963.617082325829, -3154.3807298998545 },
+    { 0, 179.94999999999999, -0.20403980802755511, -179.9741750292545, 8440.7415046412807, -22561.507281904891 },
+    { 0, 179.94999999999999, 0.0083808660023176815, -179.80927065099718, 26797.789422537528, 926.70818572582482 },
+    { 0, 179.94999999999999, -0.091409289192422666, 179.92796741432346, -2452.6530574726421, -10107.511754189181 },
+    { 0, 179.94999999999999, 0.0092397975218378829, 179.60352886880381, -38568.754343154542, 1021.6839153759412 },
+    { 0, 179.94999999999999, -0.027967276759114784, 179.95339454724657, 377.87922602678606, -3092.4612540047297 },
+    { -79, 0, -78.943552192517146, -0.15208348806245955, -3257.2550258606984, 6298.3040738799727 },
+    { -79, 0, -79.004108835498855, -0.27339005072214401, -5823.6622059591873, -472.40210945069782 },
+    { -79, 0, -79.01799566024286, 0.083934585472944565, 1785.722498612716, -2010.5524482394821 },
+    { -79, 0, -78.972798773134372, 0.33552733249284156, 7167.3706951647027, 3016.4917889673516 },
+    { -79, 0, -79.155747247811803, -0.12800582802896437, -2689.6039831576541, -17392.646047720147 },
+    { -79, 0, -78.980683999607194, 0.059009666832417255, 1259.6525972682753, 2156.0489516080661 },
+    { -79, 0, -78.90837372548981, -0.40250720223450592, -8647.7343259779427, 10200.484695574985 },
+    { -79, 0, -78.996509941425273, 0.81494628756455467, 17371.035822797952, 268.40432962902167 },
+    { -79, 0, -78.978201114663364, -0.1519069558773922, -3243.4071065348567, 2429.6859741252533 },
+    { -79, 0, -78.953794919136698, -0.21369293557233165, -4572.5867218171379, 5150.5516026013147 },
+};
+
+static const GEOCoordinates s_refStatisticsPosition = { 37.399999999999999, 127.09999999999999 };
+
+static const GEOCoordinates s_refStatisticsMeasures[] = {
+    { 37.399928145465623, 127.10007420075847 },
+    { 37.400018494534422, 127.10002657173585 },
+    { 37.399996541336478, 127.10005600229807 },
+    { 37.400017787118095, 127.09997691496538 },
+    { 37.400019322795714, 127.10002991618654 },
+    { 37.400029593946002, 127.10005375346043 },
+    { 37.399981661273252, 127.09999879262695 },
+    { 37.400007778085978, 127.10005445574487 },
+    { 37.400001935840933, 127.10001985060401 },
+    { 37.399999176520637, 127.10003061368153 },
+    { 37.399958534591264, 127.09999712485752 },
+    { 37.399973680960549, 127.100011661743 },
+    { 37.400022729644846, 127.09993957363396 },
+    { 37.399977406246826, 127.10003599391702 },
+    { 37.399984647406875, 127.10006359784914 },
+    { 37.399985704409872, 127.09998665972746 },
+    { 37.400022236450887, 127.10003775102638 },
+    { 37.400056384662214, 127.09999175801568 },
+    { 37.399962005153725, 127.10002337123505 },
+    { 37.400017583005059, 127.10001136880602 },
+    { 37.399959862935525, 127.09994169964882 },
+    { 37.400038564237057, 127.09996466034144 },
+    { 37.400058257234107, 127.09994624172548 },
+    { 37.399977419087236, 127.09993840959488 },
+    { 37.399982977789556, 127.10001081201725 },
+    { 37.400011569236845, 127.10015208324396 },
+    { 37.399956834940646, 127.09993622160847 },
+    { 37.400015619339023, 127.09994726042613 },
+    { 37.399948769148182, 127.10010025837622 },
+    { 37.400016785165285, 127.10003084665267 },
+    { 37.399974945516135, 127.10002075788356 },
+    { 37.400013886133337, 127.09993053879163 },
+    { 37.399963360784021, 127.09992727742787 },
+    { 37.400009483848663, 127.09997625074428 },
+    { 37.400001505126333, 127.10002241803384 },
+    { 37.400030722413149, 127.09999654104317 },
+    { 37.400008365507666, 127.10000552343389 },
+    { 37.399995960720794, 127.09998194398536 },
+    { 37.39998169702298, 127.10003563817972 },
+    { 37.399979900320417, 127.10002897902602 },
+    { 37.39998322947153, 127.09999449619357 },
+    { 37.399996377103129, 127.09998241409137 },
+    { 37.399977999958764, 127.09998899000971 },
+    { 37.400037914915501, 127.09998856451318 },
+    { 37.400012551338236, 127.10004517530604 },
+    { 37.400008474678849, 127.10000505866709 },
+    { 37.399937253377722, 127.09996307319042 },
+    { 37.39994082713261, 127.0999403757079 },
+    { 37.399988693773338, 127.09993341629871 },
+    { 37.399977272032615, 127.10003970431804 },
+    { 37.400014758104966, 127.10000765338303 },
+    { 37.400017049604124, 127.09999642237585 },
+    { 37.399993638834715, 127.09996807100852 },
+    { 37.400005521076686, 127.09998204736614 },
+    { 37.399992204096819, 127.10008370963686 },
+    { 37.399961590196739, 127.09996649086051 },
+    { 37.399986026763798, 127.09998954601784 },
+    { 37.399989367444192, 127.09999894331736 },
+    { 37.399989821131257, 127.09992962221956 },
+    { 37.400025397597233, 127.09998724954542 },
+    { 37.399999886668887, 127.09995007921384 },
+    { 37.399990039351259, 127.10004900919459 },
+    { 37.400040719619568, 127.10011502971378 },
+    { 37.400062066339721, 127.1000588137603 },
+};
+
+static const ReferenceStatistics s_refStatistics[] = {
+    { STATS_PROJECTION_UTM, 4.3380057144052664, 5.2902618587631061, 10.580523717526212, 9.0230518859629534 },
+    { STATS_PROJECTION_LOCAL, 4.3395008263160122, 5.2905349424561017, 10.581069884912203, 9.0261617187373062 },
+};
@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 LG Electronics, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate loc_geometry_reference.h, the reference values of loc_geometry_benchmark.
+
+Geodesic distances are from GeographicLib (Karney's algorithm, accurate to 15 nm).
+UTM, local tangent plane offsets and error statistics are evaluated in 40 digit
+arithmetic with mpmath: UTM by the Krueger series, whose truncation at sixth order
+in n is below a nanometer inside the zone, the others by their exact formulas.
+
+    pip install geographiclib mpmath
+    ./make_geometry_reference.py > loc_geometry_reference.h
+"""
+
+import random
+
+import mpmath
+from geographiclib.geodesic import Geodesic
+
+mpmath.mp.dps = 40
+
+A = mpmath.mpf(6378137)
+F = 1 / mpmath.mpf('298.257223563')
+E2 = F * (2 - F)
+K0 = mpmath.mpf('0.9996')
+
+
+def fmt(x):
+    return '%.17g' % float(x)
+
+
+def distance_cases(rng):
+    cases = []
+
+    def add(category, count, make):
+        for _ in range(count):
+            lat1, lon1, lat2, lon2 = make()
+            lon2 = (lon2 + 180) % 360 - 180
+            s12 = Geodesic.WGS84.Inverse(lat1, lon1, lat2, lon2)['s12']
+            cases.append((category, lat1, lon1, lat2, lon2, s12))
+
+    def near(span, lat_min, lat_max):
+        def make():
+            lat1 = rng.uniform(lat_min, lat_max)
+            lon1 = rng.uniform(-180, 180)
+            return lat1, lon1, lat1 + rng.uniform(-span, span) / 2, lon1 + rng.uniform(-span, span)
+        return make
+
+    def polar():
+        sign = rng.choice((-1, 1))
+        lat1 = sign * rng.uniform(85, 89.99)
+        lat2 = sign * rng.uniform(85, 89.99)
+        lon1 = rng.uniform(-180, 180)
+        return lat1, lon1, lat2, lon1 + rng.uniform(-30, 30)
+
+    def antimeridian():
+        lat1 = rng.uniform(-60, 60)
+        return lat1, 180 - rng.uniform(0, 0.05), lat1 + rng.uniform(-0.05, 0.05), -180 + rng.uniform(0, 0.05)
+
+    def zone_edge():
+        lat1 = rng.uniform(-60, 60)
+        edge = -180 + 6 * rng.randrange(1, 60)
+        return lat1, edge - rng.uniform(0, 0.05), lat1 + rng.uniform(-0.05, 0.05), edge + rng.uniform(0, 0.05)
+
+    def global_pair():
+        return rng.uniform(-85, 85), rng.uniform(-180, 180), rng.uniform(-85, 85), rng.uniform(-180, 180)
+
+    def near_antipodal():
+        lat1 = rng.uniform(-60, 60)
+        lon1 = rng.uniform(-180, 180)
+        return lat1, lon1, -lat1 + rng.uniform(-0.5, 0.5), lon1 + 180 + rng.uniform(-0.5, 0.5)
+
+    add('local', 20, near(0.1, -85, 85))
+    add('regional', 20, near(1.0, -85, 85))
+    add('global', 20, global_pair)
+    add('polar', 16, polar)
+    add('antimeridian', 16, antimeridian)
+    add('zone_edge', 16, zone_edge)
+    add('near_antipodal', 16, near_antipodal)
+
+    return cases
+
+
+def utm_forward(lat, lon):
+    zone = int(mpmath.floor((mpmath.mpf(lon) + 180) / 6)) + 1
+    cm = mpmath.radians(-183 + zone * 6)
+    phi = mpmath.radians(lat)
+    lam = mpmath.radians(lon) - cm
+    n = F / (2 - F)
+    e = mpmath.sqrt(E2)
+    alpha = [
+        n / 2 - n**2 * 2 / 3 + n**3 * 5 / 16 + n**4 * 41 / 180 - n**5 * 127 / 288 + n**6 * 7891 / 37800,
+        n**2 * 13 / 48 - n**3 * 3 / 5 + n**4 * 557 / 1440 + n**5 * 281 / 630 - n**6 * 1983433 / 1935360,
+        n**3 * 61 / 240 - n**4 * 103 / 140 + n**5 * 15061 / 26880 + n**6 * 167603 / 181440,
+        n**4 * 49561 / 161280 - n**5 * 179 / 168 + n**6 * 6601661 / 7257600,
+        n**5 * 34729 / 80640 - n**6 * 3418889 / 1995840,
+        n**6 * 212378941 / 319334400,
+    ]
+    rect = A / (1 + n) * (1 + n**2 / 4 + n**4 / 64 + n**6 / 256)
+
+    tau = mpmath.sinh(mpmath.atanh(mpmath.sin(phi)) - e * mpmath.atanh(e * mpmath.sin(phi)))
+    xi0 = mpmath.atan2(tau, mpmath.cos(lam))
+    eta0 = mpmath.asinh(mpmath.sin(lam) / mpmath.sqrt(tau**2 + mpmath.cos(lam)**2))
+    xi, eta = xi0, eta0
+    for j, a in enumerate(alpha, 1):
+        xi += a * mpmath.sin(2 * j * xi0) * mpmath.cosh(2 * j * eta0)
+        eta += a * mpmath.cos(2 * j * xi0) * mpmath.sinh(2 * j * eta0)
+
+    easting = K0 * rect * eta + 500000
+    northing = K0 * rect * xi
+    if northing < 0:
+        northing += 10000000
+
+    return easting, northing, zone, 'UTM_HEMISPHERE_SOUTHERN' if lat < 0 else 'UTM_HEMISPHERE_NORTHERN'
+
+
+def utm_cases(rng):
+    cases = []
+
+    def add(category, count, make):
+        for _ in range(count):
+            lat, lon = make()
+            cases.append((category, lat, lon) + utm_forward(lat, lon))
+
+    def zone_edge():
+        edge = -180 + 6 * rng.randrange(1, 60)
+        return rng.uniform(-80, 84), edge + rng.choice((-1, 1)) * rng.uniform(1e-6, 0.01)
+
+    add('mid_latitude', 20, lambda: (rng.uniform(-60, 60), rng.uniform(-179.99, 179.99)))
+    add('high_latitude', 16, lambda: (rng.choice((rng.uniform(72, 84), rng.uniform(-80, -72))),
+                                      rng.uniform(-179.99, 179.99)))
+    add('zone_edge', 20, zone_edge)
+    add('antimeridian', 12, lambda: (rng.uniform(-60, 60),
+                                     rng.choice((rng.uniform(179.99, 179.999999), rng.uniform(-180, -179.99)))))
+    add('equator', 8, lambda: (rng.choice((0.0, rng.uniform(-1e-6, 1e-6))), rng.uniform(-179.99, 179.99)))
+
+    return cases
+
+
+def ecef(lat, lon):
+    phi = mpmath.radians(lat)
+    lam = mpmath.radians(lon)
+    N = A / mpmath.sqrt(1 - E2 * mpmath.sin(phi)**2)
+    return (N * mpmath.cos(phi) * mpmath.cos(lam), N * mpmath.cos(phi) * mpmath.sin(lam),
+            N * (1 - E2) * mpmath.sin(phi))
+
+
+def enu(origin, lat, lon):
+    x0, y0, z0 = ecef(*origin)
+    x, y, z = ecef(lat, lon)
+    phi0 = mpmath.radians(origin[0])
+    lam0 = mpmath.radians(origin[1])
+    dx, dy, dz = x - x0, y - y0, z - z0
+    east = -mpmath.sin(lam0) * dx + mpmath.cos(lam0) * dy
+    north = (-mpmath.sin(phi0) * mpmath.cos(lam0) * dx - mpmath.sin(phi0) * mpmath.sin(lam0) * dy +
+             mpmath.cos(phi0) * dz)
+    return east, north
+
+
+def local_cases(rng):
+    cases = []
+    origins = [(37.5, 127.0), (-33.9, 151.2), (64.1, -21.9), (0.0, 179.95), (-79.0, 0.0)]
+
+    for origin in origins:
+        for _ in range(10):
+            r = 50000 * rng.random()
+            lat = origin[0] + rng.uniform(-1, 1) * r / 111000
+            lon = origin[1] + rng.uniform(-1, 1) * r / (111000 * mpmath.cos(mpmath.radians(origin[0])))
+            lon = float((lon + 180) % 360 - 180)
+            cases.append((origin, lat, lon) + enu(origin, lat, lon))
+
+    return cases
+
+
+def statistics_cases(rng):
+    ref = (37.4, 127.1)
+    measures = [(ref[0] + rng.gauss(0, 3e-5), ref[1] + rng.gauss(0, 4e-5)) for _ in range(64)]
+    result = {}
+
+    for projection in ('STATS_PROJECTION_UTM', 'STATS_PROJECTION_LOCAL'):
+        if projection == 'STATS_PROJECTION_UTM':
+            e0, n0 = utm_forward(*ref)[:2]
+            offsets = [(e - e0, n - n0) for e, n in (utm_forward(*m)[:2] for m in measures)]
+        else:
+            offsets = [enu(ref, *m) for m in measures]
+
+        sigma_east = mpmath.sqrt(sum(e * e for e, _ in offsets) / len(offsets))
+        sigma_north = mpmath.sqrt(sum(n * n for _, n in offsets) / len(offsets))
+        cep = mpmath.mpf('0.56') * sigma_east + mpmath.mpf('0.62') * sigma_north
+        drms = mpmath.sqrt(sigma_east**2 + sigma_north**2)
+        result[projection] = (cep, drms, 2 * drms, mpmath.mpf('2.08') * cep)
+
+    return ref, measures, result
+
+
+def main():
+    rng = random.Random(20210301)
+
+    print('// Generated by make_geometry_reference.py, do not edit')
+    print()
+    print('typedef struct {')
+    print('    const char *category;')
+    print('    double lat1, lon1, lat2, lon2;')
+    print('    double distance;')
+    print('} ReferenceDistance;')
+    print()
+    print('typedef struct {')
+    print('    const char *category;')
+    print('    double latitude, longitude;')
+    print('    double easting, northing;')
+    print('    unsigned int grid_zone;')
+    print('    UTM_HEMISPHERE hemisphere;')
+    print('} ReferenceUTM;')
+    print()
+    print('typedef struct {')
+    print('    double origin_latitude, origin_longitude;')
+    print('    double latitude, longitude;')
+    print('    double east, north;')
+    print('} ReferenceLocal;')
+    print()
+    print('typedef struct {')
+    print('    STATS_PROJECTION projection;')
+    print('    double cep, drms, twice_drms, r95;')
+    print('} ReferenceStatistics;')
+    print()
+
+    print('static const ReferenceDistance s_refDistances[] = {')
+    for c in distance_cases(rng):
+        print('    { "%s", %s },' % (c[0], ', '.join(fmt(x) for x in c[1:])))
+    print('};')
+    print()
+
+    print('static const ReferenceUTM s_refUTM[] = {')
+    for c in utm_cases(rng):
+        print('    { "%s", %s, %d, %s },' % (c[0], ', '.join(fmt(x) for x in c[1:5]), c[5], c[6]))
+    print('};')
+    print()
+
+    print('static const ReferenceLocal s_refLocal[] = {')
+    for c in local_cases(rng):
+        print('    { %s },' % ', '.join(fmt(x) for x in c[0] + c[1:]))
+    print('};')
+    print()
+
+    ref, measures, stats = statistics_cases(rng)
+    print('static const GEOCoordinates s_refStatisticsPosition = { %s };' % ', '.join(fmt(x) for x in ref))
+    print()
+    print('static const GEOCoordinates s_refStatisticsMeasures[] = {')
+    for m in measures:
+        print('    { %s },' % ', '.join(fmt(x) for x in m))
+    print('};')
+    print()
+    print('static const ReferenceStatistics s_refStatistics[] = {')
+    for projection, values in stats.items():
+        print('    { %s, %s },' % (projection, ', '.join(fmt(x) for x in values)))
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
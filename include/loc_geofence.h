@@ -0,0 +1,109 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LOC_GEOFENCE_H_
+#define _LOC_GEOFENCE_H_
+
+#include <loc_geometry.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    GEOFENCE_TRANSITION_ENTER,
+    GEOFENCE_TRANSITION_EXIT,
+    GEOFENCE_TRANSITION_DWELL
+} GEOFENCE_TRANSITION;
+
+typedef struct {
+    int fence_id;
+    int entity_id;
+    GEOFENCE_TRANSITION transition;
+    long long timestamp;
+} GeofenceEvent;
+
+typedef void (*GeofenceCallback)(const GeofenceEvent *event, void *user_data);
+
+typedef struct _GeofenceEngine      GeofenceEngine;
+
+
+
+/*
+ * Geofence Engine
+ * Fences are indexed in a grid of cell_size degrees, and coarser grids of cells twice as large
+ * each, a fence in the finest one where its bounding box spans at most 16 cells. A position is
+ * tested only against the fences of its cells whose bounding box contains it, then exactly:
+ * circles by the geodesic distance, polygons by their edges as straight lines in degrees.
+ * Circles may cross the antimeridian, polygons may not.
+ */
+
+// Create Geofence Engine with a given grid cell size in degrees (0 for default 0.01, about 1 km)
+GeofenceEngine* loc_geofence_create(double cell_size);
+
+// Destroy Geofence Engine
+void loc_geofence_destroy(GeofenceEngine **engine_ref);
+
+// Add circular fence, returns fence id or -1 on failure
+int loc_geofence_add_circle(GeofenceEngine **engine_ref, GEOCoordinates *center, double radius);
+
+// Add polygonal fence of size vertices (at least 3), returns fence id or -1 on failure
+// An edge over more than 180 degrees of longitude is taken to cross the antimeridian, and refused.
+int loc_geofence_add_polygon(GeofenceEngine **engine_ref, GEOCoordinates *vertices, int size);
+
+// Remove fence, tracked entities inside it leave without an exit event
+void loc_geofence_remove(GeofenceEngine **engine_ref, int fence_id);
+
+// Get the number of fences
+int loc_geofence_get_count(GeofenceEngine **engine_ref);
+
+// Find the fences containing a given position
+// Up to max_ids fence ids are stored into fence_ids in ascending order, returns the number of fences found.
+int loc_geofence_query(GeofenceEngine **engine_ref, GEOCoordinates *position, int *fence_ids, int max_ids);
+
+
+
+
+
+/*
+ * Transition Tracking
+ * Each entity remembers the fences it is in, so that updates report only the changes.
+ */
+
+// Set callback which will be called for each transition
+// It is called during the update, and may query but not update the engine.
+void loc_geofence_set_callback(GeofenceEngine **engine_ref, GeofenceCallback callback, void *user_data);
+
+// Set time in milliseconds staying in a fence for a dwell event (0 for no dwell event)
+void loc_geofence_set_dwell_time(GeofenceEngine **engine_ref, long long dwell_time_ms);
+
+// Update an entity with its position at a given time in milliseconds
+void loc_geofence_update(GeofenceEngine **engine_ref, int entity_id, GEOCoordinates *position, long long timestamp_ms);
+
+// Update entity_ids[i] with positions[i] at timestamps_ms[i] for each of size fixes, in order
+void loc_geofence_update_batch(GeofenceEngine **engine_ref, const int *entity_ids, GEOCoordinates *positions,
+                               const long long *timestamps_ms, int size);
+
+// Forget an entity without exit events
+void loc_geofence_remove_entity(GeofenceEngine **engine_ref, int entity_id);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _LOC_GEOFENCE_H_
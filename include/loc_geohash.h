@@ -0,0 +1,93 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LOC_GEOHASH_H_
+#define _LOC_GEOHASH_H_
+
+#include <stdint.h>
+#include <loc_geometry.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest geohash, in characters of 5 bits
+#define LOC_GEOHASH_MAX_PRECISION   12
+
+// Neighbour directions, in the order neighbours are stored
+typedef enum {
+    GEOHASH_NORTH = 0,
+    GEOHASH_NORTH_EAST,
+    GEOHASH_EAST,
+    GEOHASH_SOUTH_EAST,
+    GEOHASH_SOUTH,
+    GEOHASH_SOUTH_WEST,
+    GEOHASH_WEST,
+    GEOHASH_NORTH_WEST
+} GEOHASH_DIRECTION;
+
+
+
+/*
+ * Geohash Cells
+ * Cells of precision characters (1 to LOC_GEOHASH_MAX_PRECISION) as the integer of their
+ * 5 * precision bits, longitude and latitude bits interleaved from the longitude, compatible
+ * with geohash strings. The cell of a position has the cell of its position at a lower
+ * precision as prefix, so that cells sort along a Z-order curve and nest in their parents.
+ * Precision 7 cells are about 150 m, precision 9 cells about 5 m across.
+ */
+
+// Encode position into the cell of precision characters containing it, 0 for invalid precision
+uint64_t loc_geohash_encode(GEOCoordinates position, int precision);
+
+// Encode size positions into the cells of precision characters containing them
+void loc_geohash_encode_batch(const GEOCoordinates *positions, uint64_t *cells, int size, int precision);
+
+// Decode the center of cell
+GEOCoordinates loc_geohash_decode(uint64_t cell, int precision);
+
+// Decode the south west and north east corners of cell
+void loc_geohash_decode_bounds(uint64_t cell, int precision, GEOCoordinates *south_west, GEOCoordinates *north_east);
+
+// Get the neighbour of cell in direction, across the antimeridian
+// Returns 1 if stored in neighbour, 0 if there is none (beyond a pole)
+int loc_geohash_neighbor(uint64_t cell, int precision, GEOHASH_DIRECTION direction, uint64_t *neighbor);
+
+// Get the neighbours of cell in the order of GEOHASH_DIRECTION, those beyond a pole skipped
+// Returns the number stored in neighbors, 8 except in the rows of cells at the poles
+int loc_geohash_neighbors(uint64_t cell, int precision, uint64_t *neighbors);
+
+// Get the cell of precision - 1 characters containing cell
+// Returns 1 if stored in parent, 0 if there is none (precision 1)
+int loc_geohash_parent(uint64_t cell, int precision, uint64_t *parent);
+
+// Get the 32 cells of precision + 1 characters inside cell, in order, returns the number stored
+int loc_geohash_children(uint64_t cell, int precision, uint64_t *children);
+
+// Format cell into buffer of at least precision + 1 characters, returns 1 on success, 0 otherwise
+int loc_geohash_to_string(uint64_t cell, int precision, char *buffer);
+
+// Parse geohash string into cell, and its precision if precision is not NULL
+// Returns 1 on success, 0 for an empty, too long or invalid string
+int loc_geohash_from_string(const char *geohash, uint64_t *cell, int *precision);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _LOC_GEOHASH_H_
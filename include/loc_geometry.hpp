@@ -0,0 +1,598 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LOC_GEOMETRY_HPP_
+#define _LOC_GEOMETRY_HPP_
+
+#include <cmath>
+#include <loc_geometry.h>
+
+/*
+ * Header only C++11 layer of loc_geometry
+ * The kernels are inline, so calls from C++ do not cross the shared library, and the ellipsoid is
+ * a template argument, so everything derived from it (the UTM series coefficients etc.) is a
+ * compile time constant. With WGS84 they evaluate the same operations in the same order as the
+ * C functions in exact precision, and return the same bits unless the compiler contracts them
+ * into fused multiply-adds differently (-ffp-contract=off on targets with FMA).
+ */
+
+namespace loc {
+namespace geometry {
+
+// pi, as in loc_geometry.c
+constexpr double pi() { return 3.1415926535897932384626433832795; }
+
+// Scale factor on the central meridian of UTM zones
+constexpr double utm_scale_factor() { return 0.9996; }
+
+
+
+/*
+ * Angles
+ * Degrees and radians as distinct types, converted as loc_geometry_degrees_to_radians and
+ * loc_geometry_radians_to_degrees do.
+ */
+
+class Radians;
+
+class Degrees {
+public:
+    constexpr explicit Degrees(double value) : value_(value) {}
+
+    constexpr double value() const { return value_; }
+
+    constexpr Radians radians() const;
+
+private:
+    double value_;
+};
+
+class Radians {
+public:
+    constexpr explicit Radians(double value) : value_(value) {}
+
+    constexpr double value() const { return value_; }
+
+    constexpr Degrees degrees() const;
+
+private:
+    double value_;
+};
+
+constexpr Radians Degrees::radians() const { return Radians(value_ / 180 * pi()); }
+
+constexpr Degrees Radians::degrees() const { return Degrees(value_ * 180 / pi()); }
+
+// Geographic position, converted from and to GEOCoordinates
+struct Position {
+    Degrees latitude;
+    Degrees longitude;
+
+    constexpr Position(Degrees lat, Degrees lon) : latitude(lat), longitude(lon) {}
+
+    constexpr Position(const GEOCoordinates &coordinates)
+        : latitude(coordinates.latitude), longitude(coordinates.longitude) {}
+
+    GEOCoordinates c() const
+    {
+        GEOCoordinates coordinates = { latitude.value(), longitude.value() };
+        return coordinates;
+    }
+};
+
+
+
+/*
+ * Ellipsoids
+ * A model of the earth is a type with the equatorial radius, semi minor axis, flattening and
+ * first eccentricity as static constexpr functions. The eccentricity is given rather than
+ * derived, as sqrt is not a constant expression in C++11.
+ */
+
+struct WGS84 {
+    static constexpr double equatorial_radius() { return 6378137; }
+    static constexpr double semi_minor_axis() { return 6356752.314245; }
+    static constexpr double flattening() { return 1 / 298.257223563; }
+    static constexpr double eccentricity() { return 0.0818191908426214957; }
+};
+
+// Square of the first eccentricity
+template <typename E>
+constexpr double sq_eccentricity() { return E::flattening() * (2 - E::flattening()); }
+
+// Coefficients of the Krueger series to sixth order in the third flattening n
+template <typename E>
+struct Krueger {
+    static constexpr double n() { return E::flattening() / (2 - E::flattening()); }
+    static constexpr double n2() { return n() * n(); }
+    static constexpr double n3() { return n2() * n(); }
+    static constexpr double n4() { return n3() * n(); }
+    static constexpr double n5() { return n4() * n(); }
+    static constexpr double n6() { return n5() * n(); }
+
+    // Radius of the sphere with the circumference of the meridian
+    static constexpr double rectifying_radius()
+    {
+        return E::equatorial_radius() / (1 + n()) * (1 + n2() / 4 + n4() / 64 + n6() / 256);
+    }
+
+    // From geographic to transverse Mercator, j from 0
+    static constexpr double alpha(int j)
+    {
+        return j == 0 ? n() / 2 - n2() * 2 / 3 + n3() * 5 / 16 + n4() * 41 / 180 - n5() * 127 / 288 + n6() * 7891 / 37800 :
+               j == 1 ? n2() * 13 / 48 - n3() * 3 / 5 + n4() * 557 / 1440 + n5() * 281 / 630 - n6() * 1983433 / 1935360 :
+               j == 2 ? n3() * 61 / 240 - n4() * 103 / 140 + n5() * 15061 / 26880 + n6() * 167603 / 181440 :
+               j == 3 ? n4() * 49561 / 161280 - n5() * 179 / 168 + n6() * 6601661 / 7257600 :
+               j == 4 ? n5() * 34729 / 80640 - n6() * 3418889 / 1995840 :
+               n6() * 212378941 / 319334400;
+    }
+
+    // and back
+    static constexpr double beta(int j)
+    {
+        return j == 0 ? n() / 2 - n2() * 2 / 3 + n3() * 37 / 96 - n4() / 360 - n5() * 81 / 512 + n6() * 96199 / 604800 :
+               j == 1 ? n2() / 48 + n3() / 15 - n4() * 437 / 1440 + n5() * 46 / 105 - n6() * 1118711 / 3870720 :
+               j == 2 ? n3() * 17 / 480 - n4() * 37 / 840 - n5() * 209 / 4480 + n6() * 5569 / 90720 :
+               j == 3 ? n4() * 4397 / 161280 - n5() * 11 / 504 - n6() * 830251 / 7257600 :
+               j == 4 ? n5() * 4583 / 161280 - n6() * 108847 / 3991680 :
+               n6() * 20648693 / 638668800;
+    }
+
+    // from conformal to geographic latitude
+    static constexpr double delta(int j)
+    {
+        return j == 0 ? n() * 2 - n2() * 2 / 3 - n3() * 2 + n4() * 116 / 45 + n5() * 26 / 45 - n6() * 2854 / 675 :
+               j == 1 ? n2() * 7 / 3 - n3() * 8 / 5 - n4() * 227 / 45 + n5() * 2704 / 315 + n6() * 2323 / 945 :
+               j == 2 ? n3() * 56 / 15 - n4() * 136 / 35 - n5() * 1262 / 105 + n6() * 73814 / 2835 :
+               j == 3 ? n4() * 4279 / 630 - n5() * 332 / 35 - n6() * 399572 / 14175 :
+               j == 4 ? n5() * 4174 / 315 - n6() * 144838 / 6237 :
+               n6() * 601676 / 22275;
+    }
+};
+
+namespace detail {
+
+// Coefficients of one of the series, as an array for Clenshaw's recurrence
+struct Series {
+    double coef[6];
+};
+
+template <typename E>
+inline Series alpha_series()
+{
+    typedef Krueger<E> K;
+    Series series = { { K::alpha(0), K::alpha(1), K::alpha(2), K::alpha(3), K::alpha(4), K::alpha(5) } };
+    return series;
+}
+
+template <typename E>
+inline Series beta_series()
+{
+    typedef Krueger<E> K;
+    Series series = { { K::beta(0), K::beta(1), K::beta(2), K::beta(3), K::beta(4), K::beta(5) } };
+    return series;
+}
+
+template <typename E>
+inline Series delta_series()
+{
+    typedef Krueger<E> K;
+    Series series = { { K::delta(0), K::delta(1), K::delta(2), K::delta(3), K::delta(4), K::delta(5) } };
+    return series;
+}
+
+// Sum of coef[j] * sin(2 * (j + 1) * (xi + i eta)), as utm_series()
+inline void utm_series(const Series &series, double xi, double eta, double *sum_xi, double *sum_eta)
+{
+    double exp_2eta = std::exp(2.0 * eta);
+    double sin_2xi = std::sin(2.0 * xi), cos_2xi = std::cos(2.0 * xi);
+    double sinh_2eta = (exp_2eta - 1.0 / exp_2eta) / 2.0, cosh_2eta = (exp_2eta + 1.0 / exp_2eta) / 2.0;
+    double ar = 2.0 * cos_2xi * cosh_2eta;
+    double ai = -2.0 * sin_2xi * sinh_2eta;
+    double y0r = 0, y0i = 0, y1r = 0, y1i = 0, tr, ti;
+    int j;
+
+    for (j = 5; j >= 0; j--) {
+        tr = ar * y0r - ai * y0i - y1r + series.coef[j];
+        ti = ar * y0i + ai * y0r - y1i;
+        y1r = y0r;
+        y1i = y0i;
+        y0r = tr;
+        y0i = ti;
+    }
+
+    *sum_xi = y0r * sin_2xi * cosh_2eta - y0i * cos_2xi * sinh_2eta;
+    *sum_eta = y0r * cos_2xi * sinh_2eta + y0i * sin_2xi * cosh_2eta;
+}
+
+// Longitude difference reached by the geodesic leaving reduced latitude 1 with azimuth alpha1, as geodesic_lambda()
+template <typename E>
+inline double geodesic_lambda(double sin_b1, double cos_b1, double sin_b2, double cos_b2, double alpha1,
+                              double *sigma, double *sq_cos_alpha, double *cos_2sigma)
+{
+    const double f = E::flattening();
+    double sin_alpha1 = std::sin(alpha1), cos_alpha1 = std::cos(alpha1);
+    double sin_alpha0, cos_alpha2, t, n;
+    double sin_sigma1, cos_sigma1, sin_sigma2, cos_sigma2;
+    double sin_omega1, cos_omega1, sin_omega2, cos_omega2, omega;
+    double sin_sigma, cos_sigma, C;
+
+    sin_alpha0 = sin_alpha1 * cos_b1;
+    *sq_cos_alpha = 1.0 - sin_alpha0 * sin_alpha0;
+
+    t = cos_alpha1 * cos_alpha1 * cos_b1 * cos_b1 +
+        (cos_b1 < -sin_b1 ? (cos_b2 - cos_b1) * (cos_b2 + cos_b1) : (sin_b1 - sin_b2) * (sin_b1 + sin_b2));
+    cos_alpha2 = (cos_b2 != cos_b1 || std::fabs(sin_b2) != -sin_b1) ? std::sqrt(t > 0 ? t : 0) / cos_b2 :
+                 std::fabs(cos_alpha1);
+
+    sin_sigma1 = sin_b1;
+    cos_sigma1 = cos_alpha1 * cos_b1;
+    n = std::hypot(sin_sigma1, cos_sigma1);
+    sin_sigma1 /= n;
+    cos_sigma1 /= n;
+    sin_omega1 = sin_alpha0 * sin_b1;
+    cos_omega1 = cos_alpha1 * cos_b1;
+
+    sin_sigma2 = sin_b2;
+    cos_sigma2 = cos_alpha2 * cos_b2;
+    n = std::hypot(sin_sigma2, cos_sigma2);
+    sin_sigma2 /= n;
+    cos_sigma2 /= n;
+    sin_omega2 = sin_alpha0 * sin_b2;
+    cos_omega2 = cos_alpha2 * cos_b2;
+
+    sin_sigma = cos_sigma1 * sin_sigma2 - sin_sigma1 * cos_sigma2;
+    cos_sigma = cos_sigma1 * cos_sigma2 + sin_sigma1 * sin_sigma2;
+    *sigma = std::atan2(sin_sigma > 0 ? sin_sigma : 0, cos_sigma);
+    *cos_2sigma = cos_sigma1 * cos_sigma2 - sin_sigma1 * sin_sigma2;
+
+    omega = std::atan2(std::fmax(0, cos_omega1 * sin_omega2 - sin_omega1 * cos_omega2),
+                       cos_omega1 * cos_omega2 + sin_omega1 * sin_omega2);
+
+    C = f / 16.0 * (*sq_cos_alpha) * (4.0 + f * (4.0 - 3.0 * (*sq_cos_alpha)));
+
+    return omega - (1.0 - C) * f * sin_alpha0 *
+           (*sigma + C * std::sin(*sigma) * (*cos_2sigma + C * std::cos(*sigma) * (-1.0 + 2.0 * (*cos_2sigma) * (*cos_2sigma))));
+}
+
+// Distance of near-antipodal points by bisection on the starting azimuth, as distance_antipodal()
+template <typename E>
+inline double distance_antipodal(double sin_u1, double cos_u1, double sin_u2, double cos_u2, double delta_lon)
+{
+    const double a = E::equatorial_radius();
+    const double b = E::semi_minor_axis();
+    double target, low, high, alpha1, lambda, tmp;
+    double sigma = 0, sq_cos_alpha = 1, cos_2sigma = 0;
+    double sq_u, cal1, cal2, delta_sigma;
+    int iter_limit = 200;
+
+    // normalize: |u1| >= |u2|, u1 <= 0, longitude difference in [0, pi]
+    if (std::fabs(sin_u2) > std::fabs(sin_u1)) {
+        tmp = sin_u1; sin_u1 = sin_u2; sin_u2 = tmp;
+        tmp = cos_u1; cos_u1 = cos_u2; cos_u2 = tmp;
+    }
+
+    if (sin_u1 > 0) {
+        sin_u1 = -sin_u1;
+        sin_u2 = -sin_u2;
+    }
+
+    target = std::fmod(std::fabs(delta_lon), 2 * pi());
+    if (target > pi())
+        target = 2 * pi() - target;
+
+    low = 0;
+    high = pi();
+    do {
+        alpha1 = (low + high) / 2;
+        lambda = geodesic_lambda<E>(sin_u1, cos_u1, sin_u2, cos_u2, alpha1, &sigma, &sq_cos_alpha, &cos_2sigma);
+
+        if (lambda < target)
+            low = alpha1;
+        else
+            high = alpha1;
+    } while (std::fabs(lambda - target) > 1e-13 && high - low > 1e-15 && --iter_limit > 0);
+
+    sq_u = sq_cos_alpha * (a * a - b * b) / (b * b);
+    cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
+    cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
+    delta_sigma = cal2 * std::sin(sigma) * (cos_2sigma + cal2 / 4.0 * (std::cos(sigma) * (-1.0 + 2.0 * cos_2sigma * cos_2sigma) -
+                  cal2 / 6.0 * cos_2sigma * (-3.0 + 4.0 * std::sin(sigma) * std::sin(sigma)) * (-3.0 + 4.0 * cos_2sigma * cos_2sigma)));
+
+    return b * cal1 * (sigma - delta_sigma);
+}
+
+} // namespace detail
+
+
+
+/*
+ * Distance
+ */
+
+// Distance in meters between two positions, as loc_geometry_calc_distance (Vincenty, bisection near antipodal)
+template <typename E = WGS84>
+inline double distance(const Position &from, const Position &to)
+{
+    const double a = E::equatorial_radius();
+    const double b = E::semi_minor_axis();
+    const double f = E::flattening();
+    double lambdaP, iter_limit = 100.0;
+    double sin_sigma, sin_alpha, cos_sigma, sigma, sq_cos_alpha, cos_2sigma, C;
+    double sq_u, cal1, cal2, delta_sigma;
+    double sin_lambda, cos_lambda;
+
+    double delta_lon = ((to.longitude.value() - from.longitude.value()) * pi() / 180);
+    double u_1 = std::atan((1 - f) * std::tan((from.latitude.value()) * pi() / 180));
+    double u_2 = std::atan((1 - f) * std::tan((to.latitude.value()) * pi() / 180));
+
+    double lambda = delta_lon;
+    double sin_u1 = std::sin(u_1);
+    double cos_u1 = std::cos(u_1);
+    double sin_u2 = std::sin(u_2);
+    double cos_u2 = std::cos(u_2);
+
+    do {
+        sin_lambda = std::sin(lambda);
+        cos_lambda = std::cos(lambda);
+        sin_sigma = std::sqrt((cos_u2 * sin_lambda) * (cos_u2 * sin_lambda) +
+                              (cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda) *
+                              (cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda));
+
+        // co-incident points
+        if (sin_sigma == 0)
+            return 0;
+
+        cos_sigma = sin_u1 * sin_u2 + cos_u1 * cos_u2 * cos_lambda;
+        sigma = std::atan2(sin_sigma, cos_sigma);
+        sin_alpha = cos_u1 * cos_u2 * sin_lambda / sin_sigma;
+        sq_cos_alpha = 1.0 - sin_alpha * sin_alpha;
+        cos_2sigma = cos_sigma - 2.0 * sin_u1 * sin_u2 / sq_cos_alpha;
+
+        if (std::isnan(cos_2sigma))
+            cos_2sigma = 0;
+
+        C = f / 16.0 * sq_cos_alpha * (4.0 + f * (4.0 - 3.0 * sq_cos_alpha));
+        lambdaP = lambda;
+        lambda = delta_lon + (1.0 - C) * f * sin_alpha *
+                 (sigma + C * sin_sigma * (cos_2sigma + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma)));
+    } while (std::fabs(lambda - lambdaP) > 1e-12 && --iter_limit > 0);
+
+    // near-antipodal points, where the iteration does not converge
+    if (iter_limit == 0)
+        return detail::distance_antipodal<E>(sin_u1, cos_u1, sin_u2, cos_u2, delta_lon);
+
+    sq_u = sq_cos_alpha * (a * a - b * b) / (b * b);
+    cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
+    cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
+    delta_sigma = cal2 * sin_sigma * (cos_2sigma + cal2 / 4.0 * (cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma) -
+                  cal2 / 6.0 * cos_2sigma * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * cos_2sigma * cos_2sigma)));
+
+    return b * cal1 * (sigma - delta_sigma);
+}
+
+
+
+/*
+ * Conversion: Geographic Coordinates vs UTM Coordinates
+ * As loc_geometry_convert_wgs84_to_utm and loc_geometry_convert_utm_to_wgs84
+ */
+
+template <typename E = WGS84>
+inline UTMCoordinates to_utm(const Position &position)
+{
+    const detail::Series alpha = detail::alpha_series<E>();
+    UTMCoordinates utm;
+    unsigned int zone = std::floor((position.longitude.value() + 180.0) / 6) + 1;
+    double cmeridian = Degrees(-183.0 + (zone * 6.0)).radians().value();
+    double phi = position.latitude.radians().value();
+    double sin_phi, t, l, xi_p, eta_p, sum_xi, sum_eta, x, y;
+
+    sin_phi = std::sin(phi);
+    l = position.longitude.radians().value() - cmeridian;
+
+    // tangent of the conformal latitude
+    t = std::sinh(std::atanh(sin_phi) - E::eccentricity() * std::atanh(E::eccentricity() * sin_phi));
+
+    xi_p = std::atan2(t, std::cos(l));
+    eta_p = std::atanh(std::sin(l) / std::sqrt(1.0 + t * t));
+
+    detail::utm_series(alpha, xi_p, eta_p, &sum_xi, &sum_eta);
+
+    x = Krueger<E>::rectifying_radius() * (eta_p + sum_eta) * utm_scale_factor() + 500000.0;
+    y = Krueger<E>::rectifying_radius() * (xi_p + sum_xi) * utm_scale_factor();
+    if (y < 0.0)
+        y = y + 10000000.0;
+
+    utm.easting = x;
+    utm.northing = y;
+    utm.grid_zone = zone;
+    utm.hemisphere = (position.latitude.value() < 0) ? UTM_HEMISPHERE_SOUTHERN : UTM_HEMISPHERE_NORTHERN;
+
+    return utm;
+}
+
+template <typename E = WGS84>
+inline Position from_utm(const UTMCoordinates &utm)
+{
+    const detail::Series beta = detail::beta_series<E>();
+    const detail::Series delta = detail::delta_series<E>();
+    double cmeridian = Degrees(-183.0 + (utm.grid_zone * 6.0)).radians().value();
+    double x = (utm.easting - 500000.0) / utm_scale_factor();
+    double y = utm.northing;
+    double xi, eta, sum_xi, sum_eta, sinh_eta, chi, unused;
+
+    if (utm.hemisphere == UTM_HEMISPHERE_SOUTHERN)
+        y -= 10000000.0;
+    y /= utm_scale_factor();
+
+    xi = y / Krueger<E>::rectifying_radius();
+    eta = x / Krueger<E>::rectifying_radius();
+
+    detail::utm_series(beta, xi, eta, &sum_xi, &sum_eta);
+    xi -= sum_xi;
+    eta -= sum_eta;
+
+    // conformal latitude, then its series for the geographic latitude
+    sinh_eta = std::sinh(eta);
+    chi = std::asin(std::sin(xi) / std::sqrt(1.0 + sinh_eta * sinh_eta));
+    detail::utm_series(delta, chi, 0, &sum_xi, &unused);
+
+    return Position(Radians(chi + sum_xi).degrees(), Radians(cmeridian + std::atan2(sinh_eta, std::cos(xi))).degrees());
+}
+
+
+
+/*
+ * Conversion: Geographic Coordinates vs ECEF Coordinates
+ * As loc_geometry_convert_wgs84_to_ecef and loc_geometry_convert_ecef_to_wgs84 in exact precision
+ */
+
+template <typename E = WGS84>
+inline ECEFCoordinates to_ecef(const Position &position, double height = 0)
+{
+    double phi = position.latitude.radians().value();
+    double lambda = position.longitude.radians().value();
+    double sin_phi = std::sin(phi), cos_phi = std::cos(phi);
+    double N = E::equatorial_radius() / std::sqrt(1.0 - sq_eccentricity<E>() * sin_phi * sin_phi);
+    ECEFCoordinates ecef;
+
+    ecef.x = (N + height) * cos_phi * std::cos(lambda);
+    ecef.y = (N + height) * cos_phi * std::sin(lambda);
+    ecef.z = (N * (1.0 - sq_eccentricity<E>()) + height) * sin_phi;
+
+    return ecef;
+}
+
+// Two steps of Bowring's formula, within 1e-8 meters up to the orbits of navigation satellites
+template <typename E = WGS84>
+inline Position from_ecef(const ECEFCoordinates &ecef, double *height = 0)
+{
+    const double a = E::equatorial_radius();
+    const double b = E::semi_minor_axis();
+    const double e2 = sq_eccentricity<E>();
+    double p = std::sqrt(ecef.x * ecef.x + ecef.y * ecef.y);
+    double r, sin_beta = a * ecef.z, cos_beta = b * p, num = ecef.z, den = p, sin_phi, cos_phi, N;
+    int step;
+
+    for (step = 0; step < 2; step++) {
+        r = std::sqrt(sin_beta * sin_beta + cos_beta * cos_beta);
+        sin_beta /= r;
+        cos_beta /= r;
+
+        num = ecef.z + e2 / (1 - e2) * b * sin_beta * sin_beta * sin_beta;
+        den = p - e2 * a * cos_beta * cos_beta * cos_beta;
+
+        sin_beta = (1 - E::flattening()) * num;
+        cos_beta = den;
+    }
+
+    if (height) {
+        r = std::sqrt(num * num + den * den);
+        sin_phi = num / r;
+        cos_phi = den / r;
+        N = a / std::sqrt(1 - e2 * sin_phi * sin_phi);
+        *height = p * cos_phi + ecef.z * sin_phi - N * (1 - e2 * sin_phi * sin_phi);
+    }
+
+    return Position(Radians(std::atan2(num, den)).degrees(), Radians(std::atan2(ecef.y, ecef.x)).degrees());
+}
+
+
+
+/*
+ * Tangent Plane
+ * East, North (and Up) of an origin, as a Local Projection of loc_geometry
+ */
+
+template <typename E = WGS84>
+class TangentPlane {
+public:
+    explicit TangentPlane(const Position &origin)
+        : origin_(origin),
+          sin_lat_(std::sin(origin.latitude.radians().value())),
+          cos_lat_(std::cos(origin.latitude.radians().value())),
+          sin_lon_(std::sin(origin.longitude.radians().value())),
+          cos_lon_(std::cos(origin.longitude.radians().value()))
+    {
+        double N = E::equatorial_radius() / std::sqrt(1.0 - sq_eccentricity<E>() * sin_lat_ * sin_lat_);
+
+        ecef_x_ = N * cos_lat_;
+        ecef_z_ = N * (1.0 - sq_eccentricity<E>()) * sin_lat_;
+    }
+
+    const Position &origin() const { return origin_; }
+
+    // East and North of a position on the ellipsoid, as loc_geometry_local_project
+    void project(const Position &position, double *east, double *north) const
+    {
+        double phi = position.latitude.radians().value();
+        double dlambda = Degrees(position.longitude.value() - origin_.longitude.value()).radians().value();
+        double sin_phi = std::sin(phi), cos_phi = std::cos(phi);
+        double N, x, z;
+
+        N = E::equatorial_radius() / std::sqrt(1.0 - sq_eccentricity<E>() * sin_phi * sin_phi);
+        x = N * cos_phi * std::cos(dlambda) - ecef_x_;
+        z = N * (1.0 - sq_eccentricity<E>()) * sin_phi - ecef_z_;
+
+        *east = N * cos_phi * std::sin(dlambda);
+        *north = cos_lat_ * z - sin_lat_ * x;
+    }
+
+    // As loc_geometry_local_ecef_to_enu
+    ENUCoordinates ecef_to_enu(const ECEFCoordinates &ecef) const
+    {
+        ENUCoordinates enu;
+        double dx = ecef.x - ecef_x_ * cos_lon_;
+        double dy = ecef.y - ecef_x_ * sin_lon_;
+        double dz = ecef.z - ecef_z_;
+        double t = cos_lon_ * dx + sin_lon_ * dy;
+
+        enu.east = cos_lon_ * dy - sin_lon_ * dx;
+        enu.north = cos_lat_ * dz - sin_lat_ * t;
+        enu.up = cos_lat_ * t + sin_lat_ * dz;
+
+        return enu;
+    }
+
+    // As loc_geometry_local_enu_to_ecef
+    ECEFCoordinates enu_to_ecef(const ENUCoordinates &enu) const
+    {
+        ECEFCoordinates ecef;
+        double t = cos_lat_ * enu.up - sin_lat_ * enu.north;
+
+        ecef.x = ecef_x_ * cos_lon_ + cos_lon_ * t - sin_lon_ * enu.east;
+        ecef.y = ecef_x_ * sin_lon_ + sin_lon_ * t + cos_lon_ * enu.east;
+        ecef.z = ecef_z_ + sin_lat_ * enu.up + cos_lat_ * enu.north;
+
+        return ecef;
+    }
+
+private:
+    Position origin_;
+    double sin_lat_;
+    double cos_lat_;
+    double sin_lon_;
+    double cos_lon_;
+    // origin in earth centered coordinates, in the meridian plane of the origin
+    double ecef_x_;
+    double ecef_z_;
+};
+
+} // namespace geometry
+} // namespace loc
+
+#endif // _LOC_GEOMETRY_HPP_
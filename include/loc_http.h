@@ -26,6 +26,12 @@ extern "C" {
 
 #define HTTP_STATUS_CODE_SUCCESS    200
 
+typedef enum {
+    HTTP_CASSETTE_OFF,
+    HTTP_CASSETTE_RECORD,
+    HTTP_CASSETTE_REPLAY
+} HTTP_CASSETTE_MODE;
+
 typedef struct {
     CURL *handle;
     struct curl_slist *headerList;
@@ -42,6 +48,13 @@ typedef struct {
     char *responseData;
     void *message;
     void *recepient;
+    char *url;
+    gboolean spool;
+    long queueDelay;
+    gint64 queueTime;
+    gint64 startTime;
+    char *hedgeUrl;
+    long hedgeDelay;
 } HttpReqTask;
 
 typedef void (*ResponseCallback)(HttpReqTask *task, void *user_data);
@@ -76,6 +89,117 @@ void loc_http_remove_request(HttpReqTask *task);
 
 
 
+/*
+ * Offline Spool
+ * Requests of tasks marked for spooling are saved into the spool directory when they
+ * cannot be delivered (transport error), and are replayed later in batches.
+ * Replay starts on loc_http_spool_replay() and resumes by itself whenever
+ * any other request completes successfully.
+ */
+
+// start spooling into the given directory, keeping at most max_entries requests
+// (the oldest waiting request is dropped when the spool is full, and a new request is
+// refused if all of them are being replayed)
+gboolean loc_http_spool_start(const char *directory, int max_entries);
+
+// stop spooling, spooled requests are kept on disk for the next start
+void loc_http_spool_stop();
+
+// mark the task to be spooled when its request fails
+void loc_http_task_set_spool(HttpReqTask *task, gboolean spool);
+
+// defer the request of the task into the spool without sending it
+// returns TRUE once the request is durably on disk
+gboolean loc_http_spool_add(HttpReqTask *task);
+
+// replay spooled requests with at most batch_size requests in flight
+void loc_http_spool_replay(int batch_size);
+
+// get number of spooled requests
+int loc_http_spool_get_count();
+
+
+
+/*
+ * Rate Limit
+ * Requests to a host with a rate limit are shaped by a token bucket.
+ * Asynchronous requests over the quota wait in the queue until a token is available, in order.
+ * The time a request waited is reported in queueDelay (milliseconds) of its task.
+ * A synchronous request does not wait: over the quota, or with requests queued for the host,
+ * it fails with CURLE_AGAIN and the time until its token in queueDelay.
+ * Hosts are given as a host name, with or without port, or as any url to the host.
+ */
+
+// set rate limit of the given host in requests per second with the given burst size
+// passing 0 as rate removes the limit
+void loc_http_set_rate_limit(const char *host, double rate, int burst);
+
+// get the expected queueing delay (milliseconds) of a new request to the given host
+// this covers both the rate limit and the concurrency limit
+long loc_http_get_queue_delay(const char *host);
+
+
+
+/*
+ * Adaptive Concurrency
+ * The number of asynchronous requests in flight to a host is limited, and the limit
+ * follows the measured completion latency and error rate (AIMD):
+ * it grows while latency stays close to the lowest observed one,
+ * and shrinks on errors (transport, 429, 5xx) or when latency builds up.
+ * Requests over the limit wait in the queue like those over the rate limit.
+ * Hosts limited by the default only, or tracked for hedging only, are forgotten when idle,
+ * the least recently used first, so that the state of at most 64 of them is kept.
+ */
+
+// enable adaptive concurrency of the given host, between min_limit and max_limit requests in flight
+// passing NULL as host sets the default of all hosts, passing 0 as max_limit disables it
+void loc_http_set_adaptive_concurrency(const char *host, int min_limit, int max_limit);
+
+// get the current concurrency limit of the given host (0 if not limited)
+int loc_http_get_concurrency_limit(const char *host);
+
+
+
+/*
+ * Hedged Request
+ * If a hedged asynchronous request has no response after its hedge delay, a duplicate is sent
+ * to the alternate url. The first successful response is delivered for the task
+ * and the other request is cancelled.
+ * The duplicate waits for the rate and concurrency limits of the alternate host like any
+ * other request. Hedges are limited by the budget, a fraction of the requests sent,
+ * hedges themselves not included.
+ */
+
+// set hedging of the task with the alternate url and delay in milliseconds
+// passing 0 as delay_ms uses the 95th percentile latency observed for the host,
+// once 16 of its responses have been seen, passing NULL as alt_url disables hedging
+gboolean loc_http_task_set_hedge(HttpReqTask *task, const char *alt_url, long delay_ms);
+
+// set the fraction of requests that may be hedged (default 0.05)
+void loc_http_set_hedge_budget(double ratio);
+
+// get number of hedges sent (or queued for the alternate host) and of hedges that won over their primary request
+void loc_http_get_hedge_stats(int *sent, int *won);
+
+
+
+/*
+ * Cassette
+ * In record mode, every completed request is appended to the cassette file
+ * together with its response and latency.
+ * In replay mode, requests are answered from the cassette without network access,
+ * and responses are delivered through the response callback as usual.
+ * Identical requests (url and post data) get their recorded responses in order.
+ */
+
+// start recording into or replaying from the given cassette file
+// real_timing: in replay mode, deliver each response after its recorded latency
+gboolean loc_http_cassette_start(const char *path, HTTP_CASSETTE_MODE mode, gboolean real_timing);
+
+// stop recording or replaying
+void loc_http_cassette_stop();
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,72 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LOC_POINTINDEX_H_
+#define _LOC_POINTINDEX_H_
+
+#include <loc_geometry.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _PointIndex          PointIndex;
+
+
+
+/*
+ * Static Point Index
+ * k-d tree of points in earth centered coordinates, searched by straight line distance
+ * which never exceeds the distance on the ellipsoid. Results are ranked by the geodesic
+ * distance, and refer to points by their position in the array the index was built from.
+ */
+
+// Create Point Index of size points
+PointIndex* loc_pointindex_create(const GEOCoordinates *points, int size);
+
+// Load Point Index saved by loc_pointindex_save, mapped from the file without rebuilding
+// Returns NULL if the file is not a valid index of this build.
+PointIndex* loc_pointindex_load(const char *path);
+
+// Save Point Index to a file, returns 1 on success, 0 otherwise
+// It is written aside and renamed over path, so indexes loaded from the old file keep it.
+int loc_pointindex_save(PointIndex **index_ref, const char *path);
+
+// Destroy Point Index
+void loc_pointindex_destroy(PointIndex **index_ref);
+
+// Get the number of points
+int loc_pointindex_get_count(PointIndex **index_ref);
+
+// Get a point by its position in the array the index was built from
+GEOCoordinates loc_pointindex_get_point(PointIndex **index_ref, int point_index);
+
+// Find the k points nearest to position
+// Their indexes and distances in meters are stored nearest first, returns the number found (up to k)
+int loc_pointindex_knn(PointIndex **index_ref, GEOCoordinates *position, int k, int *indexes, double *distances);
+
+// Find the points within radius meters of position
+// Up to max_results of them are stored nearest first, returns the number of points within radius.
+int loc_pointindex_radius(PointIndex **index_ref, GEOCoordinates *position, double radius,
+                          int *indexes, double *distances, int max_results);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _LOC_POINTINDEX_H_
@@ -0,0 +1,814 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <loc_geofence.h>
+
+#define GEOFENCE_DEFAULT_CELL_SIZE  0.01
+#define GEOFENCE_MIN_CELL_SIZE      0.0001
+#define GEOFENCE_INITIAL_SLOTS      64
+
+// Levels of the grid, each of cells twice as large as the one below, and cells listing one fence at most
+#define GEOFENCE_MAX_LEVELS         24
+#define GEOFENCE_MAX_FENCE_CELLS    16
+
+// Smallest length of a degree of latitude and of longitude at the equator, in meters
+#define METERS_PER_DEGREE_LAT       110574.0
+#define METERS_PER_DEGREE_LON       111320.0
+
+
+typedef enum {
+    GEOFENCE_SHAPE_CIRCLE,
+    GEOFENCE_SHAPE_POLYGON
+} GEOFENCE_SHAPE;
+
+typedef struct {
+    GEOFENCE_SHAPE shape;
+    bool active;
+    GEOCoordinates center;
+    double radius;
+    GEOCoordinates *vertices;
+    int num_vertices;
+    double min_lat, max_lat;
+    double min_lon, max_lon;    // beyond -180 or 180 for a circle across the antimeridian
+    int level;
+} Geofence;
+
+// Growable array of ints, fence ids of a grid cell
+typedef struct {
+    int *data;
+    int count;
+    int capacity;
+} IdArray;
+
+typedef struct {
+    int fence_id;
+    long long enter_time;
+    bool dwelled;
+} GeofenceStay;
+
+typedef struct {
+    GeofenceStay *stays;
+    int count;
+    int capacity;
+} GeofenceEntity;
+
+// Open addressing hash table by linear probing, from a 64 bit key to a value
+typedef struct {
+    long long key;
+    void *value;
+} HashSlot;
+
+typedef struct {
+    HashSlot *slots;
+    int capacity;
+    int count;
+} HashTable;
+
+// A fence is listed in the cells of the finest level where its bounding box spans at most
+// GEOFENCE_MAX_FENCE_CELLS cells, so that large fences take a few coarse cells.
+// The tables of the levels are created with their first fence.
+struct _GeofenceEngine {
+    double cell_size;
+    Geofence *fences;
+    int num_fences;
+    int max_fences;
+    int count;
+    HashTable cells[GEOFENCE_MAX_LEVELS];
+    int level_fences[GEOFENCE_MAX_LEVELS];
+    HashTable entities;
+    GeofenceCallback callback;
+    void *user_data;
+    long long dwell_time;
+    IdArray found;
+    IdArray current;
+};
+
+
+static bool hash_init(HashTable *table);
+static unsigned int hash_index(HashTable *table, long long key);
+static void hash_clear(HashTable *table, void (*free_value)(void *));
+static void* hash_lookup(HashTable *table, long long key);
+static bool hash_insert(HashTable *table, long long key, void *value);
+static void* hash_remove(HashTable *table, long long key);
+static bool id_array_append(IdArray *array, int id);
+static void id_array_free(void *array);
+static void entity_free(void *entity);
+static long long cell_key(int row, int col);
+static int cell_row(GeofenceEngine *engine, int level, double latitude);
+static int cell_col(GeofenceEngine *engine, int level, double longitude);
+static int fence_cols(GeofenceEngine *engine, int level, Geofence *fence, int *first, int *last);
+static bool fence_spans_lon(Geofence *fence, double longitude);
+static int fence_level(GeofenceEngine *engine, Geofence *fence);
+static int add_fence(GeofenceEngine *engine, Geofence *fence);
+static void unlist_fence(GeofenceEngine *engine, Geofence *fence, int fence_id);
+static bool list_fence(HashTable *cells, long long key, int fence_id);
+static bool fence_contains(Geofence *fence, GEOCoordinates *position);
+static void find_fences(GeofenceEngine *engine, GEOCoordinates *position);
+static int compare_int(const void *a, const void *b);
+static void notify(GeofenceEngine *engine, int fence_id, int entity_id, GEOFENCE_TRANSITION transition,
+                   long long timestamp);
+
+
+
+GeofenceEngine* loc_geofence_create(double cell_size)
+{
+    GeofenceEngine *engine = NULL;
+
+    engine = (GeofenceEngine *)malloc(sizeof(GeofenceEngine));
+    if (!engine)
+        return NULL;
+
+    memset(engine, 0, sizeof(GeofenceEngine));
+    engine->cell_size = (cell_size > 0) ? fmax(cell_size, GEOFENCE_MIN_CELL_SIZE) : GEOFENCE_DEFAULT_CELL_SIZE;
+
+    if (!hash_init(&engine->entities)) {
+        loc_geofence_destroy(&engine);
+        return NULL;
+    }
+
+    return engine;
+}
+
+void loc_geofence_destroy(GeofenceEngine **engine_ref)
+{
+    GeofenceEngine *engine = *engine_ref;
+    int i;
+
+    if (!engine)
+        return;
+
+    for (i = 0; i < engine->num_fences; i++)
+        free(engine->fences[i].vertices);
+
+    for (i = 0; i < GEOFENCE_MAX_LEVELS; i++)
+        hash_clear(&engine->cells[i], id_array_free);
+    hash_clear(&engine->entities, entity_free);
+    free(engine->fences);
+    free(engine->found.data);
+    free(engine->current.data);
+    free(engine);
+    *engine_ref = NULL;
+}
+
+int loc_geofence_add_circle(GeofenceEngine **engine_ref, GEOCoordinates *center, double radius)
+{
+    GeofenceEngine *engine = *engine_ref;
+    Geofence fence;
+    double dlat, dlon, edge;
+
+    if (!engine || !center || radius <= 0 || fabs(center->latitude) > 90.0 || fabs(center->longitude) > 180.0)
+        return -1;
+
+    memset(&fence, 0, sizeof(Geofence));
+    fence.shape = GEOFENCE_SHAPE_CIRCLE;
+    fence.center = *center;
+    fence.radius = radius;
+
+    // bounding box with a margin, longitudes widened at the edge closer to the pole
+    dlat = radius / METERS_PER_DEGREE_LAT * 1.01;
+    edge = fabs(center->latitude) + dlat;
+
+    fence.min_lat = fmax(center->latitude - dlat, -90.0);
+    fence.max_lat = fmin(center->latitude + dlat, 90.0);
+
+    dlon = (edge < 89.0) ? radius / (METERS_PER_DEGREE_LON * cos(loc_geometry_degrees_to_radians(edge))) * 1.01
+                         : 180.0;
+
+    // kept across the antimeridian as it is, and split into two column ranges by fence_cols()
+    if (dlon >= 180.0) {
+        fence.min_lon = -180.0;
+        fence.max_lon = 180.0;
+    } else {
+        fence.min_lon = center->longitude - dlon;
+        fence.max_lon = center->longitude + dlon;
+    }
+
+    return add_fence(engine, &fence);
+}
+
+int loc_geofence_add_polygon(GeofenceEngine **engine_ref, GEOCoordinates *vertices, int size)
+{
+    GeofenceEngine *engine = *engine_ref;
+    Geofence fence;
+    int i, id;
+
+    if (!engine || !vertices || size < 3)
+        return -1;
+
+    // edges are straight lines in degrees, which cannot go across the antimeridian
+    for (i = 0; i < size; i++) {
+        if (fabs(vertices[i].latitude) > 90.0 || fabs(vertices[i].longitude) > 180.0 ||
+            fabs(vertices[i].longitude - vertices[(i + 1) % size].longitude) > 180.0)
+            return -1;
+    }
+
+    memset(&fence, 0, sizeof(Geofence));
+    fence.shape = GEOFENCE_SHAPE_POLYGON;
+    fence.num_vertices = size;
+    fence.vertices = (GEOCoordinates *)malloc(sizeof(GEOCoordinates) * size);
+    if (!fence.vertices)
+        return -1;
+
+    memcpy(fence.vertices, vertices, sizeof(GEOCoordinates) * size);
+
+    fence.min_lat = fence.max_lat = vertices[0].latitude;
+    fence.min_lon = fence.max_lon = vertices[0].longitude;
+    for (i = 1; i < size; i++) {
+        fence.min_lat = fmin(fence.min_lat, vertices[i].latitude);
+        fence.max_lat = fmax(fence.max_lat, vertices[i].latitude);
+        fence.min_lon = fmin(fence.min_lon, vertices[i].longitude);
+        fence.max_lon = fmax(fence.max_lon, vertices[i].longitude);
+    }
+
+    id = add_fence(engine, &fence);
+    if (id < 0)
+        free(fence.vertices);
+
+    return id;
+}
+
+void loc_geofence_remove(GeofenceEngine **engine_ref, int fence_id)
+{
+    GeofenceEngine *engine = *engine_ref;
+    Geofence *fence;
+
+    if (!engine || fence_id < 0 || fence_id >= engine->num_fences)
+        return;
+
+    fence = &engine->fences[fence_id];
+    if (!fence->active)
+        return;
+
+    unlist_fence(engine, fence, fence_id);
+
+    free(fence->vertices);
+    fence->vertices = NULL;
+    fence->active = false;
+    engine->level_fences[fence->level]--;
+    engine->count--;
+}
+
+int loc_geofence_get_count(GeofenceEngine **engine_ref)
+{
+    GeofenceEngine *engine = *engine_ref;
+
+    if (!engine)
+        return 0;
+
+    return engine->count;
+}
+
+int loc_geofence_query(GeofenceEngine **engine_ref, GEOCoordinates *position, int *fence_ids, int max_ids)
+{
+    GeofenceEngine *engine = *engine_ref;
+    int i;
+
+    if (!engine || !position)
+        return 0;
+
+    find_fences(engine, position);
+
+    for (i = 0; fence_ids && i < engine->found.count && i < max_ids; i++)
+        fence_ids[i] = engine->found.data[i];
+
+    return engine->found.count;
+}
+
+void loc_geofence_set_callback(GeofenceEngine **engine_ref, GeofenceCallback callback, void *user_data)
+{
+    GeofenceEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    engine->callback = callback;
+    engine->user_data = user_data;
+}
+
+void loc_geofence_set_dwell_time(GeofenceEngine **engine_ref, long long dwell_time_ms)
+{
+    GeofenceEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    engine->dwell_time = dwell_time_ms;
+}
+
+void loc_geofence_update(GeofenceEngine **engine_ref, int entity_id, GEOCoordinates *position, long long timestamp_ms)
+{
+    GeofenceEngine *engine = *engine_ref;
+    GeofenceEntity *entity;
+    GeofenceStay *stays;
+    int *found;
+    int i, j, num_found, count;
+
+    if (!engine || !position)
+        return;
+
+    entity = (GeofenceEntity *)hash_lookup(&engine->entities, entity_id);
+    if (!entity) {
+        entity = (GeofenceEntity *)calloc(1, sizeof(GeofenceEntity));
+        if (!entity || !hash_insert(&engine->entities, entity_id, entity)) {
+            free(entity);
+            return;
+        }
+    }
+
+    // copied, so that the callback may query the engine
+    find_fences(engine, position);
+    engine->current.count = 0;
+    for (i = 0; i < engine->found.count; i++) {
+        if (!id_array_append(&engine->current, engine->found.data[i]))
+            return;
+    }
+    found = engine->current.data;
+    num_found = engine->current.count;
+
+    if (num_found > entity->capacity) {
+        stays = (GeofenceStay *)realloc(entity->stays, sizeof(GeofenceStay) * num_found);
+        if (!stays)
+            return;
+
+        entity->stays = stays;
+        entity->capacity = num_found;
+    }
+
+    // both sorted by fence id: walk them together, compacting the stays in place
+    i = j = count = 0;
+    while (i < entity->count || j < num_found) {
+        if (j >= num_found || (i < entity->count && entity->stays[i].fence_id < found[j])) {
+            if (engine->fences[entity->stays[i].fence_id].active)
+                notify(engine, entity->stays[i].fence_id, entity_id, GEOFENCE_TRANSITION_EXIT, timestamp_ms);
+            i++;
+        } else if (i >= entity->count || found[j] < entity->stays[i].fence_id) {
+            // new stays are inserted behind the remaining old ones, sorted again below
+            notify(engine, found[j], entity_id, GEOFENCE_TRANSITION_ENTER, timestamp_ms);
+            j++;
+        } else {
+            entity->stays[count] = entity->stays[i];
+            if (engine->dwell_time > 0 && !entity->stays[count].dwelled &&
+                timestamp_ms - entity->stays[count].enter_time >= engine->dwell_time) {
+                entity->stays[count].dwelled = true;
+                notify(engine, found[j], entity_id, GEOFENCE_TRANSITION_DWELL, timestamp_ms);
+            }
+            count++;
+            i++;
+            j++;
+        }
+    }
+
+    // entered fences are those of found not kept in the first count stays
+    for (i = 0, j = 0; j < num_found; j++) {
+        while (i < count && entity->stays[i].fence_id < found[j])
+            i++;
+        if (i < count && entity->stays[i].fence_id == found[j])
+            continue;
+
+        memmove(&entity->stays[i + 1], &entity->stays[i], sizeof(GeofenceStay) * (count - i));
+        entity->stays[i].fence_id = found[j];
+        entity->stays[i].enter_time = timestamp_ms;
+        entity->stays[i].dwelled = false;
+        count++;
+    }
+
+    entity->count = count;
+}
+
+void loc_geofence_update_batch(GeofenceEngine **engine_ref, const int *entity_ids, GEOCoordinates *positions,
+                               const long long *timestamps_ms, int size)
+{
+    int i;
+
+    if (!entity_ids || !positions || !timestamps_ms)
+        return;
+
+    for (i = 0; i < size; i++)
+        loc_geofence_update(engine_ref, entity_ids[i], &positions[i], timestamps_ms[i]);
+}
+
+void loc_geofence_remove_entity(GeofenceEngine **engine_ref, int entity_id)
+{
+    GeofenceEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    entity_free(hash_remove(&engine->entities, entity_id));
+}
+
+static bool hash_init(HashTable *table)
+{
+    table->count = 0;
+    table->capacity = GEOFENCE_INITIAL_SLOTS;
+    table->slots = (HashSlot *)calloc(table->capacity, sizeof(HashSlot));
+
+    return table->slots != NULL;
+}
+
+static void hash_clear(HashTable *table, void (*free_value)(void *))
+{
+    int i;
+
+    if (!table->slots)
+        return;
+
+    for (i = 0; i < table->capacity; i++) {
+        if (table->slots[i].value)
+            free_value(table->slots[i].value);
+    }
+
+    free(table->slots);
+    table->slots = NULL;
+    table->capacity = table->count = 0;
+}
+
+static unsigned int hash_index(HashTable *table, long long key)
+{
+    unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+
+    return (unsigned int)(h >> 32) & (table->capacity - 1);
+}
+
+static void* hash_lookup(HashTable *table, long long key)
+{
+    unsigned int i = hash_index(table, key);
+
+    while (table->slots[i].value) {
+        if (table->slots[i].key == key)
+            return table->slots[i].value;
+        i = (i + 1) & (table->capacity - 1);
+    }
+
+    return NULL;
+}
+
+static bool hash_insert(HashTable *table, long long key, void *value)
+{
+    HashSlot *old_slots = table->slots;
+    int old_capacity = table->capacity;
+    unsigned int i;
+    int j;
+
+    // kept at most half full
+    if ((table->count + 1) * 2 > table->capacity) {
+        table->slots = (HashSlot *)calloc(old_capacity * 2, sizeof(HashSlot));
+        if (!table->slots) {
+            table->slots = old_slots;
+            return false;
+        }
+
+        table->capacity = old_capacity * 2;
+        for (j = 0; j < old_capacity; j++) {
+            if (!old_slots[j].value)
+                continue;
+
+            i = hash_index(table, old_slots[j].key);
+            while (table->slots[i].value)
+                i = (i + 1) & (table->capacity - 1);
+            table->slots[i] = old_slots[j];
+        }
+        free(old_slots);
+    }
+
+    i = hash_index(table, key);
+    while (table->slots[i].value)
+        i = (i + 1) & (table->capacity - 1);
+
+    table->slots[i].key = key;
+    table->slots[i].value = value;
+    table->count++;
+
+    return true;
+}
+
+static void* hash_remove(HashTable *table, long long key)
+{
+    unsigned int i = hash_index(table, key);
+    unsigned int j, home;
+    void *value;
+
+    while (table->slots[i].value && table->slots[i].key != key)
+        i = (i + 1) & (table->capacity - 1);
+
+    value = table->slots[i].value;
+    if (!value)
+        return NULL;
+
+    // shift back the following slots of the run that would not be found past the hole
+    j = i;
+    while (true) {
+        table->slots[i].value = NULL;
+        do {
+            j = (j + 1) & (table->capacity - 1);
+            if (!table->slots[j].value) {
+                table->count--;
+                return value;
+            }
+            home = hash_index(table, table->slots[j].key);
+        } while ((i <= j) ? (i < home && home <= j) : (i < home || home <= j));
+
+        table->slots[i] = table->slots[j];
+        i = j;
+    }
+}
+
+static bool id_array_append(IdArray *array, int id)
+{
+    int *data;
+
+    if (array->count == array->capacity) {
+        data = (int *)realloc(array->data, sizeof(int) * (array->capacity ? array->capacity * 2 : 4));
+        if (!data)
+            return false;
+
+        array->data = data;
+        array->capacity = array->capacity ? array->capacity * 2 : 4;
+    }
+
+    array->data[array->count++] = id;
+
+    return true;
+}
+
+static void id_array_free(void *array)
+{
+    if (!array)
+        return;
+
+    free(((IdArray *)array)->data);
+    free(array);
+}
+
+static void entity_free(void *entity)
+{
+    if (!entity)
+        return;
+
+    free(((GeofenceEntity *)entity)->stays);
+    free(entity);
+}
+
+static long long cell_key(int row, int col)
+{
+    return ((long long)row << 32) | (unsigned int)col;
+}
+
+static int cell_row(GeofenceEngine *engine, int level, double latitude)
+{
+    return (int)floor((latitude + 90.0) / ldexp(engine->cell_size, level));
+}
+
+static int cell_col(GeofenceEngine *engine, int level, double longitude)
+{
+    return (int)floor((longitude + 180.0) / ldexp(engine->cell_size, level));
+}
+
+// Column ranges of the bounding box of fence at level, two for a box across the antimeridian
+static int fence_cols(GeofenceEngine *engine, int level, Geofence *fence, int *first, int *last)
+{
+    double min_lon = fence->min_lon;
+    double max_lon = fence->max_lon;
+
+    if (max_lon <= 180.0 && min_lon >= -180.0) {
+        first[0] = cell_col(engine, level, min_lon);
+        last[0] = cell_col(engine, level, max_lon);
+        return 1;
+    }
+
+    if (max_lon > 180.0)
+        max_lon -= 360.0;
+    else
+        min_lon += 360.0;
+
+    first[0] = cell_col(engine, level, min_lon);
+    last[0] = cell_col(engine, level, 180.0);
+    first[1] = cell_col(engine, level, -180.0);
+    last[1] = cell_col(engine, level, max_lon);
+
+    // cells wide enough to hold both sides, listed once
+    if (first[0] <= last[1]) {
+        first[0] = first[1];
+        return 1;
+    }
+
+    return 2;
+}
+
+// Whether longitude is in the bounding box of fence, on either side of the antimeridian
+static bool fence_spans_lon(Geofence *fence, double longitude)
+{
+    if (longitude < fence->min_lon)
+        longitude += 360.0;
+    else if (longitude > fence->max_lon)
+        longitude -= 360.0;
+
+    return longitude >= fence->min_lon && longitude <= fence->max_lon;
+}
+
+// Finest level where the bounding box of fence spans at most GEOFENCE_MAX_FENCE_CELLS cells
+static int fence_level(GeofenceEngine *engine, Geofence *fence)
+{
+    double rows, cols;
+    int first[2], last[2];
+    int level, ranges, i;
+
+    for (level = 0; level < GEOFENCE_MAX_LEVELS - 1; level++) {
+        rows = (double)cell_row(engine, level, fence->max_lat) - cell_row(engine, level, fence->min_lat) + 1;
+        ranges = fence_cols(engine, level, fence, first, last);
+        for (cols = 0, i = 0; i < ranges; i++)
+            cols += (double)last[i] - first[i] + 1;
+
+        if (rows * cols <= GEOFENCE_MAX_FENCE_CELLS)
+            break;
+    }
+
+    return level;
+}
+
+static int add_fence(GeofenceEngine *engine, Geofence *fence)
+{
+    Geofence *fences;
+    HashTable *cells;
+    int first[2], last[2];
+    int id, level, ranges, row, col, i, max_fences;
+
+    if (engine->num_fences == engine->max_fences) {
+        max_fences = engine->max_fences ? engine->max_fences * 2 : 16;
+        fences = (Geofence *)realloc(engine->fences, sizeof(Geofence) * max_fences);
+        if (!fences)
+            return -1;
+
+        engine->fences = fences;
+        engine->max_fences = max_fences;
+    }
+
+    id = engine->num_fences;
+    level = fence->level = fence_level(engine, fence);
+    cells = &engine->cells[level];
+
+    if (!cells->slots && !hash_init(cells))
+        return -1;
+
+    ranges = fence_cols(engine, level, fence, first, last);
+    for (row = cell_row(engine, level, fence->min_lat); row <= cell_row(engine, level, fence->max_lat); row++) {
+        for (i = 0; i < ranges; i++) {
+            for (col = first[i]; col <= last[i]; col++) {
+                if (!list_fence(cells, cell_key(row, col), id)) {
+                    unlist_fence(engine, fence, id);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    fence->active = true;
+    engine->fences[id] = *fence;
+    engine->level_fences[level]++;
+    engine->num_fences++;
+    engine->count++;
+
+    return id;
+}
+
+// Remove fence_id from the cells of fence, those it was added to so far on a failure to add it
+static void unlist_fence(GeofenceEngine *engine, Geofence *fence, int fence_id)
+{
+    IdArray *cell;
+    int first[2], last[2];
+    int level = fence->level;
+    int ranges, row, col, i, k;
+
+    ranges = fence_cols(engine, level, fence, first, last);
+    for (row = cell_row(engine, level, fence->min_lat); row <= cell_row(engine, level, fence->max_lat); row++) {
+        for (k = 0; k < ranges; k++) {
+            for (col = first[k]; col <= last[k]; col++) {
+                cell = (IdArray *)hash_lookup(&engine->cells[level], cell_key(row, col));
+                if (!cell)
+                    continue;
+
+                for (i = 0; i < cell->count; i++) {
+                    if (cell->data[i] == fence_id) {
+                        cell->data[i] = cell->data[--cell->count];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Add fence_id to the cell of key, created on its first fence
+static bool list_fence(HashTable *cells, long long key, int fence_id)
+{
+    IdArray *cell = (IdArray *)hash_lookup(cells, key);
+
+    if (!cell) {
+        cell = (IdArray *)calloc(1, sizeof(IdArray));
+        if (!cell || !hash_insert(cells, key, cell)) {
+            free(cell);
+            return false;
+        }
+    }
+
+    return id_array_append(cell, fence_id);
+}
+
+static bool fence_contains(Geofence *fence, GEOCoordinates *position)
+{
+    GEOCoordinates *a, *b;
+    bool inside = false;
+    int i, j;
+
+    if (position->latitude < fence->min_lat || position->latitude > fence->max_lat ||
+        !fence_spans_lon(fence, position->longitude))
+        return false;
+
+    if (fence->shape == GEOFENCE_SHAPE_CIRCLE) {
+        return loc_geometry_calc_distance_mode(fence->center.latitude, fence->center.longitude,
+                                               position->latitude, position->longitude,
+                                               DISTANCE_MODE_GEODESIC) <= fence->radius;
+    }
+
+    // crossings of a ray towards the east
+    for (i = 0, j = fence->num_vertices - 1; i < fence->num_vertices; j = i++) {
+        a = &fence->vertices[i];
+        b = &fence->vertices[j];
+
+        if ((a->latitude > position->latitude) != (b->latitude > position->latitude) &&
+            position->longitude < (b->longitude - a->longitude) * (position->latitude - a->latitude) /
+                                  (b->latitude - a->latitude) + a->longitude)
+            inside = !inside;
+    }
+
+    return inside;
+}
+
+// Fence ids containing position into engine->found, in ascending order
+static void find_fences(GeofenceEngine *engine, GEOCoordinates *position)
+{
+    IdArray *cell;
+    int level, i;
+
+    engine->found.count = 0;
+
+    // a fence is in one level only, so none is found twice
+    for (level = 0; level < GEOFENCE_MAX_LEVELS; level++) {
+        if (engine->level_fences[level] == 0)
+            continue;
+
+        cell = (IdArray *)hash_lookup(&engine->cells[level], cell_key(cell_row(engine, level, position->latitude),
+                                                                      cell_col(engine, level, position->longitude)));
+        if (!cell)
+            continue;
+
+        for (i = 0; i < cell->count; i++) {
+            if (fence_contains(&engine->fences[cell->data[i]], position))
+                id_array_append(&engine->found, cell->data[i]);
+        }
+    }
+
+    if (engine->found.count > 1)
+        qsort(engine->found.data, engine->found.count, sizeof(int), compare_int);
+}
+
+static int compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void notify(GeofenceEngine *engine, int fence_id, int entity_id, GEOFENCE_TRANSITION transition,
+                   long long timestamp)
+{
+    GeofenceEvent event;
+
+    if (!engine->callback)
+        return;
+
+    event.fence_id = fence_id;
+    event.entity_id = entity_id;
+    event.transition = transition;
+    event.timestamp = timestamp;
+
+    engine->callback(&event, engine->user_data);
+}
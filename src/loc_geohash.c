@@ -0,0 +1,282 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <loc_geohash.h>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Cells are computed at the longest precision, 30 bits of each axis, then shortened
+#define GEOHASH_BITS                (5 * LOC_GEOHASH_MAX_PRECISION)
+#define GEOHASH_AXIS_BITS           (GEOHASH_BITS / 2)
+#define GEOHASH_AXIS_MAX            ((1LL << GEOHASH_AXIS_BITS) - 1)
+#define GEOHASH_MASK                ((1ULL << GEOHASH_BITS) - 1)
+#define GEOHASH_EVEN_BITS           0x5555555555555555ULL
+
+
+static const char geohash_base32[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+// Steps of latitude and longitude cells to the neighbour, in the order of GEOHASH_DIRECTION
+static const int geohash_steps[8][2] = {
+    { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }
+};
+
+
+static uint64_t geohash_spread(uint64_t x);
+static uint64_t geohash_compact(uint64_t x);
+static uint64_t geohash_quantize(double value, double half_range);
+static uint64_t geohash_interleave(uint64_t lon, uint64_t lat);
+static void geohash_split(uint64_t cell, int precision, uint64_t *lon, uint64_t *lat, int *lon_bits, int *lat_bits);
+static uint64_t geohash_join(uint64_t lon, uint64_t lat, int precision);
+
+
+
+uint64_t loc_geohash_encode(GEOCoordinates position, int precision)
+{
+    if (precision < 1 || precision > LOC_GEOHASH_MAX_PRECISION)
+        return 0;
+
+    return geohash_interleave(geohash_quantize(position.longitude, 180),
+                              geohash_quantize(position.latitude, 90)) >> (GEOHASH_BITS - 5 * precision);
+}
+
+void loc_geohash_encode_batch(const GEOCoordinates *positions, uint64_t *cells, int size, int precision)
+{
+    int shift = GEOHASH_BITS - 5 * precision;
+    int i;
+
+    if (!positions || !cells || precision < 1 || precision > LOC_GEOHASH_MAX_PRECISION)
+        return;
+
+    for (i = 0; i < size; i++)
+        cells[i] = geohash_interleave(geohash_quantize(positions[i].longitude, 180),
+                                      geohash_quantize(positions[i].latitude, 90)) >> shift;
+}
+
+GEOCoordinates loc_geohash_decode(uint64_t cell, int precision)
+{
+    GEOCoordinates south_west, north_east, center;
+
+    loc_geohash_decode_bounds(cell, precision, &south_west, &north_east);
+    center.latitude = (south_west.latitude + north_east.latitude) / 2;
+    center.longitude = (south_west.longitude + north_east.longitude) / 2;
+
+    return center;
+}
+
+void loc_geohash_decode_bounds(uint64_t cell, int precision, GEOCoordinates *south_west, GEOCoordinates *north_east)
+{
+    uint64_t lon, lat;
+    int lon_bits, lat_bits;
+    double lon_size, lat_size;
+
+    if (!south_west || !north_east)
+        return;
+
+    if (precision < 1 || precision > LOC_GEOHASH_MAX_PRECISION) {
+        south_west->latitude = -90;
+        south_west->longitude = -180;
+        north_east->latitude = 90;
+        north_east->longitude = 180;
+        return;
+    }
+
+    geohash_split(cell, precision, &lon, &lat, &lon_bits, &lat_bits);
+    lon_size = ldexp(360, -lon_bits);
+    lat_size = ldexp(180, -lat_bits);
+
+    south_west->latitude = -90 + lat * lat_size;
+    south_west->longitude = -180 + lon * lon_size;
+    north_east->latitude = south_west->latitude + lat_size;
+    north_east->longitude = south_west->longitude + lon_size;
+}
+
+int loc_geohash_neighbor(uint64_t cell, int precision, GEOHASH_DIRECTION direction, uint64_t *neighbor)
+{
+    uint64_t lon, lat;
+    int lon_bits, lat_bits;
+    long long row;
+
+    if (!neighbor || precision < 1 || precision > LOC_GEOHASH_MAX_PRECISION ||
+        direction < GEOHASH_NORTH || direction > GEOHASH_NORTH_WEST)
+        return 0;
+
+    geohash_split(cell, precision, &lon, &lat, &lon_bits, &lat_bits);
+
+    row = (long long)lat + geohash_steps[direction][0];
+    if (row < 0 || row >= (1LL << lat_bits))
+        return 0;
+
+    // columns wrap around the antimeridian
+    lon = (lon + geohash_steps[direction][1]) & ((1ULL << lon_bits) - 1);
+    *neighbor = geohash_join(lon, (uint64_t)row, precision);
+
+    return 1;
+}
+
+int loc_geohash_neighbors(uint64_t cell, int precision, uint64_t *neighbors)
+{
+    int direction, count = 0;
+
+    if (!neighbors)
+        return 0;
+
+    for (direction = GEOHASH_NORTH; direction <= GEOHASH_NORTH_WEST; direction++)
+        count += loc_geohash_neighbor(cell, precision, (GEOHASH_DIRECTION)direction, &neighbors[count]);
+
+    return count;
+}
+
+int loc_geohash_parent(uint64_t cell, int precision, uint64_t *parent)
+{
+    if (!parent || precision < 2 || precision > LOC_GEOHASH_MAX_PRECISION)
+        return 0;
+
+    *parent = cell >> 5;
+
+    return 1;
+}
+
+int loc_geohash_children(uint64_t cell, int precision, uint64_t *children)
+{
+    int i;
+
+    if (!children || precision < 1 || precision >= LOC_GEOHASH_MAX_PRECISION)
+        return 0;
+
+    for (i = 0; i < 32; i++)
+        children[i] = (cell << 5) | i;
+
+    return 32;
+}
+
+int loc_geohash_to_string(uint64_t cell, int precision, char *buffer)
+{
+    int i;
+
+    if (!buffer || precision < 1 || precision > LOC_GEOHASH_MAX_PRECISION)
+        return 0;
+
+    for (i = 0; i < precision; i++)
+        buffer[i] = geohash_base32[(cell >> (5 * (precision - 1 - i))) & 0x1f];
+    buffer[precision] = '\0';
+
+    return 1;
+}
+
+int loc_geohash_from_string(const char *geohash, uint64_t *cell, int *precision)
+{
+    const char *digit;
+    uint64_t result = 0;
+    int i, length;
+
+    if (!geohash || !cell)
+        return 0;
+
+    length = strlen(geohash);
+    if (length < 1 || length > LOC_GEOHASH_MAX_PRECISION)
+        return 0;
+
+    for (i = 0; i < length; i++) {
+        digit = (geohash[i] >= 'A' && geohash[i] <= 'Z') ? strchr(geohash_base32, geohash[i] - 'A' + 'a')
+                                                         : strchr(geohash_base32, geohash[i]);
+        if (!digit || *digit == '\0')
+            return 0;
+
+        result = (result << 5) | (uint64_t)(digit - geohash_base32);
+    }
+
+    *cell = result;
+    if (precision)
+        *precision = length;
+
+    return 1;
+}
+
+// Bits of x into the even bits of the result
+static uint64_t geohash_spread(uint64_t x)
+{
+#if defined(__BMI2__)
+    return _pdep_u64(x, GEOHASH_EVEN_BITS);
+#else
+    x &= 0xffffffffULL;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & GEOHASH_EVEN_BITS;
+
+    return x;
+#endif
+}
+
+// Even bits of x into the low bits of the result
+static uint64_t geohash_compact(uint64_t x)
+{
+#if defined(__BMI2__)
+    return _pext_u64(x, GEOHASH_EVEN_BITS);
+#else
+    x &= GEOHASH_EVEN_BITS;
+    x = (x | (x >> 1)) & 0x3333333333333333ULL;
+    x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x >> 4)) & 0x00ff00ff00ff00ffULL;
+    x = (x | (x >> 8)) & 0x0000ffff0000ffffULL;
+    x = (x | (x >> 16)) & 0x00000000ffffffffULL;
+
+    return x;
+#endif
+}
+
+// Cell of value in [-half_range, half_range] among those of GEOHASH_AXIS_BITS, the upper bound in the last one
+static uint64_t geohash_quantize(double value, double half_range)
+{
+    long long q = (long long)((value + half_range) * ((GEOHASH_AXIS_MAX + 1.0) / (2 * half_range)));
+
+    q = (q < 0) ? 0 : q;
+    q = (q > GEOHASH_AXIS_MAX) ? GEOHASH_AXIS_MAX : q;
+
+    return (uint64_t)q;
+}
+
+// Cell of the longest precision, from the longitude bit down
+static uint64_t geohash_interleave(uint64_t lon, uint64_t lat)
+{
+    return (geohash_spread(lon) << 1) | geohash_spread(lat);
+}
+
+// Longitude and latitude cells of cell, with the number of bits of each (the longitude has the odd one)
+static void geohash_split(uint64_t cell, int precision, uint64_t *lon, uint64_t *lat, int *lon_bits, int *lat_bits)
+{
+    int bits = 5 * precision;
+    uint64_t full = (cell << (GEOHASH_BITS - bits)) & GEOHASH_MASK;
+
+    *lon_bits = (bits + 1) / 2;
+    *lat_bits = bits / 2;
+    *lon = geohash_compact(full >> 1) >> (GEOHASH_AXIS_BITS - *lon_bits);
+    *lat = geohash_compact(full) >> (GEOHASH_AXIS_BITS - *lat_bits);
+}
+
+static uint64_t geohash_join(uint64_t lon, uint64_t lat, int precision)
+{
+    int bits = 5 * precision;
+
+    return geohash_interleave(lon << (GEOHASH_AXIS_BITS - (bits + 1) / 2),
+                              lat << (GEOHASH_AXIS_BITS - bits / 2)) >> (GEOHASH_BITS - bits);
+}
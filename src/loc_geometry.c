@@ -17,30 +17,615 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <glib.h>
 #include <loc_geometry.h>
 
+// Lanes of the batch kernels, as wide as the vector registers the build targets
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_LANES                  4
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_LANES                  2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SIMD_LANES                  2
+#endif
+
 #define MATH_PI                     3.1415926535897932384626433832795
 #define WGS84_EQUITORIAL_RADIUS     6378137
 #define WGS84_POLAR_RADIUS          6356752.3142
+#define WGS84_SEMI_MINOR_AXIS       6356752.314245
+#define WGS84_FLATTENING            (1 / 298.257223563)
+#define WGS84_MEAN_RADIUS           6371008.8
+#define WGS84_ECCENTRICITY          0.0818191908426214957
+#define WGS84_SQ_ECCENTRICITY       (WGS84_FLATTENING * (2 - WGS84_FLATTENING))
+
+#define VINCENTY_ITER_LIMIT         100
+#define VINCENTY_THRESHOLD          1e-12
+#define GEODESIC_ITER_LIMIT         200
+#define GEODESIC_THRESHOLD          1e-13
+
+#define COMPACT_E7_SCALE            1e7
+#define LOCAL_UNPROJECT_ITER_LIMIT  5
+#define LOCAL_UNPROJECT_THRESHOLD   1e-7
+#define ECEF_BOWRING_STEPS          2
+#define RTCEP_ENGINE_BLOCK          64
+#define RTCEP_WINDOW_BLOCK          64
+#define CLUSTER_NOISE               (-1)
+#define CLUSTER_UNVISITED           (-2)
+
+// Distance between consecutive coordinates of one kind in an array of GEOCoordinates
+#define GEO_STRIDE                  ((int)(sizeof(GEOCoordinates) / sizeof(double)))
+
+// Third flattening n and its powers for the Krueger series of the transverse Mercator projection
+#define UTM_N                       (WGS84_FLATTENING / (2 - WGS84_FLATTENING))
+#define UTM_N2                      (UTM_N * UTM_N)
+#define UTM_N3                      (UTM_N2 * UTM_N)
+#define UTM_N4                      (UTM_N3 * UTM_N)
+#define UTM_N5                      (UTM_N4 * UTM_N)
+#define UTM_N6                      (UTM_N5 * UTM_N)
+#define UTM_ORDER                   6
+
+// Radius of the sphere with the circumference of the meridian
+#define UTM_RECTIFYING_RADIUS       (WGS84_EQUITORIAL_RADIUS / (1 + UTM_N) * \
+                                     (1 + UTM_N2 / 4 + UTM_N4 / 64 + UTM_N6 / 256))
+
+// Samples per chunk of the statistics, fixed so that results do not depend on the number of threads
+#define STATS_CHUNK_SIZE            65536
+#define STATS_MAX_THREADS           8
+
+#define SIMPLIFIER_DEFAULT_POINTS   256
+
+// Argument reduction of the fast precision mode (Cody and Waite): pi / 2 and ln 2 split in a
+// 32 bit high part, whose product by a reduction multiple is exact, and the rest
+#define FAST_PIO2_HI                1.5707963267341256
+#define FAST_PIO2_LO                6.0771005065061922e-11
+#define FAST_LN2_HI                 0.69314718048553914
+#define FAST_LN2_LO                 7.4406171100123968e-11
+#define FAST_TAN_PI_8               0.41421356237309503
+// Adding and subtracting 1.5 * 2^52 rounds a double below 2^51 to the nearest integer
+#define FAST_ROUND_MAGIC            6755399441055744.0
+// Beyond these arguments the fast functions defer to libm
+#define FAST_TRIG_LIMIT             1e5
+#define FAST_EXP_LIMIT              700
+#define FAST_ATANH_LIMIT            0.1
 
 const double utm_scale_factor = 0.9996;
 
+static gint geometry_precision = GEOMETRY_PRECISION_EXACT;
+
+// Near minimax polynomials of the fast precision mode, fitted in 40 digit arithmetic.
+// sin(r) = r + r^3 P(r^2) and cos(r) = 1 - r^2 / 2 + r^4 Q(r^2) for |r| <= pi / 4, error below 1e-16
+static const double fast_sin_coef[] = {
+    -0.16666666666666666, 0.008333333333330948, -0.00019841269836758574,
+    2.7557316102552439e-06, -2.5051131845003624e-08, 1.5918129294866608e-10
+};
+
+static const double fast_cos_coef[] = {
+    0.041666666666666664, -0.0013888888888887398, 2.4801587298765689e-05,
+    -2.7557317271729793e-07, 2.0876146268403199e-09, -1.1382632425521717e-11
+};
+
+static const double fast_quadrant_sign[2] = { 1.0, -1.0 };
+
+// atan(t) = t + t^3 A(t^2) for |t| <= tan(pi / 8), error below 1e-16
+static const double fast_atan_coef[] = {
+    -0.33333333333333248, 0.19999999999898407, -0.14285714266096619, 0.11111109636534361,
+    -0.09090852557176049, 0.076910551583931494, -0.066496136952916687, 0.057363321659076427,
+    -0.044833346222728859, 0.022750526993361671
+};
+
+// exp(r) for |r| <= ln(2) / 2, relative error below 1e-16
+static const double fast_exp_coef[] = {
+    1, 1, 0.50000000000000189, 0.1666666666666668, 0.041666666666488099, 0.0083333333333196011,
+    0.0013888888952314775, 0.00019841269890047113, 2.4801485482328494e-05, 2.755724091857897e-06,
+    2.7632639639041029e-07, 2.5110037605963777e-08
+};
+
+// atanh(x) = x + x^3 H(x^2), Taylor series for |x| <= FAST_ATANH_LIMIT
+static const double fast_atanh_coef[] = {
+    1.0 / 3, 1.0 / 5, 1.0 / 7, 1.0 / 9, 1.0 / 11, 1.0 / 13, 1.0 / 15
+};
+
+// Series coefficients, evaluated by the compiler, from geographic to transverse Mercator
+static const double utm_alpha[UTM_ORDER] = {
+    UTM_N / 2 - UTM_N2 * 2 / 3 + UTM_N3 * 5 / 16 + UTM_N4 * 41 / 180 - UTM_N5 * 127 / 288 + UTM_N6 * 7891 / 37800,
+    UTM_N2 * 13 / 48 - UTM_N3 * 3 / 5 + UTM_N4 * 557 / 1440 + UTM_N5 * 281 / 630 - UTM_N6 * 1983433 / 1935360,
+    UTM_N3 * 61 / 240 - UTM_N4 * 103 / 140 + UTM_N5 * 15061 / 26880 + UTM_N6 * 167603 / 181440,
+    UTM_N4 * 49561 / 161280 - UTM_N5 * 179 / 168 + UTM_N6 * 6601661 / 7257600,
+    UTM_N5 * 34729 / 80640 - UTM_N6 * 3418889 / 1995840,
+    UTM_N6 * 212378941 / 319334400
+};
+
+// and back
+static const double utm_beta[UTM_ORDER] = {
+    UTM_N / 2 - UTM_N2 * 2 / 3 + UTM_N3 * 37 / 96 - UTM_N4 / 360 - UTM_N5 * 81 / 512 + UTM_N6 * 96199 / 604800,
+    UTM_N2 / 48 + UTM_N3 / 15 - UTM_N4 * 437 / 1440 + UTM_N5 * 46 / 105 - UTM_N6 * 1118711 / 3870720,
+    UTM_N3 * 17 / 480 - UTM_N4 * 37 / 840 - UTM_N5 * 209 / 4480 + UTM_N6 * 5569 / 90720,
+    UTM_N4 * 4397 / 161280 - UTM_N5 * 11 / 504 - UTM_N6 * 830251 / 7257600,
+    UTM_N5 * 4583 / 161280 - UTM_N6 * 108847 / 3991680,
+    UTM_N6 * 20648693 / 638668800
+};
+
+// from conformal to geographic latitude
+static const double utm_delta[UTM_ORDER] = {
+    UTM_N * 2 - UTM_N2 * 2 / 3 - UTM_N3 * 2 + UTM_N4 * 116 / 45 + UTM_N5 * 26 / 45 - UTM_N6 * 2854 / 675,
+    UTM_N2 * 7 / 3 - UTM_N3 * 8 / 5 - UTM_N4 * 227 / 45 + UTM_N5 * 2704 / 315 + UTM_N6 * 2323 / 945,
+    UTM_N3 * 56 / 15 - UTM_N4 * 136 / 35 - UTM_N5 * 1262 / 105 + UTM_N6 * 73814 / 2835,
+    UTM_N4 * 4279 / 630 - UTM_N5 * 332 / 35 - UTM_N6 * 399572 / 14175,
+    UTM_N5 * 4174 / 315 - UTM_N6 * 144838 / 6237,
+    UTM_N6 * 601676 / 22275
+};
+
+#if defined(SIMD_LANES)
+// Lane-wise operations of the batch kernels, each the same IEEE operation as its scalar
+// counterpart. Masks have all bits of a lane set where a comparison holds.
+#if defined(__AVX2__)
+typedef __m256d simd_double;
+typedef __m256d simd_mask;
+
+static inline simd_double simd_set(double x) { return _mm256_set1_pd(x); }
+static inline simd_double simd_load(const double *p) { return _mm256_loadu_pd(p); }
+static inline void simd_store(double *p, simd_double x) { _mm256_storeu_pd(p, x); }
+static inline simd_double simd_add(simd_double a, simd_double b) { return _mm256_add_pd(a, b); }
+static inline simd_double simd_sub(simd_double a, simd_double b) { return _mm256_sub_pd(a, b); }
+static inline simd_double simd_mul(simd_double a, simd_double b) { return _mm256_mul_pd(a, b); }
+static inline simd_double simd_div(simd_double a, simd_double b) { return _mm256_div_pd(a, b); }
+static inline simd_double simd_sqrt(simd_double x) { return _mm256_sqrt_pd(x); }
+static inline simd_double simd_neg(simd_double x) { return _mm256_xor_pd(x, _mm256_set1_pd(-0.0)); }
+static inline simd_double simd_abs(simd_double x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+static inline simd_mask simd_lt(simd_double a, simd_double b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+static inline simd_mask simd_eq(simd_double a, simd_double b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+static inline simd_mask simd_isnan(simd_double x) { return _mm256_cmp_pd(x, x, _CMP_UNORD_Q); }
+static inline simd_mask simd_none(void) { return _mm256_setzero_pd(); }
+static inline simd_mask simd_or(simd_mask a, simd_mask b) { return _mm256_or_pd(a, b); }
+static inline simd_mask simd_and(simd_mask a, simd_mask b) { return _mm256_and_pd(a, b); }
+static inline simd_mask simd_andnot(simd_mask a, simd_mask b) { return _mm256_andnot_pd(b, a); }
+static inline simd_mask simd_not(simd_mask a) { return _mm256_xor_pd(a, _mm256_cmp_pd(a, a, _CMP_TRUE_UQ)); }
+static inline int simd_bits(simd_mask m) { return _mm256_movemask_pd(m); }
+static inline simd_double simd_select(simd_mask m, simd_double a, simd_double b) { return _mm256_blendv_pd(b, a, m); }
+
+// sin and cos of x from those of its remainder r by pi / 2, the quadrant in the low bits of
+// sum = x * 2 / pi + FAST_ROUND_MAGIC
+static inline void simd_quadrant(simd_double sum, simd_double sin_r, simd_double cos_r,
+                                 simd_double *sin_x, simd_double *cos_x)
+{
+    __m256i q = _mm256_castpd_si256(sum), one = _mm256_set1_epi64x(1);
+    __m256d odd = _mm256_castsi256_pd(_mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(q, one)));
+
+    *sin_x = _mm256_xor_pd(_mm256_blendv_pd(sin_r, cos_r, odd),
+                           _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(q, 1), 63)));
+    *cos_x = _mm256_xor_pd(_mm256_blendv_pd(cos_r, sin_r, odd),
+                           _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(_mm256_add_epi64(q, one), 1), 63)));
+}
+
+// 2^k of the k in the low bits of sum = x / ln 2 + FAST_ROUND_MAGIC, as fast_exp() scales
+static inline simd_double simd_exp_scale(simd_double sum)
+{
+    return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(sum),
+                                                                   _mm256_set1_epi64x(1023)), 52));
+}
+
+// Lanes of consecutive structs of three or two doubles, one vector per member
+static inline void simd_load_xyz(const double *p, simd_double *x, simd_double *y, simd_double *z)
+{
+    __m128d a = _mm_loadu_pd(p), b = _mm_loadu_pd(p + 2), c = _mm_loadu_pd(p + 4);
+    __m128d d = _mm_loadu_pd(p + 6), e = _mm_loadu_pd(p + 8), f = _mm_loadu_pd(p + 10);
+
+    *x = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_shuffle_pd(a, b, 2)), _mm_shuffle_pd(d, e, 2), 1);
+    *y = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_shuffle_pd(a, c, 1)), _mm_shuffle_pd(d, f, 1), 1);
+    *z = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_shuffle_pd(b, c, 2)), _mm_shuffle_pd(e, f, 2), 1);
+}
+
+static inline void simd_store_xyz(double *p, simd_double x, simd_double y, simd_double z)
+{
+    __m128d x0 = _mm256_castpd256_pd128(x), y0 = _mm256_castpd256_pd128(y), z0 = _mm256_castpd256_pd128(z);
+    __m128d x1 = _mm256_extractf128_pd(x, 1), y1 = _mm256_extractf128_pd(y, 1), z1 = _mm256_extractf128_pd(z, 1);
+
+    _mm_storeu_pd(p, _mm_shuffle_pd(x0, y0, 0));
+    _mm_storeu_pd(p + 2, _mm_shuffle_pd(z0, x0, 2));
+    _mm_storeu_pd(p + 4, _mm_shuffle_pd(y0, z0, 3));
+    _mm_storeu_pd(p + 6, _mm_shuffle_pd(x1, y1, 0));
+    _mm_storeu_pd(p + 8, _mm_shuffle_pd(z1, x1, 2));
+    _mm_storeu_pd(p + 10, _mm_shuffle_pd(y1, z1, 3));
+}
+
+static inline void simd_load_pairs(const double *p, simd_double *a, simd_double *b)
+{
+    __m256d lo = _mm256_loadu_pd(p), hi = _mm256_loadu_pd(p + 4);
+
+    *a = _mm256_permute4x64_pd(_mm256_unpacklo_pd(lo, hi), 0xd8);
+    *b = _mm256_permute4x64_pd(_mm256_unpackhi_pd(lo, hi), 0xd8);
+}
+
+static inline void simd_store_pairs(double *p, simd_double a, simd_double b)
+{
+    __m256d lo = _mm256_unpacklo_pd(a, b), hi = _mm256_unpackhi_pd(a, b);
+
+    _mm256_storeu_pd(p, _mm256_permute2f128_pd(lo, hi, 0x20));
+    _mm256_storeu_pd(p + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+}
+#elif defined(__SSE2__)
+typedef __m128d simd_double;
+typedef __m128d simd_mask;
+
+static inline simd_double simd_set(double x) { return _mm_set1_pd(x); }
+static inline simd_double simd_load(const double *p) { return _mm_loadu_pd(p); }
+static inline void simd_store(double *p, simd_double x) { _mm_storeu_pd(p, x); }
+static inline simd_double simd_add(simd_double a, simd_double b) { return _mm_add_pd(a, b); }
+static inline simd_double simd_sub(simd_double a, simd_double b) { return _mm_sub_pd(a, b); }
+static inline simd_double simd_mul(simd_double a, simd_double b) { return _mm_mul_pd(a, b); }
+static inline simd_double simd_div(simd_double a, simd_double b) { return _mm_div_pd(a, b); }
+static inline simd_double simd_sqrt(simd_double x) { return _mm_sqrt_pd(x); }
+static inline simd_double simd_neg(simd_double x) { return _mm_xor_pd(x, _mm_set1_pd(-0.0)); }
+static inline simd_double simd_abs(simd_double x) { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+static inline simd_mask simd_lt(simd_double a, simd_double b) { return _mm_cmplt_pd(a, b); }
+static inline simd_mask simd_eq(simd_double a, simd_double b) { return _mm_cmpeq_pd(a, b); }
+static inline simd_mask simd_isnan(simd_double x) { return _mm_cmpunord_pd(x, x); }
+static inline simd_mask simd_none(void) { return _mm_setzero_pd(); }
+static inline simd_mask simd_or(simd_mask a, simd_mask b) { return _mm_or_pd(a, b); }
+static inline simd_mask simd_and(simd_mask a, simd_mask b) { return _mm_and_pd(a, b); }
+static inline simd_mask simd_andnot(simd_mask a, simd_mask b) { return _mm_andnot_pd(b, a); }
+static inline simd_mask simd_not(simd_mask a) { return _mm_xor_pd(a, _mm_castsi128_pd(_mm_set1_epi32(-1))); }
+static inline int simd_bits(simd_mask m) { return _mm_movemask_pd(m); }
+
+static inline simd_double simd_select(simd_mask m, simd_double a, simd_double b)
+{
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+}
+
+// sin and cos of x from those of its remainder r by pi / 2, the quadrant in the low bits of
+// sum = x * 2 / pi + FAST_ROUND_MAGIC
+static inline void simd_quadrant(simd_double sum, simd_double sin_r, simd_double cos_r,
+                                 simd_double *sin_x, simd_double *cos_x)
+{
+    __m128i q = _mm_castpd_si128(sum), one = _mm_set1_epi64x(1);
+    __m128d odd = _mm_castsi128_pd(_mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(q, one)));
+
+    *sin_x = _mm_xor_pd(simd_select(odd, cos_r, sin_r), _mm_castsi128_pd(_mm_slli_epi64(_mm_srli_epi64(q, 1), 63)));
+    *cos_x = _mm_xor_pd(simd_select(odd, sin_r, cos_r),
+                        _mm_castsi128_pd(_mm_slli_epi64(_mm_srli_epi64(_mm_add_epi64(q, one), 1), 63)));
+}
+
+// 2^k of the k in the low bits of sum = x / ln 2 + FAST_ROUND_MAGIC, as fast_exp() scales
+static inline simd_double simd_exp_scale(simd_double sum)
+{
+    return _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(_mm_castpd_si128(sum), _mm_set1_epi64x(1023)), 52));
+}
+
+// Lanes of consecutive structs of three or two doubles, one vector per member
+static inline void simd_load_xyz(const double *p, simd_double *x, simd_double *y, simd_double *z)
+{
+    __m128d a = _mm_loadu_pd(p), b = _mm_loadu_pd(p + 2), c = _mm_loadu_pd(p + 4);
+
+    *x = _mm_shuffle_pd(a, b, 2);
+    *y = _mm_shuffle_pd(a, c, 1);
+    *z = _mm_shuffle_pd(b, c, 2);
+}
+
+static inline void simd_store_xyz(double *p, simd_double x, simd_double y, simd_double z)
+{
+    _mm_storeu_pd(p, _mm_shuffle_pd(x, y, 0));
+    _mm_storeu_pd(p + 2, _mm_shuffle_pd(z, x, 2));
+    _mm_storeu_pd(p + 4, _mm_shuffle_pd(y, z, 3));
+}
+
+static inline void simd_load_pairs(const double *p, simd_double *a, simd_double *b)
+{
+    __m128d lo = _mm_loadu_pd(p), hi = _mm_loadu_pd(p + 2);
+
+    *a = _mm_unpacklo_pd(lo, hi);
+    *b = _mm_unpackhi_pd(lo, hi);
+}
+
+static inline void simd_store_pairs(double *p, simd_double a, simd_double b)
+{
+    _mm_storeu_pd(p, _mm_unpacklo_pd(a, b));
+    _mm_storeu_pd(p + 2, _mm_unpackhi_pd(a, b));
+}
+#else
+typedef float64x2_t simd_double;
+typedef uint64x2_t simd_mask;
+
+static inline simd_double simd_set(double x) { return vdupq_n_f64(x); }
+static inline simd_double simd_load(const double *p) { return vld1q_f64(p); }
+static inline void simd_store(double *p, simd_double x) { vst1q_f64(p, x); }
+static inline simd_double simd_add(simd_double a, simd_double b) { return vaddq_f64(a, b); }
+static inline simd_double simd_sub(simd_double a, simd_double b) { return vsubq_f64(a, b); }
+static inline simd_double simd_mul(simd_double a, simd_double b) { return vmulq_f64(a, b); }
+static inline simd_double simd_div(simd_double a, simd_double b) { return vdivq_f64(a, b); }
+static inline simd_double simd_sqrt(simd_double x) { return vsqrtq_f64(x); }
+static inline simd_double simd_neg(simd_double x) { return vnegq_f64(x); }
+static inline simd_double simd_abs(simd_double x) { return vabsq_f64(x); }
+static inline simd_mask simd_lt(simd_double a, simd_double b) { return vcltq_f64(a, b); }
+static inline simd_mask simd_eq(simd_double a, simd_double b) { return vceqq_f64(a, b); }
+static inline simd_mask simd_none(void) { return vdupq_n_u64(0); }
+static inline simd_mask simd_not(simd_mask a) { return veorq_u64(a, vdupq_n_u64(~0ULL)); }
+static inline simd_mask simd_isnan(simd_double x) { return simd_not(vceqq_f64(x, x)); }
+static inline simd_mask simd_or(simd_mask a, simd_mask b) { return vorrq_u64(a, b); }
+static inline simd_mask simd_and(simd_mask a, simd_mask b) { return vandq_u64(a, b); }
+static inline simd_mask simd_andnot(simd_mask a, simd_mask b) { return vbicq_u64(a, b); }
+static inline int simd_bits(simd_mask m) { return (int)((vgetq_lane_u64(m, 0) & 1) | (vgetq_lane_u64(m, 1) & 2)); }
+static inline simd_double simd_select(simd_mask m, simd_double a, simd_double b) { return vbslq_f64(m, a, b); }
+
+// sin and cos of x from those of its remainder r by pi / 2, the quadrant in the low bits of
+// sum = x * 2 / pi + FAST_ROUND_MAGIC
+static inline void simd_quadrant(simd_double sum, simd_double sin_r, simd_double cos_r,
+                                 simd_double *sin_x, simd_double *cos_x)
+{
+    uint64x2_t q = vreinterpretq_u64_f64(sum), one = vdupq_n_u64(1);
+    uint64x2_t odd = vceqq_u64(vandq_u64(q, one), one);
+
+    *sin_x = vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(vbslq_f64(odd, cos_r, sin_r)),
+                                             vshlq_n_u64(vshrq_n_u64(q, 1), 63)));
+    *cos_x = vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(vbslq_f64(odd, sin_r, cos_r)),
+                                             vshlq_n_u64(vshrq_n_u64(vaddq_u64(q, one), 1), 63)));
+}
+
+// 2^k of the k in the low bits of sum = x / ln 2 + FAST_ROUND_MAGIC, as fast_exp() scales
+static inline simd_double simd_exp_scale(simd_double sum)
+{
+    return vreinterpretq_f64_u64(vshlq_n_u64(vaddq_u64(vreinterpretq_u64_f64(sum), vdupq_n_u64(1023)), 52));
+}
+
+// Lanes of consecutive structs of three or two doubles, one vector per member
+static inline void simd_load_xyz(const double *p, simd_double *x, simd_double *y, simd_double *z)
+{
+    float64x2x3_t v = vld3q_f64(p);
+
+    *x = v.val[0];
+    *y = v.val[1];
+    *z = v.val[2];
+}
+
+static inline void simd_store_xyz(double *p, simd_double x, simd_double y, simd_double z)
+{
+    float64x2x3_t v = { { x, y, z } };
+
+    vst3q_f64(p, v);
+}
+
+static inline void simd_load_pairs(const double *p, simd_double *a, simd_double *b)
+{
+    float64x2x2_t v = vld2q_f64(p);
+
+    *a = v.val[0];
+    *b = v.val[1];
+}
+
+static inline void simd_store_pairs(double *p, simd_double a, simd_double b)
+{
+    float64x2x2_t v = { { a, b } };
+
+    vst2q_f64(p, v);
+}
+#endif
+#endif
+
+
+struct _LocalProjection {
+    GEOCoordinates origin;
+    double sin_lat;
+    double cos_lat;
+    double sin_lon;
+    double cos_lon;
+    // origin in earth centered coordinates, in the meridian plane of the origin
+    double ecef_x;
+    double ecef_z;
+};
+
+// Count, mean and sum of squared deviations from the mean of East and North offsets (Welford)
+typedef struct {
+    int count;
+    double mean_x;
+    double mean_y;
+    double m2_x;
+    double m2_y;
+} StatsAccumulator;
+
+typedef struct {
+    GEOCoordinates *measures;
+    int size;
+    STATS_PROJECTION projection;
+    UTMCoordinates utm_origin;
+    LocalProjection local_origin;
+    StatsAccumulator *chunks;
+    int num_chunks;
+    int num_threads;
+} StatsJob;
+
+typedef struct {
+    StatsJob *job;
+    int first_chunk;
+} StatsWorker;
+
+// P-square estimate of one quantile with five markers (Jain and Chlamtac, 1985)
+// The first five samples are kept sorted in heights until the markers can be placed.
+typedef struct {
+    double p;
+    double heights[5];
+    double positions[5];
+    double desired[5];
+    int count;
+} QuantileSketch;
+
+// Projected offset of a measured position in the sliding window
+typedef struct {
+    double east;
+    double north;
+    long long timestamp;
+} RTCEPSample;
 
 struct _RTCEPCalculator {
     GEOCoordinates ref_geo_pos;
     UTMCoordinates ref_utm_pos;
+    LocalProjection ref_local;
+    STATS_PROJECTION projection;
+    RTCEP_ESTIMATE estimate;
+    QuantileSketch sketch_cep;
+    QuantileSketch sketch_r95;
     double lamda_x;
     double lamda_y;
     int max_count;
     int count;
+    // ring of window_size samples, count of them from window_head, when the window is set
+    // It holds window_fixes samples, or grows as needed when only window_time bounds the window.
+    RTCEPSample *window;
+    int window_size;
+    int window_fixes;
+    int window_head;
+    long long window_time;
+    int window_updates;
+    // radii of the samples in the window in increasing order, kept for RTCEP_ESTIMATE_QUANTILE
+    double *window_radii;
+};
+
+struct _RTCEPShards {
+    RTCEPCalculator **shards;
+    GMutex *locks;
+    int num_shards;
+};
+
+// Components of a Real Time CEP Calculator per reference, one array each
+struct _RTCEPEngine {
+    GEOCoordinates *ref_geo_pos;
+    double *ref_easting;
+    double *ref_northing;
+    // local tangent plane of each reference, as in LocalProjection
+    double *sin_lat;
+    double *cos_lat;
+    double *ecef_x;
+    double *ecef_z;
+    double *lamda_x;
+    double *lamda_y;
+    int *count;
+    QuantileSketch *sketch_cep;
+    QuantileSketch *sketch_r95;
+    int num_refs;
+    STATS_PROJECTION projection;
+    RTCEP_ESTIMATE estimate;
+    int max_count;
+};
+
+// Grid cell of a clustered position
+typedef struct {
+    long long x;
+    long long y;
+    int index;
+} ClusterCell;
+
+// Positions in the tangent plane of the first one, and their cells sorted by column then row
+typedef struct {
+    ENUCoordinates *enu;
+    ClusterCell *cells;
+    int size;
+    double eps;
+} ClusterGrid;
+
+struct _TrajectorySimplifier {
+    double tolerance;
+    // last kept point, and the tangent plane at it
+    LocalProjection anchor;
+    gboolean started;
+    // points added since, projected, the newest one also as it was added
+    double *east;
+    double *north;
+    int count;
+    int max_points;
+    GEOCoordinates last;
 };
 
 
-double arc_length_of_meridian(double latitudeInRadians);
-double footpoint_latitude(double northingInMeters);
+void utm_series(const double *coef, double xi, double eta, double *sum_xi, double *sum_eta);
+void utm_clenshaw(const double *coef, double sin_2xi, double cos_2xi, double sinh_2eta, double cosh_2eta,
+                  double *sum_xi, double *sum_eta);
 UTMCoordinates wgs84_to_tm(GEOCoordinates radCoordinates, double centralMeridian);
 GEOCoordinates tm_to_wgs84(UTMCoordinates tm, double centralMeridian);
+UTMCoordinates wgs84_to_tm_fast(GEOCoordinates radCoordinates, double centralMeridian);
+GEOCoordinates tm_to_wgs84_fast(UTMCoordinates tm, double centralMeridian);
+void fast_sincos(double x, double *sin_x, double *cos_x);
+double fast_atan2(double y, double x);
+double fast_exp(double x);
+double fast_atanh(double x);
+GEOCoordinates get_avg_geo(GEOCoordinates *measures, int size);
 UTMCoordinates get_avg_utm(GEOCoordinates *measures, int size);
+void local_init(LocalProjection *proj, GEOCoordinates *origin);
+void local_project(const LocalProjection *proj, const GEOCoordinates *position, double *east, double *north);
+void local_unproject(const LocalProjection *proj, double east, double north, GEOCoordinates *position);
+void geodetic_to_ecef(double latitude, double longitude, double height, GEOMETRY_PRECISION precision,
+                      ECEFCoordinates *ecef);
+void ecef_to_geodetic(double x, double y, double z, GEOMETRY_PRECISION precision,
+                      double *phi, double *lambda, double *height);
+void calc_sum_of_squares(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                         STATS_PROJECTION projection, double *sum_x, double *sum_y);
+void stats_accumulate(StatsAccumulator *acc, double x, double y);
+void stats_merge(StatsAccumulator *acc, const StatsAccumulator *other);
+void stats_run_chunk(StatsJob *job, int chunk);
+gpointer stats_run_worker(gpointer data);
+void quantile_init(QuantileSketch *sketch, double p);
+void quantile_add(QuantileSketch *sketch, double x);
+double quantile_get(const QuantileSketch *sketch);
+RTCEPCalculator* rtcep_create_like(RTCEPCalculator *rtcep);
+gboolean rtcep_merge(RTCEPCalculator *rtcep, RTCEPCalculator *other);
+void quantile_merge(QuantileSketch *sketch, const QuantileSketch *other);
+void rtcep_add(RTCEPCalculator *rtcep, GEOCoordinates *measured_position, long long timestamp);
+void rtcep_evict(RTCEPCalculator *rtcep, long long timestamp);
+void rtcep_window_recompute(RTCEPCalculator *rtcep);
+gboolean rtcep_window_grow(RTCEPCalculator *rtcep);
+void rtcep_window_rank(RTCEPCalculator *rtcep);
+int rtcep_window_search(const RTCEPCalculator *rtcep, double radius);
+void rtcep_window_insert(RTCEPCalculator *rtcep, double radius);
+void rtcep_window_remove(RTCEPCalculator *rtcep, double radius);
+double rtcep_window_quantile(RTCEPCalculator *rtcep, double p);
+void rtcep_engine_project(RTCEPEngine *engine, const int *ref_indexes, const GEOCoordinates *measured_positions,
+                          int size, double *east, double *north);
+void rtcep_engine_add(RTCEPEngine *engine, int ref_index, double east, double north);
+int compare_double(const void *a, const void *b);
+gboolean cluster_grid_init(ClusterGrid *grid, const GEOCoordinates *positions, int size, double eps);
+void cluster_grid_free(ClusterGrid *grid);
+int cluster_grid_query(const ClusterGrid *grid, int position, int *neighbors);
+int cluster_grid_find(const ClusterGrid *grid, long long x, long long y);
+int compare_cluster_cell(const void *a, const void *b);
+void cluster_expand(const ClusterGrid *grid, int min_points, int cluster, int *labels, int *neighbors, int *queue,
+                    int count);
+double segment_distance(double x, double y, double end_x, double end_y);
+void reduced_latitude(double latitude, GEOMETRY_PRECISION precision, double *sin_u, double *cos_u);
+void distance_pairs(const double *lat1, const double *lon1, const double *lat2, const double *lon2, int stride,
+                    double *distances, int size, GEOMETRY_PRECISION precision);
+void distance_from_ref(const GEOCoordinates *ref, const double *latitudes, const double *longitudes, int stride,
+                       double *distances, int size, GEOMETRY_PRECISION precision);
+double polyline_pass(const GEOCoordinates *points, const long long *timestamps_ms,
+                     double *cumulative, double *speeds, int size, GEOMETRY_PRECISION precision);
+double vincenty_pair(double sin_u1, double cos_u1, double sin_u2, double cos_u2, double delta_lon,
+                     GEOMETRY_PRECISION precision);
+double distance_vincenty(double lat1, double lon1, double lat2, double lon2);
+double distance_equirectangular(double lat1, double lon1, double lat2, double lon2);
+double distance_haversine(double lat1, double lon1, double lat2, double lon2);
+double distance_andoyer_lambert(double lat1, double lon1, double lat2, double lon2);
+double distance_antipodal(double sin_u1, double cos_u1, double sin_u2, double cos_u2, double delta_lon);
+double geodesic_lambda(double sin_b1, double cos_b1, double sin_b2, double cos_b2, double alpha1,
+                       double *sigma, double *sq_cos_alpha, double *cos_2sigma);
+#if defined(SIMD_LANES)
+static void simd_fast_sincos(simd_double x, simd_double *sin_x, simd_double *cos_x);
+static simd_double simd_fast_atan2(simd_double y, simd_double x);
+static simd_mask simd_reduced_latitude(simd_double latitude, simd_double *sin_u, simd_double *cos_u);
+static int vincenty_lanes(simd_double sin_u1, simd_double cos_u1, simd_double sin_u2, simd_double cos_u2,
+                          simd_double delta_lon, simd_mask skip, double *distances, int *antipodal);
+static simd_double simd_fast_exp(simd_double x);
+static simd_double simd_fast_atanh(simd_double x);
+static simd_mask simd_atan2_skip(simd_double y, simd_double x);
+static simd_mask simd_beyond(simd_double x, double limit);
+static void simd_utm_clenshaw(const double *coef, simd_double sin_2xi, simd_double cos_2xi, simd_double sinh_2eta,
+                              simd_double cosh_2eta, simd_double *sum_xi, simd_double *sum_eta);
+static int wgs84_to_utm_lanes(const GEOCoordinates *wgs84, UTMCoordinates *utm, int size);
+static int utm_to_wgs84_lanes(const UTMCoordinates *utm, GEOCoordinates *wgs84, int size);
+static int geodetic_to_ecef_lanes(const GEOCoordinates *wgs84, const double *heights, ECEFCoordinates *ecef, int size);
+static int ecef_to_geodetic_lanes(const ECEFCoordinates *ecef, GEOCoordinates *wgs84, double *heights, int size,
+                                  GEOMETRY_PRECISION precision);
+static int ecef_to_enu_lanes(const LocalProjection *proj, const ECEFCoordinates *ecef, ENUCoordinates *enu, int size);
+static int enu_to_ecef_lanes(const LocalProjection *proj, const ENUCoordinates *enu, ECEFCoordinates *ecef, int size);
+#endif
 
 
 
@@ -58,65 +643,101 @@ double loc_geometry_degrees_to_radians(double degrees)
 
 double loc_geometry_calc_distance(double lat1, double lon1, double lat2, double lon2)
 {
-    double lambdaP, iter_limit = 100.0;
-    double sin_sigma, sin_alpha, cos_sigma, sigma,  sq_cos_alpha, cos_2sigma, C;
-    double sq_u, cal1, cal2, delta_sigma, cal_dist;
-    double sin_lambda, cos_lambda;
+    return loc_geometry_calc_distance_with_precision(lat1, lon1, lat2, lon2, loc_geometry_get_precision());
+}
 
-    const double a = 6378137.0;
-    const double b = 6356752.314245;
-    const double f = 1 / 298.257223563;
-    double delta_lon = ((lon2 - lon1) * MATH_PI / 180);
-    double u_1 = atan((1 - f) * tan((lat1) * MATH_PI / 180));
-    double u_2 = atan((1 - f) * tan((lat2) * MATH_PI / 180));
+double loc_geometry_calc_distance_with_precision(double lat1, double lon1, double lat2, double lon2,
+                                                 GEOMETRY_PRECISION precision)
+{
+    double distance;
 
-    double lambda = delta_lon;
-    double sin_u1 = sin(u_1);
-    double cos_u1 = cos(u_1);
-    double sin_u2 = sin(u_2);
-    double cos_u2 = cos(u_2);
+    if (precision != GEOMETRY_PRECISION_FAST)
+        return distance_vincenty(lat1, lon1, lat2, lon2);
 
-    do {
-        sin_lambda = sin(lambda);
-        cos_lambda = cos(lambda);
-        sin_sigma = sqrt((cos_u2 * sin_lambda) * (cos_u2 * sin_lambda) +
-                         (cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda) *
-                         (cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda));
+    distance_pairs(&lat1, &lon1, &lat2, &lon2, 1, &distance, 1, precision);
 
-        // co-incident points
-        if (sin_sigma == 0)
-            return 0;
+    return distance;
+}
 
-        cos_sigma = sin_u1 * sin_u2 + cos_u1 * cos_u2 * cos_lambda;
-        sigma = atan2(sin_sigma, cos_sigma);
-        sin_alpha = cos_u1 * cos_u2 * sin_lambda / sin_sigma;
-        sq_cos_alpha = 1.0 - sin_alpha * sin_alpha;
-        cos_2sigma = cos_sigma - 2.0 * sin_u1 * sin_u2 / sq_cos_alpha;
+void loc_geometry_calc_distance_batch(const GEOCoordinates *from, const GEOCoordinates *to, double *distances, int size)
+{
+    if (!from || !to || !distances || size <= 0)
+        return;
 
-        if (isnan(cos_2sigma))
-            cos_2sigma = 0;
+    distance_pairs(&from[0].latitude, &from[0].longitude, &to[0].latitude, &to[0].longitude, GEO_STRIDE,
+                   distances, size, loc_geometry_get_precision());
+}
 
-        C = f / 16.0 * sq_cos_alpha * (4.0 + f * (4.0 - 3.0 * sq_cos_alpha));
-        lambdaP = lambda;
-        lambda = delta_lon + (1.0 - C) * f * sin_alpha *
-                 (sigma + C * sin_sigma * (cos_2sigma + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma)));
-    } while (abs(lambda - lambdaP) > 1e-12 && --iter_limit > 0);
+void loc_geometry_calc_distance_one_to_many(GEOCoordinates ref, const GEOCoordinates *points, double *distances, int size)
+{
+    if (!points || !distances || size <= 0)
+        return;
 
-    if (iter_limit == 0)
+    distance_from_ref(&ref, &points[0].latitude, &points[0].longitude, GEO_STRIDE, distances, size,
+                      loc_geometry_get_precision());
+}
+
+void loc_geometry_calc_distance_batch_soa(const double *lat1, const double *lon1, const double *lat2, const double *lon2,
+                                          double *distances, int size)
+{
+    if (!lat1 || !lon1 || !lat2 || !lon2 || !distances || size <= 0)
+        return;
+
+    distance_pairs(lat1, lon1, lat2, lon2, 1, distances, size, loc_geometry_get_precision());
+}
+
+void loc_geometry_calc_distance_one_to_many_soa(GEOCoordinates ref, const double *latitudes, const double *longitudes,
+                                                double *distances, int size)
+{
+    if (!latitudes || !longitudes || !distances || size <= 0)
+        return;
+
+    distance_from_ref(&ref, latitudes, longitudes, 1, distances, size, loc_geometry_get_precision());
+}
+
+double loc_geometry_calc_polyline_length(const GEOCoordinates *points, int size)
+{
+    if (!points || size <= 1)
         return 0;
 
-    sq_u = sq_cos_alpha * (a * a - b * b) / (b * b);
-    cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
-    cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
-    delta_sigma = cal2 * sin_sigma * (cos_2sigma + cal2 / 4.0 * (cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma) -
-                cal2 / 6.0 * cos_2sigma * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * cos_2sigma * cos_2sigma)));
+    return polyline_pass(points, NULL, NULL, NULL, size, loc_geometry_get_precision());
+}
 
-    cal_dist = b * cal1 * (sigma - delta_sigma);
+double loc_geometry_calc_polyline(const GEOCoordinates *points, const long long *timestamps_ms,
+                                  double *cumulative, double *speeds, int size)
+{
+    if (!points || size <= 0)
+        return 0;
 
-    return cal_dist;
+    if (!timestamps_ms)
+        speeds = NULL;
+
+    return polyline_pass(points, timestamps_ms, cumulative, speeds, size, loc_geometry_get_precision());
+}
+
+double loc_geometry_calc_distance_mode(double lat1, double lon1, double lat2, double lon2, DISTANCE_MODE mode)
+{
+    switch (mode) {
+    case DISTANCE_MODE_EQUIRECTANGULAR:
+        return distance_equirectangular(lat1, lon1, lat2, lon2);
+    case DISTANCE_MODE_HAVERSINE:
+        return distance_haversine(lat1, lon1, lat2, lon2);
+    case DISTANCE_MODE_ANDOYER_LAMBERT:
+        return distance_andoyer_lambert(lat1, lon1, lat2, lon2);
+    case DISTANCE_MODE_GEODESIC:
+        return distance_vincenty(lat1, lon1, lat2, lon2);
+    case DISTANCE_MODE_VINCENTY:
+    default:
+        return loc_geometry_calc_distance(lat1, lon1, lat2, lon2);
+    }
 }
 
 UTMCoordinates loc_geometry_convert_wgs84_to_utm(GEOCoordinates wgs84)
+{
+    return loc_geometry_convert_wgs84_to_utm_with_precision(wgs84, loc_geometry_get_precision());
+}
+
+UTMCoordinates loc_geometry_convert_wgs84_to_utm_with_precision(GEOCoordinates wgs84, GEOMETRY_PRECISION precision)
 {
     UTMCoordinates utmCoordinates;
     UTM_HEMISPHERE hemisphere;
@@ -136,7 +757,10 @@ UTMCoordinates loc_geometry_convert_wgs84_to_utm(GEOCoordinates wgs84)
     wgs84.latitude = loc_geometry_degrees_to_radians(wgs84.latitude);
     wgs84.longitude = loc_geometry_degrees_to_radians(wgs84.longitude);
 
-    utmCoordinates = wgs84_to_tm(wgs84, cmeridian);
+    if (precision == GEOMETRY_PRECISION_FAST)
+        utmCoordinates = wgs84_to_tm_fast(wgs84, cmeridian);
+    else
+        utmCoordinates = wgs84_to_tm(wgs84, cmeridian);
 
     x = utmCoordinates.easting * utm_scale_factor + 500000.0;
     y = utmCoordinates.northing * utm_scale_factor;
@@ -153,6 +777,11 @@ UTMCoordinates loc_geometry_convert_wgs84_to_utm(GEOCoordinates wgs84)
 }
 
 GEOCoordinates loc_geometry_convert_utm_to_wgs84(UTMCoordinates utm)
+{
+    return loc_geometry_convert_utm_to_wgs84_with_precision(utm, loc_geometry_get_precision());
+}
+
+GEOCoordinates loc_geometry_convert_utm_to_wgs84_with_precision(UTMCoordinates utm, GEOMETRY_PRECISION precision)
 {
     GEOCoordinates geoCoordinates;
     UTM_HEMISPHERE hemisphere;
@@ -178,7 +807,10 @@ GEOCoordinates loc_geometry_convert_utm_to_wgs84(UTMCoordinates utm)
 
     cmeridian = loc_geometry_degrees_to_radians(-183.0 + (zone * 6.0));
 
-    geoCoordinates = tm_to_wgs84(utm, cmeridian);
+    if (precision == GEOMETRY_PRECISION_FAST)
+        geoCoordinates = tm_to_wgs84_fast(utm, cmeridian);
+    else
+        geoCoordinates = tm_to_wgs84(utm, cmeridian);
 
     geoCoordinates.latitude = loc_geometry_radians_to_degrees(geoCoordinates.latitude);
     geoCoordinates.longitude = loc_geometry_radians_to_degrees(geoCoordinates.longitude);
@@ -186,436 +818,3373 @@ GEOCoordinates loc_geometry_convert_utm_to_wgs84(UTMCoordinates utm)
     return geoCoordinates;
 }
 
-double loc_geometry_calculate_cep(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
+void loc_geometry_convert_wgs84_to_utm_batch(const GEOCoordinates *wgs84, UTMCoordinates *utm, int size)
 {
-    UTMCoordinates utmRef, utmMeasured;
-    double result;
-    double sigmaX, sigmaY;
-    int i;
+    int i = 0;
 
-    if (!measures || size <= 0)
-        return 0;
+    if (!wgs84 || !utm)
+        return;
 
-    result = sigmaX = sigmaY = 0;
+#if defined(SIMD_LANES)
+    if (loc_geometry_get_precision() == GEOMETRY_PRECISION_FAST)
+        i = wgs84_to_utm_lanes(wgs84, utm, size);
+#endif
 
-    if (ref_position) {
-        utmRef = loc_geometry_convert_wgs84_to_utm(*ref_position);
-    } else {
-        utmRef = get_avg_utm(measures, size);
-    }
+    for (; i < size; i++)
+        utm[i] = loc_geometry_convert_wgs84_to_utm(wgs84[i]);
+}
 
-    for (i=0; i<size; i++) {
-        utmMeasured = loc_geometry_convert_wgs84_to_utm(measures[i]);
+void loc_geometry_convert_utm_to_wgs84_batch(const UTMCoordinates *utm, GEOCoordinates *wgs84, int size)
+{
+    int i = 0;
 
-        sigmaX += pow((utmMeasured.easting - utmRef.easting), 2.0);
-        sigmaY += pow((utmMeasured.northing - utmRef.northing), 2.0);
-    }
+    if (!utm || !wgs84)
+        return;
 
-    sigmaX = sqrt(sigmaX / (double)size);
-    sigmaY = sqrt(sigmaY / (double)size);
+#if defined(SIMD_LANES)
+    if (loc_geometry_get_precision() == GEOMETRY_PRECISION_FAST)
+        i = utm_to_wgs84_lanes(utm, wgs84, size);
+#endif
 
-    result = (0.56 * sigmaX) + (0.62 * sigmaY);
+    for (; i < size; i++)
+        wgs84[i] = loc_geometry_convert_utm_to_wgs84(utm[i]);
+}
 
-    return result;
+ECEFCoordinates loc_geometry_convert_wgs84_to_ecef(GEOCoordinates wgs84, double height)
+{
+    ECEFCoordinates ecef;
+
+    geodetic_to_ecef(wgs84.latitude, wgs84.longitude, height, loc_geometry_get_precision(), &ecef);
+
+    return ecef;
 }
 
-double loc_geometry_calculate_drms(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
+GEOCoordinates loc_geometry_convert_ecef_to_wgs84(ECEFCoordinates ecef, double *height)
 {
-    UTMCoordinates utmRef, utmMeasured;
-    double result;
-    double sigmaX, sigmaY;
-    int i;
+    GEOCoordinates geoCoordinates;
+    double h;
 
-    if (!measures || size <= 0)
-        return 0;
+    ecef_to_geodetic(ecef.x, ecef.y, ecef.z, loc_geometry_get_precision(),
+                     &geoCoordinates.latitude, &geoCoordinates.longitude, &h);
 
-    result = sigmaX = sigmaY = 0;
+    geoCoordinates.latitude = loc_geometry_radians_to_degrees(geoCoordinates.latitude);
+    geoCoordinates.longitude = loc_geometry_radians_to_degrees(geoCoordinates.longitude);
 
-    if (ref_position) {
-        utmRef = loc_geometry_convert_wgs84_to_utm(*ref_position);
-    } else {
-        utmRef = get_avg_utm(measures, size);
-    }
+    if (height)
+        *height = h;
 
-    for (i=0; i<size; i++) {
-        utmMeasured = loc_geometry_convert_wgs84_to_utm(measures[i]);
+    return geoCoordinates;
+}
 
-        sigmaX += pow((utmMeasured.easting - utmRef.easting), 2.0);
-        sigmaY += pow((utmMeasured.northing - utmRef.northing), 2.0);
-    }
+void loc_geometry_convert_wgs84_to_ecef_batch(const GEOCoordinates *wgs84, const double *heights,
+                                              ECEFCoordinates *ecef, int size)
+{
+    GEOMETRY_PRECISION precision = loc_geometry_get_precision();
+    int i = 0;
 
-    sigmaX = sigmaX / (double)size;
-    sigmaY = sigmaY / (double)size;
+    if (!wgs84 || !ecef)
+        return;
 
-    result = sqrt(sigmaX + sigmaY);
+#if defined(SIMD_LANES)
+    if (precision == GEOMETRY_PRECISION_FAST)
+        i = geodetic_to_ecef_lanes(wgs84, heights, ecef, size);
+#endif
 
-    return result;
+    for (; i < size; i++)
+        geodetic_to_ecef(wgs84[i].latitude, wgs84[i].longitude, heights ? heights[i] : 0, precision, &ecef[i]);
 }
 
-double loc_geometry_calculate_2drms(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
+void loc_geometry_convert_ecef_to_wgs84_batch(const ECEFCoordinates *ecef, GEOCoordinates *wgs84,
+                                              double *heights, int size)
 {
-    double result;
+    GEOMETRY_PRECISION precision = loc_geometry_get_precision();
+    double phi, lambda, h;
+    int i = 0;
+
+    if (!ecef || !wgs84)
+        return;
 
-    result = 2.0 * loc_geometry_calculate_drms(measures, size, ref_position);
+#if defined(SIMD_LANES)
+    i = ecef_to_geodetic_lanes(ecef, wgs84, heights, size, precision);
+#endif
 
-    return result;
+    for (; i < size; i++) {
+        ecef_to_geodetic(ecef[i].x, ecef[i].y, ecef[i].z, precision, &phi, &lambda, &h);
+        wgs84[i].latitude = loc_geometry_radians_to_degrees(phi);
+        wgs84[i].longitude = loc_geometry_radians_to_degrees(lambda);
+
+        if (heights)
+            heights[i] = h;
+    }
 }
 
-double loc_geometry_calculate_r95(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
+void loc_geometry_set_precision(GEOMETRY_PRECISION precision)
 {
-    double result;
-
-    result = 2.08 * loc_geometry_calculate_cep(measures, size, ref_position);
+    g_atomic_int_set(&geometry_precision, precision);
+}
 
-    return result;
+GEOMETRY_PRECISION loc_geometry_get_precision(void)
+{
+    return (GEOMETRY_PRECISION)g_atomic_int_get(&geometry_precision);
 }
 
-RTCEPCalculator* loc_geometry_rtcep_create(GEOCoordinates *ref_position)
+LocalProjection* loc_geometry_local_create(GEOCoordinates *origin)
 {
-    RTCEPCalculator *rtcep = NULL;
+    LocalProjection *proj = NULL;
 
-    if (!ref_position)
+    if (!origin)
         return NULL;
 
-    rtcep = (RTCEPCalculator *)malloc(sizeof(RTCEPCalculator));
-    if (rtcep) {
-        memset(rtcep, 0, sizeof(RTCEPCalculator));
-        memcpy(&(rtcep->ref_geo_pos), ref_position, sizeof(GEOCoordinates));
-        rtcep->ref_utm_pos = loc_geometry_convert_wgs84_to_utm(*ref_position);
-    }
+    proj = (LocalProjection *)malloc(sizeof(LocalProjection));
+    if (proj)
+        local_init(proj, origin);
 
-    return rtcep;
+    return proj;
 }
 
-void loc_geometry_rtcep_destroy(RTCEPCalculator **rtcep_ref)
+void loc_geometry_local_destroy(LocalProjection **proj_ref)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    LocalProjection *proj = *proj_ref;
 
-    if (!rtcep)
+    if (!proj)
         return;
 
-    free(rtcep);
-    rtcep = NULL;
+    free(proj);
+    *proj_ref = NULL;
 }
 
-void loc_geometry_rtcep_reset(RTCEPCalculator **rtcep_ref)
+GEOCoordinates* loc_geometry_local_get_origin(LocalProjection **proj_ref)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    LocalProjection *proj = *proj_ref;
 
-    if (!rtcep)
+    if (!proj)
+        return NULL;
+
+    return &(proj->origin);
+}
+
+void loc_geometry_local_project(LocalProjection **proj_ref, GEOCoordinates *position, double *east, double *north)
+{
+    LocalProjection *proj = *proj_ref;
+
+    if (!proj || !position || !east || !north)
         return;
 
-    rtcep->lamda_x = 0;
-    rtcep->lamda_y = 0;
-    rtcep->count = 0;
+    local_project(proj, position, east, north);
 }
 
-void loc_geometry_rtcep_set_max_count(RTCEPCalculator **rtcep_ref, int max_count)
+void loc_geometry_local_project_soa(LocalProjection **proj_ref, const double *latitudes, const double *longitudes,
+                                    double *east, double *north, int size)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    LocalProjection *proj = *proj_ref;
+    GEOCoordinates position;
+    int i;
 
-    if (!rtcep)
+    if (!proj || !latitudes || !longitudes || !east || !north)
         return;
 
-    rtcep->max_count = max_count;
+    for (i = 0; i < size; i++) {
+        position.latitude = latitudes[i];
+        position.longitude = longitudes[i];
+        local_project(proj, &position, &east[i], &north[i]);
+    }
 }
 
-void loc_geometry_rtcep_update(RTCEPCalculator **rtcep_ref, GEOCoordinates *measured_position)
+// Both rotate by the origin latitude and longitude, with the same matrix for every position:
+// its sines and cosines and the origin's offset are taken from the projection, so each position
+// costs a few multiply-adds and no trigonometry.
+void loc_geometry_local_ecef_to_enu(LocalProjection **proj_ref, const ECEFCoordinates *ecef, ENUCoordinates *enu,
+                                    int size)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
-    UTMCoordinates utmMeasured;
+    LocalProjection *proj = *proj_ref;
+    double x0, y0, z0, dx, dy, dz, t;
+    int i = 0;
 
-    if (!rtcep)
+    if (!proj || !ecef || !enu)
         return;
 
-    if (!measured_position)
+    x0 = proj->ecef_x * proj->cos_lon;
+    y0 = proj->ecef_x * proj->sin_lon;
+    z0 = proj->ecef_z;
+
+#if defined(SIMD_LANES)
+    i = ecef_to_enu_lanes(proj, ecef, enu, size);
+#endif
+
+    for (; i < size; i++) {
+        dx = ecef[i].x - x0;
+        dy = ecef[i].y - y0;
+        dz = ecef[i].z - z0;
+
+        // toward the origin meridian
+        t = proj->cos_lon * dx + proj->sin_lon * dy;
+        enu[i].east = proj->cos_lon * dy - proj->sin_lon * dx;
+        enu[i].north = proj->cos_lat * dz - proj->sin_lat * t;
+        enu[i].up = proj->cos_lat * t + proj->sin_lat * dz;
+    }
+}
+
+void loc_geometry_local_enu_to_ecef(LocalProjection **proj_ref, const ENUCoordinates *enu, ECEFCoordinates *ecef,
+                                    int size)
+{
+    LocalProjection *proj = *proj_ref;
+    double x0, y0, z0, t;
+    int i = 0;
+
+    if (!proj || !enu || !ecef)
         return;
 
-    if (rtcep->max_count > 0 && rtcep->count >= rtcep->max_count)
+    x0 = proj->ecef_x * proj->cos_lon;
+    y0 = proj->ecef_x * proj->sin_lon;
+    z0 = proj->ecef_z;
+
+#if defined(SIMD_LANES)
+    i = enu_to_ecef_lanes(proj, enu, ecef, size);
+#endif
+
+    for (; i < size; i++) {
+        t = proj->cos_lat * enu[i].up - proj->sin_lat * enu[i].north;
+        ecef[i].x = x0 + proj->cos_lon * t - proj->sin_lon * enu[i].east;
+        ecef[i].y = y0 + proj->sin_lon * t + proj->cos_lon * enu[i].east;
+        ecef[i].z = z0 + proj->sin_lat * enu[i].up + proj->cos_lat * enu[i].north;
+    }
+}
+
+void loc_geometry_pack_e7(const GEOCoordinates *wgs84, GEOCoordinatesE7 *packed, int size)
+{
+    double latitude, longitude;
+    int i;
+
+    if (!wgs84 || !packed)
         return;
 
-    utmMeasured = loc_geometry_convert_wgs84_to_utm(*measured_position);
+    // half away from zero as round() does, with copysign() and the truncating conversion inlined
+    // instead of a call per coordinate; out of range values are not clamped
+    for (i = 0; i < size; i++) {
+        latitude = wgs84[i].latitude * COMPACT_E7_SCALE;
+        longitude = wgs84[i].longitude * COMPACT_E7_SCALE;
+        packed[i].latitude = (int32_t)(latitude + copysign(0.5, latitude));
+        packed[i].longitude = (int32_t)(longitude + copysign(0.5, longitude));
+    }
+}
+
+void loc_geometry_unpack_e7(const GEOCoordinatesE7 *packed, GEOCoordinates *wgs84, int size)
+{
+    int i;
 
-    rtcep->lamda_x += pow((utmMeasured.easting - rtcep->ref_utm_pos.easting), 2.0);
-    rtcep->lamda_y += pow((utmMeasured.northing - rtcep->ref_utm_pos.northing), 2.0);
+    if (!packed || !wgs84)
+        return;
 
-    rtcep->count++;
+    // division rather than multiplication by 1e-7, which is not exact
+    for (i = 0; i < size; i++) {
+        wgs84[i].latitude = packed[i].latitude / COMPACT_E7_SCALE;
+        wgs84[i].longitude = packed[i].longitude / COMPACT_E7_SCALE;
+    }
 }
 
-GEOCoordinates* loc_geometry_rtcep_get_ref_position(RTCEPCalculator **rtcep_ref)
+void loc_geometry_local_pack(LocalProjection **proj_ref, const GEOCoordinates *wgs84, LocalOffset *packed, int size)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    LocalProjection *proj = *proj_ref;
+    double east, north;
+    int i;
 
-    if (!rtcep)
-        return NULL;
+    if (!proj || !wgs84 || !packed)
+        return;
 
-    return &(rtcep->ref_geo_pos);
+    for (i = 0; i < size; i++) {
+        local_project(proj, &wgs84[i], &east, &north);
+        packed[i].east = (float)east;
+        packed[i].north = (float)north;
+    }
 }
 
-int loc_geometry_rtcep_get_max_count(RTCEPCalculator **rtcep_ref)
+void loc_geometry_local_unpack(LocalProjection **proj_ref, const LocalOffset *packed, GEOCoordinates *wgs84, int size)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    LocalProjection *proj = *proj_ref;
+    int i;
 
-    if (!rtcep)
-        return 0;
+    if (!proj || !packed || !wgs84)
+        return;
 
-    return rtcep->max_count;
+    for (i = 0; i < size; i++)
+        local_unproject(proj, packed[i].east, packed[i].north, &wgs84[i]);
 }
 
-int loc_geometry_rtcep_get_current_count(RTCEPCalculator **rtcep_ref)
+double loc_geometry_calculate_cep(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
 {
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    return loc_geometry_calculate_cep_with_projection(measures, size, ref_position, STATS_PROJECTION_UTM);
+}
 
-    if (!rtcep)
-        return 0;
+double loc_geometry_calculate_drms(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
+{
+    return loc_geometry_calculate_drms_with_projection(measures, size, ref_position, STATS_PROJECTION_UTM);
+}
 
-    return rtcep->count;
+double loc_geometry_calculate_2drms(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
+{
+    return loc_geometry_calculate_2drms_with_projection(measures, size, ref_position, STATS_PROJECTION_UTM);
 }
 
-double loc_geometry_rtcep_get_cep(RTCEPCalculator **rtcep_ref)
+double loc_geometry_calculate_r95(GEOCoordinates *measures, int size, GEOCoordinates *ref_position)
 {
-    double sigma_x, sigma_y, result;
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    return loc_geometry_calculate_r95_with_projection(measures, size, ref_position, STATS_PROJECTION_UTM);
+}
 
-    if (!rtcep)
+double loc_geometry_calculate_cep_with_projection(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                                                  STATS_PROJECTION projection)
+{
+    double result;
+    double sigmaX, sigmaY;
+
+    if (!measures || size <= 0)
         return 0;
 
-    sigma_x = sqrt(rtcep->lamda_x / (double)rtcep->count);
-    sigma_y = sqrt(rtcep->lamda_y / (double)rtcep->count);
+    calc_sum_of_squares(measures, size, ref_position, projection, &sigmaX, &sigmaY);
 
-    result = (0.56 * sigma_x) + (0.62 * sigma_y);
+    sigmaX = sqrt(sigmaX / (double)size);
+    sigmaY = sqrt(sigmaY / (double)size);
+
+    result = (0.56 * sigmaX) + (0.62 * sigmaY);
 
     return result;
 }
 
-double loc_geometry_rtcep_get_drms(RTCEPCalculator **rtcep_ref)
+double loc_geometry_calculate_drms_with_projection(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                                                   STATS_PROJECTION projection)
 {
-    double sigma_x, sigma_y, result;
-    RTCEPCalculator *rtcep = *rtcep_ref;
+    double result;
+    double sigmaX, sigmaY;
 
-    if (!rtcep)
+    if (!measures || size <= 0)
         return 0;
 
-    sigma_x = rtcep->lamda_x / (double)rtcep->count;
-    sigma_y = rtcep->lamda_y / (double)rtcep->count;
+    calc_sum_of_squares(measures, size, ref_position, projection, &sigmaX, &sigmaY);
 
-    result = sqrt(sigma_x + sigma_y);
+    sigmaX = sigmaX / (double)size;
+    sigmaY = sigmaY / (double)size;
+
+    result = sqrt(sigmaX + sigmaY);
 
     return result;
 }
 
-double loc_geometry_rtcep_get_2drms(RTCEPCalculator **rtcep_ref)
+double loc_geometry_calculate_2drms_with_projection(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                                                    STATS_PROJECTION projection)
 {
     double result;
 
-    result = 2.0 * loc_geometry_rtcep_get_drms(rtcep_ref);
+    result = 2.0 * loc_geometry_calculate_drms_with_projection(measures, size, ref_position, projection);
 
     return result;
 }
 
-double loc_geometry_rtcep_get_r95(RTCEPCalculator **rtcep_ref)
+double loc_geometry_calculate_r95_with_projection(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                                                  STATS_PROJECTION projection)
 {
     double result;
 
-    result = 2.08 * loc_geometry_rtcep_get_cep(rtcep_ref);
+    result = 2.08 * loc_geometry_calculate_cep_with_projection(measures, size, ref_position, projection);
 
     return result;
 }
 
-double arc_length_of_meridian(double latitudeInRadians)
+void loc_geometry_calculate_statistics(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                                       STATS_PROJECTION projection, ErrorStatistics *stats)
 {
-    double alpha;
-    double beta;
-    double gamma;
-    double delta;
-    double epsilon;
-    double n;
-    double result;
+    StatsJob job;
+    StatsWorker workers[STATS_MAX_THREADS];
+    GThread *threads[STATS_MAX_THREADS];
+    StatsAccumulator total;
+    GEOCoordinates origin;
+    int i;
 
-    double equitorialRadus = WGS84_EQUITORIAL_RADIUS;
-    double polarRadius = WGS84_POLAR_RADIUS;
+    if (!stats)
+        return;
 
-    n = (equitorialRadus - polarRadius) / (equitorialRadus + polarRadius);
+    memset(stats, 0, sizeof(ErrorStatistics));
 
-    alpha = ((equitorialRadus + polarRadius) / 2.0) * (1.0 + (pow(n, 2.0) / 4.0) + (pow(n, 4.0) / 64.0));
+    if (!measures || size <= 0)
+        return;
 
-    beta = (-3.0 * n / 2.0) + (9.0 * pow(n, 3.0) / 16.0) + (-3.0 * pow(n, 5.0) / 32.0);
+    // without a known position, offsets are taken from the first measure and then from their mean
+    origin = ref_position ? *ref_position : measures[0];
+
+    memset(&job, 0, sizeof(StatsJob));
+    job.measures = measures;
+    job.size = size;
+    job.projection = projection;
+    if (projection == STATS_PROJECTION_LOCAL)
+        local_init(&job.local_origin, &origin);
+    else
+        job.utm_origin = loc_geometry_convert_wgs84_to_utm(origin);
+
+    job.num_chunks = (size + STATS_CHUNK_SIZE - 1) / STATS_CHUNK_SIZE;
+    job.chunks = (StatsAccumulator *)calloc(job.num_chunks, sizeof(StatsAccumulator));
+    if (!job.chunks)
+        return;
 
-    gamma = (15.0 * pow(n, 2.0) / 16.0) + (-15.0 * pow(n, 4.0) / 32.0);
+    job.num_threads = MIN(MIN((int)g_get_num_processors(), STATS_MAX_THREADS), job.num_chunks);
 
-    delta = (-35.0 * pow(n, 3.0) / 48.0) + (105.0 * pow(n, 5.0) / 256.0);
+    // worker 0 runs on the calling thread, and so do the chunks of any thread that fails to start
+    for (i = 1; i < job.num_threads; i++) {
+        workers[i].job = &job;
+        workers[i].first_chunk = i;
+        threads[i] = g_thread_try_new("loc_geometry_stats", stats_run_worker, &workers[i], NULL);
+    }
 
-    epsilon = (315.0 * pow(n, 4.0) / 512.0);
+    workers[0].job = &job;
+    workers[0].first_chunk = 0;
+    stats_run_worker(&workers[0]);
 
-    result = alpha * (latitudeInRadians +
-                      (beta * sin(2.0 * latitudeInRadians)) +
-                      (gamma * sin(4.0 * latitudeInRadians)) +
-                      (delta * sin(6.0 * latitudeInRadians)) +
-                      (epsilon * sin(8.0 * latitudeInRadians)));
+    for (i = 1; i < job.num_threads; i++) {
+        if (threads[i])
+            g_thread_join(threads[i]);
+        else
+            stats_run_worker(&workers[i]);
+    }
 
-    return result;
+    // merged in chunk order whatever thread computed them
+    memset(&total, 0, sizeof(StatsAccumulator));
+    for (i = 0; i < job.num_chunks; i++)
+        stats_merge(&total, &job.chunks[i]);
+
+    free(job.chunks);
+
+    stats->count = total.count;
+    stats->std_east = sqrt(total.m2_x / total.count);
+    stats->std_north = sqrt(total.m2_y / total.count);
+
+    if (ref_position) {
+        stats->mean_east = total.mean_x;
+        stats->mean_north = total.mean_y;
+    }
+
+    stats->sigma_east = sqrt(stats->std_east * stats->std_east + stats->mean_east * stats->mean_east);
+    stats->sigma_north = sqrt(stats->std_north * stats->std_north + stats->mean_north * stats->mean_north);
+
+    stats->cep = (0.56 * stats->sigma_east) + (0.62 * stats->sigma_north);
+    stats->drms = sqrt(stats->sigma_east * stats->sigma_east + stats->sigma_north * stats->sigma_north);
+    stats->twice_drms = 2.0 * stats->drms;
+    stats->r95 = 2.08 * stats->cep;
+}
+
+RTCEPCalculator* loc_geometry_rtcep_create(GEOCoordinates *ref_position)
+{
+    RTCEPCalculator *rtcep = NULL;
+
+    if (!ref_position)
+        return NULL;
+
+    rtcep = (RTCEPCalculator *)malloc(sizeof(RTCEPCalculator));
+    if (rtcep) {
+        memset(rtcep, 0, sizeof(RTCEPCalculator));
+        memcpy(&(rtcep->ref_geo_pos), ref_position, sizeof(GEOCoordinates));
+        rtcep->ref_utm_pos = loc_geometry_convert_wgs84_to_utm(*ref_position);
+        local_init(&(rtcep->ref_local), ref_position);
+        quantile_init(&(rtcep->sketch_cep), 0.50);
+        quantile_init(&(rtcep->sketch_r95), 0.95);
+    }
+
+    return rtcep;
 }
 
-double footpoint_latitude(double northingInMeters)
+void loc_geometry_rtcep_destroy(RTCEPCalculator **rtcep_ref)
 {
-    double y;
-    double alpha;
-    double beta;
-    double gamma;
-    double delta;
-    double epsilon;
-    double n;
-    double footprintLatitudeInRadians;
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (!rtcep)
+        return;
 
-    double equitorialRadus = WGS84_EQUITORIAL_RADIUS;
-    double polarRadius = WGS84_POLAR_RADIUS;
+    free(rtcep->window);
+    free(rtcep->window_radii);
+    free(rtcep);
+    rtcep = NULL;
+}
 
-    n = (equitorialRadus - polarRadius) / (equitorialRadus + polarRadius);
+void loc_geometry_rtcep_reset(RTCEPCalculator **rtcep_ref)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
 
-    alpha = ((equitorialRadus + polarRadius) / 2.0) * (1 + (pow(n, 2.0) / 4) + (pow(n, 4.0) / 64));
+    if (!rtcep)
+        return;
 
-    y = northingInMeters / alpha;
+    rtcep->lamda_x = 0;
+    rtcep->lamda_y = 0;
+    rtcep->count = 0;
+    rtcep->window_head = 0;
+    rtcep->window_updates = 0;
+    quantile_init(&(rtcep->sketch_cep), 0.50);
+    quantile_init(&(rtcep->sketch_r95), 0.95);
+}
 
-    beta = (3.0 * n / 2.0) + (-27.0 * pow(n, 3.0) / 32.0) + (269.0 * pow(n, 5.0) / 512.0);
+void loc_geometry_rtcep_set_max_count(RTCEPCalculator **rtcep_ref, int max_count)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
 
-    gamma = (21.0 * pow(n, 2.0) / 16.0) + (-55.0 * pow(n, 4.0) / 32.0);
+    if (!rtcep)
+        return;
 
-    delta = (151.0 * pow(n, 3.0) / 96.0) + (-417.0 * pow(n, 5.0) / 128.0);
+    rtcep->max_count = max_count;
+}
 
-    epsilon = (1097.0 * pow(n, 4.0) / 512.0);
+void loc_geometry_rtcep_set_projection(RTCEPCalculator **rtcep_ref, STATS_PROJECTION projection)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
 
-    footprintLatitudeInRadians = y + (beta * sin(2.0 * y)) + (gamma * sin(4.0 * y)) +
-                                 (delta * sin(6.0 * y)) + (epsilon * sin(8.0 * y));
+    if (!rtcep)
+        return;
 
-    return footprintLatitudeInRadians;
+    rtcep->projection = projection;
 }
 
-UTMCoordinates wgs84_to_tm(GEOCoordinates radCoordinates, double centralMeridian)
+void loc_geometry_rtcep_set_estimate(RTCEPCalculator **rtcep_ref, RTCEP_ESTIMATE estimate)
 {
-    UTMCoordinates tmCoordinates = {0};
+    RTCEPCalculator *rtcep = *rtcep_ref;
 
-    double N, nu2, ep2, t, t2, l;
-    double l3coef, l4coef, l5coef, l6coef, l7coef, l8coef;
+    if (!rtcep)
+        return;
 
-    double phi = radCoordinates.latitude;
-    double lambda = radCoordinates.longitude;
+    // the window holds the measurements whose radii were not kept
+    if (rtcep->window && estimate == RTCEP_ESTIMATE_QUANTILE && rtcep->estimate != RTCEP_ESTIMATE_QUANTILE)
+        rtcep_window_rank(rtcep);
 
-    double equitorialRadus = WGS84_EQUITORIAL_RADIUS;
-    double polarRadius = WGS84_POLAR_RADIUS;
+    rtcep->estimate = estimate;
+}
 
-    ep2 = (pow(equitorialRadus, 2.0) - pow(polarRadius, 2.0)) / pow(polarRadius, 2.0);
+void loc_geometry_rtcep_set_window(RTCEPCalculator **rtcep_ref, int max_fixes, long long max_time_ms)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
+    RTCEPSample *window = NULL;
+    double *radii = NULL;
+    int size = 0;
 
-    nu2 = ep2 * pow(cos(phi), 2.0);
+    if (!rtcep)
+        return;
 
-    N = pow(equitorialRadus, 2.0) / (polarRadius * sqrt(1 + nu2));
+    if (max_fixes < 0)
+        max_fixes = 0;
+
+    if (max_time_ms < 0)
+        max_time_ms = 0;
+
+    if (max_fixes > 0 || max_time_ms > 0) {
+        size = (max_fixes > 0) ? max_fixes : RTCEP_WINDOW_BLOCK;
+        window = (RTCEPSample *)malloc(sizeof(RTCEPSample) * size);
+        radii = (double *)malloc(sizeof(double) * size);
+        if (!window || !radii) {
+            free(window);
+            free(radii);
+            return;
+        }
+    }
 
-    t = tan(phi);
-    t2 = t * t;
+    free(rtcep->window);
+    free(rtcep->window_radii);
+    rtcep->window = window;
+    rtcep->window_radii = radii;
+    rtcep->window_size = size;
+    rtcep->window_fixes = max_fixes;
+    rtcep->window_time = max_time_ms;
 
-    l = lambda - centralMeridian;
+    loc_geometry_rtcep_reset(rtcep_ref);
+}
 
-    l3coef = 1.0 - t2 + nu2;
-    l4coef = 5.0 - t2 + 9 * nu2 + 4.0 * (nu2 * nu2);
-    l5coef = 5.0 - 18.0 * t2 + (t2 * t2) + 14.0 * nu2 - 58.0 * t2 * nu2;
-    l6coef = 61.0 - 58.0 * t2 + (t2 * t2) + 270.0 * nu2 - 330.0 * t2 * nu2;
-    l7coef = 61.0 - 479.0 * t2 + 179.0 * (t2 * t2) - (t2 * t2 * t2);
-    l8coef = 1385.0 - 3111.0 * t2 + 543.0 * (t2 * t2) - (t2 * t2 * t2);
+void loc_geometry_rtcep_update(RTCEPCalculator **rtcep_ref, GEOCoordinates *measured_position)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
 
-    tmCoordinates.easting = N * cos(phi) * l +
-                            (N / 6.0 * pow(cos(phi), 3.0) * l3coef * pow(l, 3.0)) +
-                            (N / 120.0 * pow(cos(phi), 5.0) * l5coef * pow(l, 5.0)) +
-                            (N / 5040.0 * pow(cos(phi), 7.0) * l7coef * pow(l, 7.0));
+    if (!rtcep)
+        return;
 
-    tmCoordinates.northing = arc_length_of_meridian(phi) +
-                             (t / 2.0 * N * pow(cos(phi), 2.0) * pow(l, 2.0)) +
-                             (t / 24.0 * N * pow(cos(phi), 4.0) * l4coef * pow(l, 4.0)) +
-                             (t / 720.0 * N * pow(cos(phi), 6.0) * l6coef * pow(l, 6.0)) +
-                             (t / 40320.0 * N * pow(cos(phi), 8.0) * l8coef * pow(l, 8.0));
+    if (!measured_position)
+        return;
 
-    return tmCoordinates;
+    rtcep_add(rtcep, measured_position, (rtcep->window_time > 0) ? g_get_monotonic_time() / 1000 : 0);
 }
 
-GEOCoordinates tm_to_wgs84(UTMCoordinates tm, double centralMeridian)
+void loc_geometry_rtcep_update_with_time(RTCEPCalculator **rtcep_ref, GEOCoordinates *measured_position,
+                                         long long timestamp_ms)
 {
-    GEOCoordinates coordinates;
-    double phif, Nf, Nfpow, nuf2, ep2, tf, tf2, tf4, cf;
-    double x1frac, x2frac, x3frac, x4frac, x5frac, x6frac, x7frac, x8frac;
-    double x2poly, x3poly, x4poly, x5poly, x6poly, x7poly, x8poly;
+    RTCEPCalculator *rtcep = *rtcep_ref;
 
-    double x = tm.easting;
-    double y = tm.northing;
+    if (!rtcep)
+        return;
 
-    double equitorialRadus = WGS84_EQUITORIAL_RADIUS;
-    double polarRadius = WGS84_POLAR_RADIUS;
+    if (!measured_position)
+        return;
 
-    phif = footpoint_latitude(y);
+    rtcep_add(rtcep, measured_position, timestamp_ms);
+}
 
-    ep2 = (pow(equitorialRadus, 2.0) - pow(polarRadius, 2.0)) / pow(polarRadius, 2.0);
+void loc_geometry_rtcep_update_batch(RTCEPCalculator **rtcep_ref, GEOCoordinates *measured_positions, int size)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
+    long long timestamp;
+    int i;
 
-    cf = cos(phif);
+    if (!rtcep)
+        return;
 
-    nuf2 = ep2 * pow(cf, 2.0);
+    if (!measured_positions)
+        return;
 
-    Nf = pow(equitorialRadus, 2.0) / (polarRadius * sqrt(1 + nuf2));
-    Nfpow = Nf;
+    timestamp = (rtcep->window_time > 0) ? g_get_monotonic_time() / 1000 : 0;
 
-    tf = tan(phif);
-    tf2 = tf * tf;
-    tf4 = tf2 * tf2;
+    for (i = 0; i < size; i++)
+        rtcep_add(rtcep, &measured_positions[i], timestamp);
+}
 
-    x1frac = 1.0 / (Nfpow * cf);
+int loc_geometry_rtcep_merge(RTCEPCalculator **rtcep_ref, RTCEPCalculator **other_ref)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
+    RTCEPCalculator *other = *other_ref;
 
-    Nfpow *= Nf;
-    x2frac = tf / (2.0 * Nfpow);
+    if (!rtcep || !other || rtcep == other)
+        return 0;
 
-    Nfpow *= Nf;
-    x3frac = 1.0 / (6.0 * Nfpow * cf);
+    return rtcep_merge(rtcep, other) ? 1 : 0;
+}
 
-    Nfpow *= Nf;
-    x4frac = tf / (24.0 * Nfpow);
+RTCEPShards* loc_geometry_rtcep_shards_create(RTCEPCalculator **base_ref, int num_shards)
+{
+    RTCEPCalculator *base = *base_ref;
+    RTCEPShards *shards = NULL;
+    int i;
 
-    Nfpow *= Nf;
-    x5frac = 1.0 / (120.0 * Nfpow * cf);
+    if (!base || num_shards <= 0)
+        return NULL;
 
-    Nfpow *= Nf;
-    x6frac = tf / (720.0 * Nfpow);
+    shards = (RTCEPShards *)malloc(sizeof(RTCEPShards));
+    if (!shards)
+        return NULL;
 
-    Nfpow *= Nf;
-    x7frac = 1.0 / (5040.0 * Nfpow * cf);
+    shards->num_shards = num_shards;
+    shards->shards = (RTCEPCalculator **)calloc(num_shards, sizeof(RTCEPCalculator *));
+    shards->locks = (GMutex *)calloc(num_shards, sizeof(GMutex));
+    if (!shards->shards || !shards->locks) {
+        free(shards->shards);
+        free(shards->locks);
+        free(shards);
+        return NULL;
+    }
 
-    Nfpow *= Nf;
-    x8frac = tf / (40320.0 * Nfpow);
+    for (i = 0; i < num_shards; i++) {
+        g_mutex_init(&shards->locks[i]);
+        shards->shards[i] = rtcep_create_like(base);
+        if (!shards->shards[i]) {
+            shards->num_shards = i + 1;
+            loc_geometry_rtcep_shards_destroy(&shards);
+            return NULL;
+        }
+    }
 
-    x2poly = -1.0 - nuf2;
-    x3poly = -1.0 - 2 * tf2 - nuf2;
-    x4poly = 5.0 + 3.0 * tf2 + 6.0 * nuf2 - 6.0 * tf2 * nuf2 - 3.0 * (nuf2 *nuf2) - 9.0 * tf2 * (nuf2 * nuf2);
-    x5poly = 5.0 + 28.0 * tf2 + 24.0 * tf4 + 6.0 * nuf2 + 8.0 * tf2 * nuf2;
-    x6poly = -61.0 - 90.0 * tf2 - 45.0 * tf4 - 107.0 * nuf2 + 162.0 * tf2 * nuf2;
-    x7poly = -61.0 - 662.0 * tf2 - 1320.0 * tf4 - 720.0 * (tf4 * tf2);
-    x8poly = 1385.0 + 3633.0 * tf2 + 4095.0 * tf4 + 1575 * (tf4 * tf2);
+    return shards;
+}
 
-    coordinates.latitude = phif + x2frac * x2poly * (x * x) + x4frac * x4poly * pow(x, 4.0) +
-                           x6frac * x6poly * pow(x, 6.0) + x8frac * x8poly * pow(x, 8.0);
+void loc_geometry_rtcep_shards_destroy(RTCEPShards **shards_ref)
+{
+    RTCEPShards *shards = *shards_ref;
+    int i;
 
-    coordinates.longitude = centralMeridian + x1frac * x + x3frac * x3poly * pow(x, 3.0) +
-                            x5frac * x5poly * pow(x, 5.0) + x7frac * x7poly * pow(x, 7.0);
+    if (!shards)
+        return;
 
-    return coordinates;
+    for (i = 0; i < shards->num_shards; i++) {
+        loc_geometry_rtcep_destroy(&shards->shards[i]);
+        g_mutex_clear(&shards->locks[i]);
+    }
+
+    free(shards->shards);
+    free(shards->locks);
+    free(shards);
+    *shards_ref = NULL;
 }
 
-UTMCoordinates get_avg_utm(GEOCoordinates *measures, int size)
+void loc_geometry_rtcep_shards_update_batch(RTCEPShards **shards_ref, int shard,
+                                            GEOCoordinates *measured_positions, int size)
 {
-    GEOCoordinates avg;
+    RTCEPShards *shards = *shards_ref;
+
+    if (!shards || shard < 0 || shard >= shards->num_shards)
+        return;
+
+    g_mutex_lock(&shards->locks[shard]);
+    loc_geometry_rtcep_update_batch(&shards->shards[shard], measured_positions, size);
+    g_mutex_unlock(&shards->locks[shard]);
+}
+
+RTCEPCalculator* loc_geometry_rtcep_shards_collect(RTCEPShards **shards_ref)
+{
+    RTCEPShards *shards = *shards_ref;
+    RTCEPCalculator *rtcep;
     int i;
 
-    avg.latitude = avg.longitude = 0;
-    for (i=0; i<size; i++) {
-        avg.latitude += measures[i].latitude;
-        avg.longitude += measures[i].longitude;
+    if (!shards)
+        return NULL;
+
+    rtcep = rtcep_create_like(shards->shards[0]);
+    if (!rtcep)
+        return NULL;
+
+    // merged in shard order, so the result does not depend on which thread collects
+    for (i = 0; i < shards->num_shards; i++) {
+        g_mutex_lock(&shards->locks[i]);
+        rtcep_merge(rtcep, shards->shards[i]);
+        g_mutex_unlock(&shards->locks[i]);
     }
 
-    avg.latitude /= (double)size;
-    avg.longitude /= (double)size;
+    return rtcep;
+}
+
+GEOCoordinates* loc_geometry_rtcep_get_ref_position(RTCEPCalculator **rtcep_ref)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (!rtcep)
+        return NULL;
+
+    return &(rtcep->ref_geo_pos);
+}
+
+int loc_geometry_rtcep_get_max_count(RTCEPCalculator **rtcep_ref)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (!rtcep)
+        return 0;
+
+    return rtcep->max_count;
+}
+
+int loc_geometry_rtcep_get_current_count(RTCEPCalculator **rtcep_ref)
+{
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (!rtcep)
+        return 0;
+
+    return rtcep->count;
+}
+
+double loc_geometry_rtcep_get_cep(RTCEPCalculator **rtcep_ref)
+{
+    double sigma_x, sigma_y, result;
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (!rtcep)
+        return 0;
+
+    if (rtcep->estimate == RTCEP_ESTIMATE_QUANTILE) {
+        if (rtcep->window)
+            return rtcep_window_quantile(rtcep, 0.50);
+
+        return quantile_get(&(rtcep->sketch_cep));
+    }
+
+    sigma_x = sqrt(rtcep->lamda_x / (double)rtcep->count);
+    sigma_y = sqrt(rtcep->lamda_y / (double)rtcep->count);
+
+    result = (0.56 * sigma_x) + (0.62 * sigma_y);
+
+    return result;
+}
+
+double loc_geometry_rtcep_get_drms(RTCEPCalculator **rtcep_ref)
+{
+    double sigma_x, sigma_y, result;
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (!rtcep)
+        return 0;
+
+    sigma_x = rtcep->lamda_x / (double)rtcep->count;
+    sigma_y = rtcep->lamda_y / (double)rtcep->count;
+
+    result = sqrt(sigma_x + sigma_y);
+
+    return result;
+}
+
+double loc_geometry_rtcep_get_2drms(RTCEPCalculator **rtcep_ref)
+{
+    double result;
+
+    result = 2.0 * loc_geometry_rtcep_get_drms(rtcep_ref);
+
+    return result;
+}
+
+double loc_geometry_rtcep_get_r95(RTCEPCalculator **rtcep_ref)
+{
+    double result;
+    RTCEPCalculator *rtcep = *rtcep_ref;
+
+    if (rtcep && rtcep->estimate == RTCEP_ESTIMATE_QUANTILE) {
+        if (rtcep->window)
+            return rtcep_window_quantile(rtcep, 0.95);
+
+        return quantile_get(&(rtcep->sketch_r95));
+    }
+
+    result = 2.08 * loc_geometry_rtcep_get_cep(rtcep_ref);
+
+    return result;
+}
+
+RTCEPEngine* loc_geometry_rtcep_engine_create(const GEOCoordinates *ref_positions, int num_refs)
+{
+    RTCEPEngine *engine = NULL;
+    LocalProjection local;
+    UTMCoordinates utm;
+    int i;
+
+    if (!ref_positions || num_refs <= 0)
+        return NULL;
+
+    engine = (RTCEPEngine *)calloc(1, sizeof(RTCEPEngine));
+    if (!engine)
+        return NULL;
+
+    engine->num_refs = num_refs;
+    engine->ref_geo_pos = (GEOCoordinates *)malloc(sizeof(GEOCoordinates) * num_refs);
+    engine->ref_easting = (double *)malloc(sizeof(double) * num_refs);
+    engine->ref_northing = (double *)malloc(sizeof(double) * num_refs);
+    engine->sin_lat = (double *)malloc(sizeof(double) * num_refs);
+    engine->cos_lat = (double *)malloc(sizeof(double) * num_refs);
+    engine->ecef_x = (double *)malloc(sizeof(double) * num_refs);
+    engine->ecef_z = (double *)malloc(sizeof(double) * num_refs);
+    engine->lamda_x = (double *)malloc(sizeof(double) * num_refs);
+    engine->lamda_y = (double *)malloc(sizeof(double) * num_refs);
+    engine->count = (int *)malloc(sizeof(int) * num_refs);
+    engine->sketch_cep = (QuantileSketch *)malloc(sizeof(QuantileSketch) * num_refs);
+    engine->sketch_r95 = (QuantileSketch *)malloc(sizeof(QuantileSketch) * num_refs);
+
+    if (!engine->ref_geo_pos || !engine->ref_easting || !engine->ref_northing ||
+        !engine->sin_lat || !engine->cos_lat || !engine->ecef_x || !engine->ecef_z ||
+        !engine->lamda_x || !engine->lamda_y || !engine->count || !engine->sketch_cep || !engine->sketch_r95) {
+        loc_geometry_rtcep_engine_destroy(&engine);
+        return NULL;
+    }
+
+    for (i = 0; i < num_refs; i++) {
+        engine->ref_geo_pos[i] = ref_positions[i];
+
+        utm = loc_geometry_convert_wgs84_to_utm(ref_positions[i]);
+        engine->ref_easting[i] = utm.easting;
+        engine->ref_northing[i] = utm.northing;
+
+        local_init(&local, &(engine->ref_geo_pos[i]));
+        engine->sin_lat[i] = local.sin_lat;
+        engine->cos_lat[i] = local.cos_lat;
+        engine->ecef_x[i] = local.ecef_x;
+        engine->ecef_z[i] = local.ecef_z;
+    }
+
+    loc_geometry_rtcep_engine_reset(&engine);
+
+    return engine;
+}
+
+void loc_geometry_rtcep_engine_destroy(RTCEPEngine **engine_ref)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    free(engine->ref_geo_pos);
+    free(engine->ref_easting);
+    free(engine->ref_northing);
+    free(engine->sin_lat);
+    free(engine->cos_lat);
+    free(engine->ecef_x);
+    free(engine->ecef_z);
+    free(engine->lamda_x);
+    free(engine->lamda_y);
+    free(engine->count);
+    free(engine->sketch_cep);
+    free(engine->sketch_r95);
+    free(engine);
+    *engine_ref = NULL;
+}
+
+void loc_geometry_rtcep_engine_reset(RTCEPEngine **engine_ref)
+{
+    RTCEPEngine *engine = *engine_ref;
+    int i;
+
+    if (!engine)
+        return;
+
+    memset(engine->lamda_x, 0, sizeof(double) * engine->num_refs);
+    memset(engine->lamda_y, 0, sizeof(double) * engine->num_refs);
+    memset(engine->count, 0, sizeof(int) * engine->num_refs);
+
+    for (i = 0; i < engine->num_refs; i++) {
+        quantile_init(&(engine->sketch_cep[i]), 0.50);
+        quantile_init(&(engine->sketch_r95[i]), 0.95);
+    }
+}
+
+void loc_geometry_rtcep_engine_set_max_count(RTCEPEngine **engine_ref, int max_count)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    engine->max_count = max_count;
+}
+
+void loc_geometry_rtcep_engine_set_projection(RTCEPEngine **engine_ref, STATS_PROJECTION projection)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    engine->projection = projection;
+}
+
+void loc_geometry_rtcep_engine_set_estimate(RTCEPEngine **engine_ref, RTCEP_ESTIMATE estimate)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine)
+        return;
+
+    engine->estimate = estimate;
+}
+
+// Positions are projected a block at a time, then accumulated in order, as fixes of one
+// reference may appear more than once in a block.
+void loc_geometry_rtcep_engine_update_batch(RTCEPEngine **engine_ref, const int *ref_indexes,
+                                            const GEOCoordinates *measured_positions, int size)
+{
+    RTCEPEngine *engine = *engine_ref;
+    double east[RTCEP_ENGINE_BLOCK], north[RTCEP_ENGINE_BLOCK];
+    int i, j, n;
+
+    if (!engine)
+        return;
+
+    if (!ref_indexes || !measured_positions)
+        return;
+
+    for (i = 0; i < size; i += RTCEP_ENGINE_BLOCK) {
+        n = (size - i < RTCEP_ENGINE_BLOCK) ? size - i : RTCEP_ENGINE_BLOCK;
+        rtcep_engine_project(engine, &ref_indexes[i], &measured_positions[i], n, east, north);
+
+        for (j = 0; j < n; j++)
+            rtcep_engine_add(engine, ref_indexes[i + j], east[j], north[j]);
+    }
+}
+
+int loc_geometry_rtcep_engine_get_size(RTCEPEngine **engine_ref)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine)
+        return 0;
+
+    return engine->num_refs;
+}
+
+GEOCoordinates* loc_geometry_rtcep_engine_get_ref_position(RTCEPEngine **engine_ref, int ref_index)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine || ref_index < 0 || ref_index >= engine->num_refs)
+        return NULL;
+
+    return &(engine->ref_geo_pos[ref_index]);
+}
+
+int loc_geometry_rtcep_engine_get_max_count(RTCEPEngine **engine_ref)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine)
+        return 0;
+
+    return engine->max_count;
+}
+
+int loc_geometry_rtcep_engine_get_current_count(RTCEPEngine **engine_ref, int ref_index)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine || ref_index < 0 || ref_index >= engine->num_refs)
+        return 0;
+
+    return engine->count[ref_index];
+}
+
+double loc_geometry_rtcep_engine_get_cep(RTCEPEngine **engine_ref, int ref_index)
+{
+    double sigma_x, sigma_y;
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine || ref_index < 0 || ref_index >= engine->num_refs)
+        return 0;
+
+    if (engine->estimate == RTCEP_ESTIMATE_QUANTILE)
+        return quantile_get(&(engine->sketch_cep[ref_index]));
+
+    sigma_x = sqrt(engine->lamda_x[ref_index] / (double)engine->count[ref_index]);
+    sigma_y = sqrt(engine->lamda_y[ref_index] / (double)engine->count[ref_index]);
+
+    return (0.56 * sigma_x) + (0.62 * sigma_y);
+}
+
+double loc_geometry_rtcep_engine_get_drms(RTCEPEngine **engine_ref, int ref_index)
+{
+    double sigma_x, sigma_y;
+    RTCEPEngine *engine = *engine_ref;
+
+    if (!engine || ref_index < 0 || ref_index >= engine->num_refs)
+        return 0;
+
+    sigma_x = engine->lamda_x[ref_index] / (double)engine->count[ref_index];
+    sigma_y = engine->lamda_y[ref_index] / (double)engine->count[ref_index];
+
+    return sqrt(sigma_x + sigma_y);
+}
+
+double loc_geometry_rtcep_engine_get_2drms(RTCEPEngine **engine_ref, int ref_index)
+{
+    return 2.0 * loc_geometry_rtcep_engine_get_drms(engine_ref, ref_index);
+}
+
+double loc_geometry_rtcep_engine_get_r95(RTCEPEngine **engine_ref, int ref_index)
+{
+    RTCEPEngine *engine = *engine_ref;
+
+    if (engine && ref_index >= 0 && ref_index < engine->num_refs && engine->estimate == RTCEP_ESTIMATE_QUANTILE)
+        return quantile_get(&(engine->sketch_r95[ref_index]));
+
+    return 2.08 * loc_geometry_rtcep_engine_get_cep(engine_ref, ref_index);
+}
+
+TrajectorySimplifier* loc_geometry_simplifier_create(double tolerance, int max_points)
+{
+    TrajectorySimplifier *simplifier = NULL;
+
+    if (tolerance < 0 || max_points < 0)
+        return NULL;
+
+    if (max_points == 0)
+        max_points = SIMPLIFIER_DEFAULT_POINTS;
+
+    simplifier = (TrajectorySimplifier *)calloc(1, sizeof(TrajectorySimplifier));
+    if (!simplifier)
+        return NULL;
+
+    simplifier->east = (double *)malloc(sizeof(double) * max_points);
+    simplifier->north = (double *)malloc(sizeof(double) * max_points);
+    if (!simplifier->east || !simplifier->north) {
+        free(simplifier->east);
+        free(simplifier->north);
+        free(simplifier);
+        return NULL;
+    }
+
+    simplifier->tolerance = tolerance;
+    simplifier->max_points = max_points;
+
+    return simplifier;
+}
+
+void loc_geometry_simplifier_destroy(TrajectorySimplifier **simplifier_ref)
+{
+    TrajectorySimplifier *simplifier = *simplifier_ref;
+
+    if (!simplifier)
+        return;
+
+    free(simplifier->east);
+    free(simplifier->north);
+    free(simplifier);
+    *simplifier_ref = NULL;
+}
+
+int loc_geometry_simplifier_add(TrajectorySimplifier **simplifier_ref, GEOCoordinates *position,
+                                GEOCoordinates *kept_position)
+{
+    TrajectorySimplifier *simplifier = *simplifier_ref;
+    double east, north;
+    gboolean within = TRUE;
+    int i;
+
+    if (!simplifier || !position)
+        return 0;
+
+    if (!simplifier->started) {
+        local_init(&(simplifier->anchor), position);
+        simplifier->started = TRUE;
+        simplifier->count = 0;
+
+        if (kept_position)
+            *kept_position = *position;
+
+        return 1;
+    }
+
+    local_project(&(simplifier->anchor), position, &east, &north);
+
+    if (simplifier->count < simplifier->max_points) {
+        for (i = 0; i < simplifier->count; i++) {
+            if (segment_distance(simplifier->east[i], simplifier->north[i], east, north) > simplifier->tolerance) {
+                within = FALSE;
+                break;
+            }
+        }
+
+        if (within) {
+            simplifier->east[simplifier->count] = east;
+            simplifier->north[simplifier->count] = north;
+            simplifier->count++;
+            simplifier->last = *position;
+            return 0;
+        }
+    }
+
+    // keep the point before, the corridor starts again from it
+    if (kept_position)
+        *kept_position = simplifier->last;
+
+    local_init(&(simplifier->anchor), &(simplifier->last));
+    local_project(&(simplifier->anchor), position, &(simplifier->east[0]), &(simplifier->north[0]));
+    simplifier->count = 1;
+    simplifier->last = *position;
+
+    return 1;
+}
+
+int loc_geometry_simplifier_flush(TrajectorySimplifier **simplifier_ref, GEOCoordinates *kept_position)
+{
+    TrajectorySimplifier *simplifier = *simplifier_ref;
+
+    if (!simplifier || simplifier->count == 0)
+        return 0;
+
+    if (kept_position)
+        *kept_position = simplifier->last;
+
+    local_init(&(simplifier->anchor), &(simplifier->last));
+    simplifier->count = 0;
+
+    return 1;
+}
+
+void loc_geometry_simplifier_reset(TrajectorySimplifier **simplifier_ref)
+{
+    TrajectorySimplifier *simplifier = *simplifier_ref;
+
+    if (!simplifier)
+        return;
+
+    simplifier->started = FALSE;
+    simplifier->count = 0;
+}
+
+int loc_geometry_cluster_dbscan(const GEOCoordinates *positions, int size, double eps, int min_points, int *labels)
+{
+    ClusterGrid grid;
+    int *neighbors, *queue;
+    int i, count, clusters = 0;
+
+    if (!positions || !labels || size <= 0 || !(eps > 0))
+        return -1;
+
+    if (!cluster_grid_init(&grid, positions, size, eps))
+        return -1;
+
+    neighbors = (int *)malloc(sizeof(int) * size);
+    queue = (int *)malloc(sizeof(int) * size);
+    if (!neighbors || !queue) {
+        free(neighbors);
+        free(queue);
+        cluster_grid_free(&grid);
+        return -1;
+    }
+
+    for (i = 0; i < size; i++)
+        labels[i] = CLUSTER_UNVISITED;
+
+    for (i = 0; i < size; i++) {
+        if (labels[i] != CLUSTER_UNVISITED)
+            continue;
+
+        count = cluster_grid_query(&grid, i, neighbors);
+        if (count < min_points) {
+            labels[i] = CLUSTER_NOISE;
+            continue;
+        }
+
+        labels[i] = clusters;
+        cluster_expand(&grid, min_points, clusters, labels, neighbors, queue, count);
+        clusters++;
+    }
+
+    free(neighbors);
+    free(queue);
+    cluster_grid_free(&grid);
+
+    return clusters;
+}
+
+void loc_geometry_cluster_centroids(const GEOCoordinates *positions, const int *labels, int size,
+                                    int num_clusters, GEOCoordinates *centroids, int *counts)
+{
+    LocalProjection proj;
+    GEOCoordinates origin;
+    double *east, *north;
+    int *first;
+    int i, c, n;
+
+    if (!positions || !labels || !centroids || size <= 0 || num_clusters <= 0)
+        return;
+
+    east = (double *)malloc(sizeof(double) * size);
+    north = (double *)malloc(sizeof(double) * size);
+    first = (int *)malloc(sizeof(int) * num_clusters);
+    if (!east || !north || !first) {
+        free(east);
+        free(north);
+        free(first);
+        return;
+    }
+
+    for (c = 0; c < num_clusters; c++)
+        first[c] = -1;
+    for (i = size - 1; i >= 0; i--) {
+        if (labels[i] >= 0 && labels[i] < num_clusters)
+            first[labels[i]] = i;
+    }
+
+    for (c = 0; c < num_clusters; c++) {
+        if (counts)
+            counts[c] = 0;
+
+        if (first[c] < 0)
+            continue;
+
+        // offsets from the first position of the cluster
+        origin = positions[first[c]];
+        local_init(&proj, &origin);
+
+        for (i = first[c], n = 0; i < size; i++) {
+            if (labels[i] == c) {
+                local_project(&proj, &positions[i], &east[n], &north[n]);
+                n++;
+            }
+        }
+
+        qsort(east, n, sizeof(double), compare_double);
+        qsort(north, n, sizeof(double), compare_double);
+        local_unproject(&proj, (east[(n - 1) / 2] + east[n / 2]) / 2, (north[(n - 1) / 2] + north[n / 2]) / 2,
+                        &centroids[c]);
+
+        if (counts)
+            counts[c] = n;
+    }
+
+    free(east);
+    free(north);
+    free(first);
+}
+
+// Sum of coef[j] * sin(2 * (j + 1) * (xi + i eta)) for j < UTM_ORDER by Clenshaw's recurrence.
+// Only sin(2 xi), cos(2 xi) and exp(2 eta) are evaluated, whatever the order of the series.
+void utm_series(const double *coef, double xi, double eta, double *sum_xi, double *sum_eta)
+{
+    double exp_2eta = exp(2.0 * eta);
+
+    utm_clenshaw(coef, sin(2.0 * xi), cos(2.0 * xi), (exp_2eta - 1.0 / exp_2eta) / 2.0,
+                 (exp_2eta + 1.0 / exp_2eta) / 2.0, sum_xi, sum_eta);
+}
+
+// The recurrence of utm_series, from the functions of 2 xi and 2 eta however they were obtained
+void utm_clenshaw(const double *coef, double sin_2xi, double cos_2xi, double sinh_2eta, double cosh_2eta,
+                  double *sum_xi, double *sum_eta)
+{
+    // 2 * cos(2 zeta) as a complex number
+    double ar = 2.0 * cos_2xi * cosh_2eta;
+    double ai = -2.0 * sin_2xi * sinh_2eta;
+    double y0r = 0, y0i = 0, y1r = 0, y1i = 0, tr, ti;
+    int j;
+
+    for (j = UTM_ORDER - 1; j >= 0; j--) {
+        tr = ar * y0r - ai * y0i - y1r + coef[j];
+        ti = ar * y0i + ai * y0r - y1i;
+        y1r = y0r;
+        y1i = y0i;
+        y0r = tr;
+        y0i = ti;
+    }
+
+    // multiply by sin(2 zeta)
+    *sum_xi = y0r * sin_2xi * cosh_2eta - y0i * cos_2xi * sinh_2eta;
+    *sum_eta = y0r * cos_2xi * sinh_2eta + y0i * sin_2xi * cosh_2eta;
+}
+
+// Transverse Mercator with unit scale by the Krueger series in n (Karney, 2011)
+UTMCoordinates wgs84_to_tm(GEOCoordinates radCoordinates, double centralMeridian)
+{
+    UTMCoordinates tmCoordinates = {0};
+    double sin_phi, t, l, xi_p, eta_p, sum_xi, sum_eta;
+
+    sin_phi = sin(radCoordinates.latitude);
+    l = radCoordinates.longitude - centralMeridian;
+
+    // tangent of the conformal latitude
+    t = sinh(atanh(sin_phi) - WGS84_ECCENTRICITY * atanh(WGS84_ECCENTRICITY * sin_phi));
+
+    xi_p = atan2(t, cos(l));
+    eta_p = atanh(sin(l) / sqrt(1.0 + t * t));
+
+    utm_series(utm_alpha, xi_p, eta_p, &sum_xi, &sum_eta);
+
+    tmCoordinates.easting = UTM_RECTIFYING_RADIUS * (eta_p + sum_eta);
+    tmCoordinates.northing = UTM_RECTIFYING_RADIUS * (xi_p + sum_xi);
+
+    return tmCoordinates;
+}
+
+GEOCoordinates tm_to_wgs84(UTMCoordinates tm, double centralMeridian)
+{
+    GEOCoordinates coordinates;
+    double xi, eta, sum_xi, sum_eta, sinh_eta, chi, unused;
+
+    xi = tm.northing / UTM_RECTIFYING_RADIUS;
+    eta = tm.easting / UTM_RECTIFYING_RADIUS;
+
+    utm_series(utm_beta, xi, eta, &sum_xi, &sum_eta);
+    xi -= sum_xi;
+    eta -= sum_eta;
+
+    // conformal latitude, then its series for the geographic latitude
+    sinh_eta = sinh(eta);
+    chi = asin(sin(xi) / sqrt(1.0 + sinh_eta * sinh_eta));
+    utm_series(utm_delta, chi, 0, &sum_xi, &unused);
+
+    coordinates.latitude = chi + sum_xi;
+    coordinates.longitude = centralMeridian + atan2(sinh_eta, cos(xi));
+
+    return coordinates;
+}
+
+// Same as wgs84_to_tm, with the fast precision functions and fewer of them.
+// The conformal latitude is expanded as sinh(atanh(sin_phi) - b) = (sin_phi cosh(b) - sinh(b)) / cos_phi,
+// where b = e atanh(e sin_phi) is small enough for short series, and the double angle functions
+// of xi' = atan2(t, cos_l) and eta' = atanh(x) of the series follow algebraically.
+UTMCoordinates wgs84_to_tm_fast(GEOCoordinates radCoordinates, double centralMeridian)
+{
+    UTMCoordinates tmCoordinates = {0};
+    double sin_phi, cos_phi, sin_l, cos_l, b, sq_b, t, sq_r, x, sq_x, xi_p, eta_p, sum_xi, sum_eta;
+
+    fast_sincos(radCoordinates.latitude, &sin_phi, &cos_phi);
+    fast_sincos(radCoordinates.longitude - centralMeridian, &sin_l, &cos_l);
+
+    b = WGS84_ECCENTRICITY * fast_atanh(WGS84_ECCENTRICITY * sin_phi);
+    sq_b = b * b;
+    t = (sin_phi * (1.0 + sq_b / 2.0 * (1.0 + sq_b / 12.0 * (1.0 + sq_b / 30.0))) -
+         b * (1.0 + sq_b / 6.0 * (1.0 + sq_b / 20.0 * (1.0 + sq_b / 42.0)))) / cos_phi;
+
+    x = sin_l / sqrt(1.0 + t * t);
+    xi_p = fast_atan2(t, cos_l);
+    eta_p = fast_atanh(x);
+
+    sq_r = t * t + cos_l * cos_l;
+    sq_x = x * x;
+    utm_clenshaw(utm_alpha, 2.0 * t * cos_l / sq_r, (cos_l * cos_l - t * t) / sq_r,
+                 2.0 * x / (1.0 - sq_x), (1.0 + sq_x) / (1.0 - sq_x), &sum_xi, &sum_eta);
+
+    tmCoordinates.easting = UTM_RECTIFYING_RADIUS * (eta_p + sum_eta);
+    tmCoordinates.northing = UTM_RECTIFYING_RADIUS * (xi_p + sum_xi);
+
+    return tmCoordinates;
+}
+
+// Same as tm_to_wgs84, with the fast precision functions and fewer of them.
+// The series moves xi and eta by less than 1e-3 inside the zone, so their functions after it
+// follow from those before by small angle series. sin(2 chi) and cos(2 chi) follow from the sides
+// of the triangle that gives chi.
+GEOCoordinates tm_to_wgs84_fast(UTMCoordinates tm, double centralMeridian)
+{
+    GEOCoordinates coordinates;
+    double xi, eta, sum_xi, sum_eta, sq_sum, exp_eta, sinh_eta, cosh_eta, sin_xi, cos_xi, sin_d, cos_d;
+    double sin_xi_d, q, sq_h, chi, unused;
+
+    xi = tm.northing / UTM_RECTIFYING_RADIUS;
+    eta = tm.easting / UTM_RECTIFYING_RADIUS;
+
+    fast_sincos(xi, &sin_xi, &cos_xi);
+    exp_eta = fast_exp(eta);
+    sinh_eta = (exp_eta - 1.0 / exp_eta) / 2.0;
+    cosh_eta = (exp_eta + 1.0 / exp_eta) / 2.0;
+    utm_clenshaw(utm_beta, 2.0 * sin_xi * cos_xi, (cos_xi - sin_xi) * (cos_xi + sin_xi),
+                 2.0 * sinh_eta * cosh_eta, 1.0 + 2.0 * sinh_eta * sinh_eta, &sum_xi, &sum_eta);
+
+    // rotate by -sum_xi and scale by exp(-sum_eta)
+    sq_sum = sum_xi * sum_xi;
+    sin_d = sum_xi * (1.0 - sq_sum / 6.0 * (1.0 - sq_sum / 20.0));
+    cos_d = 1.0 - sq_sum / 2.0 * (1.0 - sq_sum / 12.0);
+    sin_xi_d = sin_xi * cos_d - cos_xi * sin_d;
+    cos_xi = cos_xi * cos_d + sin_xi * sin_d;
+    sin_xi = sin_xi_d;
+    exp_eta *= 1.0 - sum_eta * (1.0 - sum_eta / 2.0 * (1.0 - sum_eta / 3.0 * (1.0 - sum_eta / 4.0)));
+    sinh_eta = (exp_eta - 1.0 / exp_eta) / 2.0;
+
+    // tan(chi) = sin_xi / q, with sin_xi^2 + q^2 = 1 + sinh_eta^2
+    q = sqrt(sinh_eta * sinh_eta + cos_xi * cos_xi);
+    sq_h = 1.0 + sinh_eta * sinh_eta;
+    chi = fast_atan2(sin_xi, q);
+    utm_clenshaw(utm_delta, 2.0 * sin_xi * q / sq_h, (q * q - sin_xi * sin_xi) / sq_h, 0.0, 1.0,
+                 &sum_xi, &unused);
+
+    coordinates.latitude = chi + sum_xi;
+    coordinates.longitude = centralMeridian + fast_atan2(sinh_eta, cos_xi);
+
+    return coordinates;
+}
+
+#if defined(SIMD_LANES)
+// Lanes of x the fast functions do not take: out of their range, or not finite
+static simd_mask simd_beyond(simd_double x, double limit)
+{
+    return simd_not(simd_lt(simd_abs(x), simd_set(limit)));
+}
+
+// utm_clenshaw() on each lane
+static void simd_utm_clenshaw(const double *coef, simd_double sin_2xi, simd_double cos_2xi, simd_double sinh_2eta,
+                              simd_double cosh_2eta, simd_double *sum_xi, simd_double *sum_eta)
+{
+    simd_double ar = simd_mul(simd_mul(simd_set(2.0), cos_2xi), cosh_2eta);
+    simd_double ai = simd_mul(simd_mul(simd_set(-2.0), sin_2xi), sinh_2eta);
+    simd_double y0r = simd_set(0), y0i = simd_set(0), y1r = simd_set(0), y1i = simd_set(0), tr, ti;
+    int j;
+
+    for (j = UTM_ORDER - 1; j >= 0; j--) {
+        tr = simd_add(simd_sub(simd_sub(simd_mul(ar, y0r), simd_mul(ai, y0i)), y1r), simd_set(coef[j]));
+        ti = simd_sub(simd_add(simd_mul(ar, y0i), simd_mul(ai, y0r)), y1i);
+        y1r = y0r;
+        y1i = y0i;
+        y0r = tr;
+        y0i = ti;
+    }
+
+    *sum_xi = simd_sub(simd_mul(simd_mul(y0r, sin_2xi), cosh_2eta), simd_mul(simd_mul(y0i, cos_2xi), sinh_2eta));
+    *sum_eta = simd_add(simd_mul(simd_mul(y0r, cos_2xi), sinh_2eta), simd_mul(simd_mul(y0i, sin_2xi), cosh_2eta));
+}
+
+// loc_geometry_convert_wgs84_to_utm_with_precision() at the fast precision on SIMD_LANES coordinates
+// at a time, returning the number converted. The zones are found lane by lane, and the lanes the fast
+// functions do not take are converted one at a time.
+static int wgs84_to_utm_lanes(const GEOCoordinates *wgs84, UTMCoordinates *utm, int size)
+{
+    double lanes[3][SIMD_LANES];
+    unsigned int zones[SIMD_LANES];
+    simd_double phi, lambda, sin_phi, cos_phi, sin_l, cos_l, b, sq_b, t, u, x, sq_x, sq_r, xi_p, eta_p, sum_xi, sum_eta;
+    simd_mask skip;
+    int i, l, bits;
+
+    for (i = 0; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        for (l = 0; l < SIMD_LANES; l++) {
+            zones[l] = floor((wgs84[i + l].longitude + 180.0) / 6) + 1;
+            lanes[0][l] = loc_geometry_degrees_to_radians(-183.0 + (zones[l] * 6.0));
+        }
+
+        simd_load_pairs(&wgs84[i].latitude, &phi, &lambda);
+        phi = simd_mul(simd_div(phi, simd_set(180)), simd_set(MATH_PI));
+        lambda = simd_sub(simd_mul(simd_div(lambda, simd_set(180)), simd_set(MATH_PI)), simd_load(lanes[0]));
+
+        simd_fast_sincos(phi, &sin_phi, &cos_phi);
+        simd_fast_sincos(lambda, &sin_l, &cos_l);
+
+        b = simd_mul(simd_set(WGS84_ECCENTRICITY), sin_phi);
+        skip = simd_or(simd_or(simd_beyond(phi, FAST_TRIG_LIMIT), simd_beyond(lambda, FAST_TRIG_LIMIT)),
+                       simd_or(simd_lt(simd_set(FAST_ATANH_LIMIT), simd_abs(b)), simd_isnan(b)));
+        b = simd_mul(simd_set(WGS84_ECCENTRICITY), simd_fast_atanh(b));
+        sq_b = simd_mul(b, b);
+
+        t = simd_add(simd_set(1.0), simd_div(sq_b, simd_set(30.0)));
+        t = simd_add(simd_set(1.0), simd_mul(simd_div(sq_b, simd_set(12.0)), t));
+        t = simd_mul(sin_phi, simd_add(simd_set(1.0), simd_mul(simd_mul(sq_b, simd_set(0.5)), t)));
+        u = simd_add(simd_set(1.0), simd_div(sq_b, simd_set(42.0)));
+        u = simd_add(simd_set(1.0), simd_mul(simd_div(sq_b, simd_set(20.0)), u));
+        u = simd_mul(b, simd_add(simd_set(1.0), simd_mul(simd_div(sq_b, simd_set(6.0)), u)));
+        t = simd_div(simd_sub(t, u), cos_phi);
+
+        x = simd_div(sin_l, simd_sqrt(simd_add(simd_set(1.0), simd_mul(t, t))));
+        skip = simd_or(skip, simd_or(simd_lt(simd_set(FAST_ATANH_LIMIT), simd_abs(x)), simd_isnan(x)));
+        skip = simd_or(skip, simd_atan2_skip(t, cos_l));
+        xi_p = simd_fast_atan2(t, cos_l);
+        eta_p = simd_fast_atanh(x);
+
+        sq_r = simd_add(simd_mul(t, t), simd_mul(cos_l, cos_l));
+        sq_x = simd_mul(x, x);
+        simd_utm_clenshaw(utm_alpha, simd_div(simd_mul(simd_mul(simd_set(2.0), t), cos_l), sq_r),
+                          simd_div(simd_sub(simd_mul(cos_l, cos_l), simd_mul(t, t)), sq_r),
+                          simd_div(simd_mul(simd_set(2.0), x), simd_sub(simd_set(1.0), sq_x)),
+                          simd_div(simd_add(simd_set(1.0), sq_x), simd_sub(simd_set(1.0), sq_x)), &sum_xi, &sum_eta);
+
+        // scaled and offset as loc_geometry_convert_wgs84_to_utm_with_precision() does
+        x = simd_mul(simd_mul(simd_set(UTM_RECTIFYING_RADIUS), simd_add(eta_p, sum_eta)), simd_set(utm_scale_factor));
+        x = simd_add(x, simd_set(500000.0));
+        t = simd_mul(simd_mul(simd_set(UTM_RECTIFYING_RADIUS), simd_add(xi_p, sum_xi)), simd_set(utm_scale_factor));
+        t = simd_select(simd_lt(t, simd_set(0.0)), simd_add(t, simd_set(10000000.0)), t);
+        simd_store(lanes[1], x);
+        simd_store(lanes[2], t);
+
+        for (l = 0, bits = simd_bits(skip); l < SIMD_LANES; l++, bits >>= 1) {
+            if (bits & 1) {
+                utm[i + l] = loc_geometry_convert_wgs84_to_utm_with_precision(wgs84[i + l], GEOMETRY_PRECISION_FAST);
+                continue;
+            }
+
+            utm[i + l].easting = lanes[1][l];
+            utm[i + l].northing = lanes[2][l];
+            utm[i + l].grid_zone = zones[l];
+            utm[i + l].hemisphere = (wgs84[i + l].latitude < 0) ? UTM_HEMISPHERE_SOUTHERN : UTM_HEMISPHERE_NORTHERN;
+        }
+    }
+
+    return i;
+}
+
+// loc_geometry_convert_utm_to_wgs84_with_precision() at the fast precision on SIMD_LANES coordinates
+// at a time, returning the number converted, the lanes the fast functions do not take one at a time
+static int utm_to_wgs84_lanes(const UTMCoordinates *utm, GEOCoordinates *wgs84, int size)
+{
+    double lanes[3][SIMD_LANES];
+    simd_double xi, eta, sin_xi, cos_xi, exp_eta, sinh_eta, cosh_eta, sum_xi, sum_eta, sq_sum, sin_d, cos_d;
+    simd_double sin_xi_d, scale, q, sq_h, chi, unused;
+    simd_mask skip;
+    int i, l, bits;
+
+    for (i = 0; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        for (l = 0; l < SIMD_LANES; l++) {
+            lanes[0][l] = (utm[i + l].easting - 500000.0) / utm_scale_factor;
+            lanes[1][l] = utm[i + l].northing;
+            if (utm[i + l].hemisphere == UTM_HEMISPHERE_SOUTHERN)
+                lanes[1][l] -= 10000000.0;
+            lanes[1][l] /= utm_scale_factor;
+            lanes[2][l] = loc_geometry_degrees_to_radians(-183.0 + (utm[i + l].grid_zone * 6.0));
+        }
+
+        xi = simd_div(simd_load(lanes[1]), simd_set(UTM_RECTIFYING_RADIUS));
+        eta = simd_div(simd_load(lanes[0]), simd_set(UTM_RECTIFYING_RADIUS));
+        skip = simd_or(simd_beyond(xi, FAST_TRIG_LIMIT), simd_beyond(eta, FAST_EXP_LIMIT));
+
+        simd_fast_sincos(xi, &sin_xi, &cos_xi);
+        exp_eta = simd_fast_exp(eta);
+        sinh_eta = simd_mul(simd_sub(exp_eta, simd_div(simd_set(1.0), exp_eta)), simd_set(0.5));
+        cosh_eta = simd_mul(simd_add(exp_eta, simd_div(simd_set(1.0), exp_eta)), simd_set(0.5));
+        simd_utm_clenshaw(utm_beta, simd_mul(simd_mul(simd_set(2.0), sin_xi), cos_xi),
+                          simd_mul(simd_sub(cos_xi, sin_xi), simd_add(cos_xi, sin_xi)),
+                          simd_mul(simd_mul(simd_set(2.0), sinh_eta), cosh_eta),
+                          simd_add(simd_set(1.0), simd_mul(simd_mul(simd_set(2.0), sinh_eta), sinh_eta)),
+                          &sum_xi, &sum_eta);
+
+        // rotate by -sum_xi and scale by exp(-sum_eta)
+        sq_sum = simd_mul(sum_xi, sum_xi);
+        sin_d = simd_sub(simd_set(1.0), simd_div(sq_sum, simd_set(20.0)));
+        sin_d = simd_mul(sum_xi, simd_sub(simd_set(1.0), simd_mul(simd_div(sq_sum, simd_set(6.0)), sin_d)));
+        cos_d = simd_sub(simd_set(1.0), simd_div(sq_sum, simd_set(12.0)));
+        cos_d = simd_sub(simd_set(1.0), simd_mul(simd_mul(sq_sum, simd_set(0.5)), cos_d));
+        sin_xi_d = simd_sub(simd_mul(sin_xi, cos_d), simd_mul(cos_xi, sin_d));
+        cos_xi = simd_add(simd_mul(cos_xi, cos_d), simd_mul(sin_xi, sin_d));
+        sin_xi = sin_xi_d;
+        scale = simd_sub(simd_set(1.0), simd_mul(sum_eta, simd_set(0.25)));
+        scale = simd_sub(simd_set(1.0), simd_mul(simd_div(sum_eta, simd_set(3.0)), scale));
+        scale = simd_sub(simd_set(1.0), simd_mul(simd_mul(sum_eta, simd_set(0.5)), scale));
+        exp_eta = simd_mul(exp_eta, simd_sub(simd_set(1.0), simd_mul(sum_eta, scale)));
+        sinh_eta = simd_mul(simd_sub(exp_eta, simd_div(simd_set(1.0), exp_eta)), simd_set(0.5));
+
+        // tan(chi) = sin_xi / q, with sin_xi^2 + q^2 = 1 + sinh_eta^2
+        q = simd_sqrt(simd_add(simd_mul(sinh_eta, sinh_eta), simd_mul(cos_xi, cos_xi)));
+        sq_h = simd_add(simd_set(1.0), simd_mul(sinh_eta, sinh_eta));
+        skip = simd_or(skip, simd_or(simd_atan2_skip(sin_xi, q), simd_atan2_skip(sinh_eta, cos_xi)));
+        chi = simd_fast_atan2(sin_xi, q);
+        simd_utm_clenshaw(utm_delta, simd_div(simd_mul(simd_mul(simd_set(2.0), sin_xi), q), sq_h),
+                          simd_div(simd_sub(simd_mul(q, q), simd_mul(sin_xi, sin_xi)), sq_h), simd_set(0.0),
+                          simd_set(1.0), &sum_xi, &unused);
+
+        simd_store_pairs(&wgs84[i].latitude,
+                         simd_div(simd_mul(simd_add(chi, sum_xi), simd_set(180)), simd_set(MATH_PI)),
+                         simd_div(simd_mul(simd_add(simd_load(lanes[2]), simd_fast_atan2(sinh_eta, cos_xi)),
+                                           simd_set(180)), simd_set(MATH_PI)));
+
+        for (l = 0, bits = simd_bits(skip); bits; l++, bits >>= 1) {
+            if (bits & 1)
+                wgs84[i + l] = loc_geometry_convert_utm_to_wgs84_with_precision(utm[i + l], GEOMETRY_PRECISION_FAST);
+        }
+    }
+
+    return i;
+}
+#endif
+
+// The polynomials of the fast functions are evaluated by Estrin's scheme,
+// for shorter chains of dependent operations than Horner's rule.
+
+// sin and cos of the remainder of x by pi / 2, rotated by the quadrant
+void fast_sincos(double x, double *sin_x, double *cos_x)
+{
+    const double *p = fast_sin_coef, *q = fast_cos_coef;
+    double k, r, z, sq_z, sc[2];
+    int quadrant;
+
+    if (!(fabs(x) < FAST_TRIG_LIMIT)) {
+        *sin_x = sin(x);
+        *cos_x = cos(x);
+        return;
+    }
+
+    k = (x * (2 / MATH_PI) + FAST_ROUND_MAGIC) - FAST_ROUND_MAGIC;
+    r = (x - k * FAST_PIO2_HI) - k * FAST_PIO2_LO;
+    z = r * r;
+    sq_z = z * z;
+    sc[0] = r + r * z * ((p[0] + z * p[1]) + sq_z * ((p[2] + z * p[3]) + sq_z * (p[4] + z * p[5])));
+    sc[1] = 1.0 - z / 2.0 + sq_z * ((q[0] + z * q[1]) + sq_z * ((q[2] + z * q[3]) + sq_z * (q[4] + z * q[5])));
+
+    // selected without branches, which would be mispredicted when the quadrants of a batch vary
+    quadrant = (int)k;
+    *sin_x = sc[quadrant & 1] * fast_quadrant_sign[(quadrant >> 1) & 1];
+    *cos_x = sc[(quadrant + 1) & 1] * fast_quadrant_sign[((quadrant + 1) >> 1) & 1];
+}
+
+// atan of the smaller of |y / x| and |x / y|, reduced to |t| <= tan(pi / 8) with a single division,
+// then unfolded to the quadrant
+double fast_atan2(double y, double x)
+{
+    const double *p = fast_atan_coef;
+    double ax = fabs(x), ay = fabs(y);
+    double lo, hi, t, z, sq_z, r, offset = 0;
+
+    // zeros, infinities and NaN
+    if (ax == 0 || ay == 0 || !isfinite(ax + ay))
+        return atan2(y, x);
+
+    lo = (ax < ay) ? ax : ay;
+    hi = (ax < ay) ? ay : ax;
+    if (lo > FAST_TAN_PI_8 * hi) {
+        t = (lo - hi) / (lo + hi);
+        offset = MATH_PI / 4;
+    } else {
+        t = lo / hi;
+    }
+
+    z = t * t;
+    sq_z = z * z;
+    r = (p[0] + z * p[1]) + sq_z * ((p[2] + z * p[3]) + sq_z * ((p[4] + z * p[5]) + sq_z * ((p[6] + z * p[7]) +
+        sq_z * (p[8] + z * p[9]))));
+    r = offset + (t + t * z * r);
+
+    if (ay > ax)
+        r = MATH_PI / 2 - r;
+    if (x < 0)
+        r = MATH_PI - r;
+
+    return (y < 0) ? -r : r;
+}
+
+// exp of the remainder of x by ln 2, scaled by the power of 2 in the exponent bits
+double fast_exp(double x)
+{
+    const double *p = fast_exp_coef;
+    double k, r, scale;
+    guint64 bits;
+
+    if (!(fabs(x) < FAST_EXP_LIMIT))
+        return exp(x);
+
+    k = (x * (1 / G_LN2) + FAST_ROUND_MAGIC) - FAST_ROUND_MAGIC;
+    r = (x - k * FAST_LN2_HI) - k * FAST_LN2_LO;
+
+    bits = (guint64)((gint64)k + 1023) << 52;
+    memcpy(&scale, &bits, sizeof(scale));
+
+    return (p[0] + r * (p[1] + r * (p[2] + r * (p[3] + r * (p[4] + r * (p[5] + r * (p[6] + r * (p[7] +
+            r * (p[8] + r * (p[9] + r * (p[10] + r * p[11]))))))))))) * scale;
+}
+
+double fast_atanh(double x)
+{
+    const double *p = fast_atanh_coef;
+    double z = x * x, sq_z = z * z;
+
+    if (!(fabs(x) <= FAST_ATANH_LIMIT))
+        return atanh(x);
+
+    return x + x * z * ((p[0] + z * p[1]) + sq_z * ((p[2] + z * p[3]) + sq_z * ((p[4] + z * p[5]) + sq_z * p[6])));
+}
+
+#if defined(SIMD_LANES)
+// fast_sincos() on each lane, whose |x| must be below FAST_TRIG_LIMIT
+static void simd_fast_sincos(simd_double x, simd_double *sin_x, simd_double *cos_x)
+{
+    const double *p = fast_sin_coef, *q = fast_cos_coef;
+    simd_double sum, k, r, z, sq_z, sin_r, cos_r;
+
+    sum = simd_add(simd_mul(x, simd_set(2 / MATH_PI)), simd_set(FAST_ROUND_MAGIC));
+    k = simd_sub(sum, simd_set(FAST_ROUND_MAGIC));
+    r = simd_sub(simd_sub(x, simd_mul(k, simd_set(FAST_PIO2_HI))), simd_mul(k, simd_set(FAST_PIO2_LO)));
+    z = simd_mul(r, r);
+    sq_z = simd_mul(z, z);
+
+    sin_r = simd_add(simd_add(simd_set(p[0]), simd_mul(z, simd_set(p[1]))),
+                     simd_mul(sq_z, simd_add(simd_add(simd_set(p[2]), simd_mul(z, simd_set(p[3]))),
+                                             simd_mul(sq_z, simd_add(simd_set(p[4]), simd_mul(z, simd_set(p[5])))))));
+    sin_r = simd_add(r, simd_mul(simd_mul(r, z), sin_r));
+
+    cos_r = simd_add(simd_add(simd_set(q[0]), simd_mul(z, simd_set(q[1]))),
+                     simd_mul(sq_z, simd_add(simd_add(simd_set(q[2]), simd_mul(z, simd_set(q[3]))),
+                                             simd_mul(sq_z, simd_add(simd_set(q[4]), simd_mul(z, simd_set(q[5])))))));
+    cos_r = simd_add(simd_sub(simd_set(1.0), simd_mul(z, simd_set(0.5))), simd_mul(sq_z, cos_r));
+
+    simd_quadrant(sum, sin_r, cos_r, sin_x, cos_x);
+}
+
+// fast_atan2() on each lane, whose x and y must be finite and not zero
+static simd_double simd_fast_atan2(simd_double y, simd_double x)
+{
+    const double *p = fast_atan_coef;
+    simd_double ax = simd_abs(x), ay = simd_abs(y);
+    simd_double lo, hi, t, z, sq_z, r;
+    simd_mask swap, far;
+
+    swap = simd_lt(ax, ay);
+    lo = simd_select(swap, ax, ay);
+    hi = simd_select(swap, ay, ax);
+    far = simd_lt(simd_mul(simd_set(FAST_TAN_PI_8), hi), lo);
+
+    // a single division, of whichever fraction the lane takes
+    t = simd_div(simd_select(far, simd_sub(lo, hi), lo), simd_select(far, simd_add(lo, hi), hi));
+    z = simd_mul(t, t);
+    sq_z = simd_mul(z, z);
+
+    r = simd_add(simd_set(p[8]), simd_mul(z, simd_set(p[9])));
+    r = simd_add(simd_add(simd_set(p[6]), simd_mul(z, simd_set(p[7]))), simd_mul(sq_z, r));
+    r = simd_add(simd_add(simd_set(p[4]), simd_mul(z, simd_set(p[5]))), simd_mul(sq_z, r));
+    r = simd_add(simd_add(simd_set(p[2]), simd_mul(z, simd_set(p[3]))), simd_mul(sq_z, r));
+    r = simd_add(simd_add(simd_set(p[0]), simd_mul(z, simd_set(p[1]))), simd_mul(sq_z, r));
+    r = simd_add(simd_select(far, simd_set(MATH_PI / 4), simd_set(0)), simd_add(t, simd_mul(simd_mul(t, z), r)));
+
+    r = simd_select(swap, simd_sub(simd_set(MATH_PI / 2), r), r);
+    r = simd_select(simd_lt(x, simd_set(0)), simd_sub(simd_set(MATH_PI), r), r);
+
+    return simd_select(simd_lt(y, simd_set(0)), simd_neg(r), r);
+}
+
+// fast_exp() on each lane, whose |x| must be below FAST_EXP_LIMIT
+static simd_double simd_fast_exp(simd_double x)
+{
+    const double *p = fast_exp_coef;
+    simd_double sum, k, r, y;
+    int j;
+
+    sum = simd_add(simd_mul(x, simd_set(1 / G_LN2)), simd_set(FAST_ROUND_MAGIC));
+    k = simd_sub(sum, simd_set(FAST_ROUND_MAGIC));
+    r = simd_sub(simd_sub(x, simd_mul(k, simd_set(FAST_LN2_HI))), simd_mul(k, simd_set(FAST_LN2_LO)));
+
+    for (y = simd_set(p[11]), j = 10; j >= 0; j--)
+        y = simd_add(simd_set(p[j]), simd_mul(r, y));
+
+    return simd_mul(y, simd_exp_scale(sum));
+}
+
+// fast_atanh() on each lane, whose |x| must be at most FAST_ATANH_LIMIT
+static simd_double simd_fast_atanh(simd_double x)
+{
+    const double *p = fast_atanh_coef;
+    simd_double z = simd_mul(x, x), sq_z = simd_mul(z, z), r;
+
+    r = simd_add(simd_add(simd_set(p[4]), simd_mul(z, simd_set(p[5]))), simd_mul(sq_z, simd_set(p[6])));
+    r = simd_add(simd_add(simd_set(p[2]), simd_mul(z, simd_set(p[3]))), simd_mul(sq_z, r));
+    r = simd_add(simd_add(simd_set(p[0]), simd_mul(z, simd_set(p[1]))), simd_mul(sq_z, r));
+
+    return simd_add(x, simd_mul(simd_mul(x, z), r));
+}
+#endif
+
+GEOCoordinates get_avg_geo(GEOCoordinates *measures, int size)
+{
+    GEOCoordinates avg;
+    int i;
+
+    avg.latitude = avg.longitude = 0;
+    for (i=0; i<size; i++) {
+        avg.latitude += measures[i].latitude;
+        avg.longitude += measures[i].longitude;
+    }
+
+    avg.latitude /= (double)size;
+    avg.longitude /= (double)size;
+
+    return avg;
+}
+
+UTMCoordinates get_avg_utm(GEOCoordinates *measures, int size)
+{
+    return loc_geometry_convert_wgs84_to_utm(get_avg_geo(measures, size));
+}
+
+void local_init(LocalProjection *proj, GEOCoordinates *origin)
+{
+    double phi = loc_geometry_degrees_to_radians(origin->latitude);
+    double N;
+
+    proj->origin = *origin;
+    proj->sin_lat = sin(phi);
+    proj->cos_lat = cos(phi);
+    proj->sin_lon = sin(loc_geometry_degrees_to_radians(origin->longitude));
+    proj->cos_lon = cos(loc_geometry_degrees_to_radians(origin->longitude));
+
+    N = WGS84_EQUITORIAL_RADIUS / sqrt(1.0 - WGS84_SQ_ECCENTRICITY * proj->sin_lat * proj->sin_lat);
+    proj->ecef_x = N * proj->cos_lat;
+    proj->ecef_z = N * (1.0 - WGS84_SQ_ECCENTRICITY) * proj->sin_lat;
+}
+
+// East and North of the tangent plane at the origin, both on the ellipsoid surface.
+// The position is taken to earth centered coordinates rotated by the origin longitude,
+// so only the longitude difference needs trigonometry, then rotated by the origin latitude.
+void local_project(const LocalProjection *proj, const GEOCoordinates *position, double *east, double *north)
+{
+    double phi = loc_geometry_degrees_to_radians(position->latitude);
+    double dlambda = loc_geometry_degrees_to_radians(position->longitude - proj->origin.longitude);
+    double sin_phi = sin(phi), cos_phi = cos(phi);
+    double N, x, z;
+
+    N = WGS84_EQUITORIAL_RADIUS / sqrt(1.0 - WGS84_SQ_ECCENTRICITY * sin_phi * sin_phi);
+    x = N * cos_phi * cos(dlambda) - proj->ecef_x;
+    z = N * (1.0 - WGS84_SQ_ECCENTRICITY) * sin_phi - proj->ecef_z;
+
+    *east = N * cos_phi * sin(dlambda);
+    *north = proj->cos_lat * z - proj->sin_lat * x;
+}
+
+// Position on the ellipsoid with given East and North of the origin.
+// Its height above the tangent plane is not known, so it is corrected by the height above
+// the ellipsoid of the position found, which converges within a few steps for local offsets.
+void local_unproject(const LocalProjection *proj, double east, double north, GEOCoordinates *position)
+{
+    double sq_sin_lat = proj->sin_lat * proj->sin_lat;
+    double N = WGS84_EQUITORIAL_RADIUS / sqrt(1.0 - WGS84_SQ_ECCENTRICITY * sq_sin_lat);
+    double M = N * (1.0 - WGS84_SQ_ECCENTRICITY) / (1.0 - WGS84_SQ_ECCENTRICITY * sq_sin_lat);
+    double up, x, z, phi, lambda, height;
+    int iter;
+
+    // drop of the ellipsoid below the tangent plane, by its radii of curvature at the origin
+    up = -(east * east / (2 * N) + north * north / (2 * M));
+
+    for (iter = 0; iter < LOCAL_UNPROJECT_ITER_LIMIT; iter++) {
+        x = proj->ecef_x + proj->cos_lat * up - proj->sin_lat * north;
+        z = proj->ecef_z + proj->sin_lat * up + proj->cos_lat * north;
+        ecef_to_geodetic(x, east, z, GEOMETRY_PRECISION_EXACT, &phi, &lambda, &height);
+
+        if (fabs(height) < LOCAL_UNPROJECT_THRESHOLD)
+            break;
+
+        up -= height;
+    }
+
+    position->latitude = loc_geometry_radians_to_degrees(phi);
+    position->longitude = proj->origin.longitude + loc_geometry_radians_to_degrees(lambda);
+
+    if (position->longitude > 180)
+        position->longitude -= 360;
+    else if (position->longitude < -180)
+        position->longitude += 360;
+}
+
+// Earth centered coordinates of geodetic latitude and longitude in degrees and height in meters
+void geodetic_to_ecef(double latitude, double longitude, double height, GEOMETRY_PRECISION precision,
+                      ECEFCoordinates *ecef)
+{
+    double phi = loc_geometry_degrees_to_radians(latitude);
+    double lambda = loc_geometry_degrees_to_radians(longitude);
+    double sin_phi, cos_phi, sin_lambda, cos_lambda, N;
+
+    if (precision == GEOMETRY_PRECISION_FAST) {
+        fast_sincos(phi, &sin_phi, &cos_phi);
+        fast_sincos(lambda, &sin_lambda, &cos_lambda);
+    } else {
+        sin_phi = sin(phi);
+        cos_phi = cos(phi);
+        sin_lambda = sin(lambda);
+        cos_lambda = cos(lambda);
+    }
+
+    N = WGS84_EQUITORIAL_RADIUS / sqrt(1.0 - WGS84_SQ_ECCENTRICITY * sin_phi * sin_phi);
+    ecef->x = (N + height) * cos_phi * cos_lambda;
+    ecef->y = (N + height) * cos_phi * sin_lambda;
+    ecef->z = (N * (1.0 - WGS84_SQ_ECCENTRICITY) + height) * sin_phi;
+}
+
+// Geodetic latitude, longitude in radians and height in meters of earth centered coordinates.
+// Bowring's formula from the parametric latitude of the point on the ellipsoid below, which is
+// first taken in the direction of the point, then from the latitude found. The second step leaves
+// under 1e-15 radians from below the surface to beyond the orbits of navigation satellites.
+// Angles are carried as the sides of their triangles, so that only the results need atan2.
+void ecef_to_geodetic(double x, double y, double z, GEOMETRY_PRECISION precision,
+                      double *phi, double *lambda, double *height)
+{
+    const double a = WGS84_EQUITORIAL_RADIUS;
+    const double b = WGS84_SEMI_MINOR_AXIS;
+    const double e2 = WGS84_SQ_ECCENTRICITY;
+    double p = sqrt(x * x + y * y);
+    double r, sin_beta = a * z, cos_beta = b * p, num = z, den = p, sin_phi, cos_phi, N;
+    int step;
+
+    for (step = 0; step < ECEF_BOWRING_STEPS; step++) {
+        r = sqrt(sin_beta * sin_beta + cos_beta * cos_beta);
+        sin_beta /= r;
+        cos_beta /= r;
+
+        num = z + e2 / (1 - e2) * b * sin_beta * sin_beta * sin_beta;
+        den = p - e2 * a * cos_beta * cos_beta * cos_beta;
+
+        // tan(beta) = (1 - f) tan(phi)
+        sin_beta = (1 - WGS84_FLATTENING) * num;
+        cos_beta = den;
+    }
+
+    r = sqrt(num * num + den * den);
+    sin_phi = num / r;
+    cos_phi = den / r;
+    N = a / sqrt(1 - e2 * sin_phi * sin_phi);
+    *height = p * cos_phi + z * sin_phi - N * (1 - e2 * sin_phi * sin_phi);
+
+    if (precision == GEOMETRY_PRECISION_FAST) {
+        *phi = fast_atan2(num, den);
+        *lambda = fast_atan2(y, x);
+    } else {
+        *phi = atan2(num, den);
+        *lambda = atan2(y, x);
+    }
+}
+
+#if defined(SIMD_LANES)
+// Lanes where fast_atan2() takes atan2(): a zero argument, or one that is not finite
+static simd_mask simd_atan2_skip(simd_double y, simd_double x)
+{
+    simd_mask zero = simd_or(simd_eq(y, simd_set(0)), simd_eq(x, simd_set(0)));
+
+    return simd_or(zero, simd_not(simd_lt(simd_add(simd_abs(y), simd_abs(x)), simd_set(INFINITY))));
+}
+
+// geodetic_to_ecef() at the fast precision on SIMD_LANES coordinates at a time, returning the number
+// converted, the lanes out of the range of the fast polynomials converted by geodetic_to_ecef()
+static int geodetic_to_ecef_lanes(const GEOCoordinates *wgs84, const double *heights, ECEFCoordinates *ecef, int size)
+{
+    simd_double latitude, longitude, height, sin_phi, cos_phi, sin_lambda, cos_lambda, N, t;
+    simd_mask skip;
+    int i, l, bits;
+
+    for (i = 0; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        simd_load_pairs(&wgs84[i].latitude, &latitude, &longitude);
+        height = heights ? simd_load(&heights[i]) : simd_set(0);
+
+        latitude = simd_mul(simd_div(latitude, simd_set(180)), simd_set(MATH_PI));
+        longitude = simd_mul(simd_div(longitude, simd_set(180)), simd_set(MATH_PI));
+        skip = simd_or(simd_not(simd_lt(simd_abs(latitude), simd_set(FAST_TRIG_LIMIT))),
+                       simd_not(simd_lt(simd_abs(longitude), simd_set(FAST_TRIG_LIMIT))));
+
+        simd_fast_sincos(latitude, &sin_phi, &cos_phi);
+        simd_fast_sincos(longitude, &sin_lambda, &cos_lambda);
+
+        N = simd_sub(simd_set(1.0), simd_mul(simd_mul(simd_set(WGS84_SQ_ECCENTRICITY), sin_phi), sin_phi));
+        N = simd_div(simd_set(WGS84_EQUITORIAL_RADIUS), simd_sqrt(N));
+        t = simd_mul(simd_add(N, height), cos_phi);
+        simd_store_xyz(&ecef[i].x, simd_mul(t, cos_lambda), simd_mul(t, sin_lambda),
+                       simd_mul(simd_add(simd_mul(N, simd_set(1.0 - WGS84_SQ_ECCENTRICITY)), height), sin_phi));
+
+        for (l = 0, bits = simd_bits(skip); bits; l++, bits >>= 1) {
+            if (bits & 1)
+                geodetic_to_ecef(wgs84[i + l].latitude, wgs84[i + l].longitude, heights ? heights[i + l] : 0,
+                                 GEOMETRY_PRECISION_FAST, &ecef[i + l]);
+        }
+    }
+
+    return i;
+}
+
+// ecef_to_geodetic() on SIMD_LANES coordinates at a time, to degrees, returning the number converted.
+// Bowring's steps take no libm function, so they are the same on lanes at either precision. The
+// arctangents are taken lane by lane at the fast precision, and by atan2() at the exact one.
+static int ecef_to_geodetic_lanes(const ECEFCoordinates *ecef, GEOCoordinates *wgs84, double *heights, int size,
+                                  GEOMETRY_PRECISION precision)
+{
+    const double a = WGS84_EQUITORIAL_RADIUS;
+    const double b = WGS84_SEMI_MINOR_AXIS;
+    const double e2 = WGS84_SQ_ECCENTRICITY;
+    double lanes[6][SIMD_LANES];
+    simd_double x, y, z, p, r, sin_beta, cos_beta, num, den, sin_phi, cos_phi, N, phi, lambda;
+    int i, l, step, bits;
+
+    for (i = 0; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        simd_load_xyz(&ecef[i].x, &x, &y, &z);
+        p = simd_sqrt(simd_add(simd_mul(x, x), simd_mul(y, y)));
+        sin_beta = simd_mul(simd_set(a), z);
+        cos_beta = simd_mul(simd_set(b), p);
+        num = z;
+        den = p;
+
+        for (step = 0; step < ECEF_BOWRING_STEPS; step++) {
+            r = simd_sqrt(simd_add(simd_mul(sin_beta, sin_beta), simd_mul(cos_beta, cos_beta)));
+            sin_beta = simd_div(sin_beta, r);
+            cos_beta = simd_div(cos_beta, r);
+
+            num = simd_add(z, simd_mul(simd_mul(simd_mul(simd_set(e2 / (1 - e2) * b), sin_beta), sin_beta), sin_beta));
+            den = simd_sub(p, simd_mul(simd_mul(simd_mul(simd_set(e2 * a), cos_beta), cos_beta), cos_beta));
+
+            sin_beta = simd_mul(simd_set(1 - WGS84_FLATTENING), num);
+            cos_beta = den;
+        }
+
+        r = simd_sqrt(simd_add(simd_mul(num, num), simd_mul(den, den)));
+        sin_phi = simd_div(num, r);
+        cos_phi = simd_div(den, r);
+        r = simd_sub(simd_set(1), simd_mul(simd_mul(simd_set(e2), sin_phi), sin_phi));
+        N = simd_div(simd_set(a), simd_sqrt(r));
+
+        if (heights)
+            simd_store(&heights[i], simd_sub(simd_add(simd_mul(p, cos_phi), simd_mul(z, sin_phi)), simd_mul(N, r)));
+
+        if (precision == GEOMETRY_PRECISION_FAST) {
+            phi = simd_fast_atan2(num, den);
+            lambda = simd_fast_atan2(y, x);
+            bits = simd_bits(simd_or(simd_atan2_skip(num, den), simd_atan2_skip(y, x)));
+        } else {
+            phi = lambda = simd_set(0);
+            bits = (1 << SIMD_LANES) - 1;
+        }
+
+        if (bits) {
+            simd_store(lanes[0], num);
+            simd_store(lanes[1], den);
+            simd_store(lanes[2], y);
+            simd_store(lanes[3], x);
+            simd_store(lanes[4], phi);
+            simd_store(lanes[5], lambda);
+
+            for (l = 0; bits; l++, bits >>= 1) {
+                if (!(bits & 1))
+                    continue;
+
+                if (precision == GEOMETRY_PRECISION_FAST) {
+                    lanes[4][l] = fast_atan2(lanes[0][l], lanes[1][l]);
+                    lanes[5][l] = fast_atan2(lanes[2][l], lanes[3][l]);
+                } else {
+                    lanes[4][l] = atan2(lanes[0][l], lanes[1][l]);
+                    lanes[5][l] = atan2(lanes[2][l], lanes[3][l]);
+                }
+            }
+
+            phi = simd_load(lanes[4]);
+            lambda = simd_load(lanes[5]);
+        }
+
+        simd_store_pairs(&wgs84[i].latitude, simd_div(simd_mul(phi, simd_set(180)), simd_set(MATH_PI)),
+                         simd_div(simd_mul(lambda, simd_set(180)), simd_set(MATH_PI)));
+    }
+
+    return i;
+}
+
+// loc_geometry_local_ecef_to_enu() on SIMD_LANES coordinates at a time, returning the number converted
+static int ecef_to_enu_lanes(const LocalProjection *proj, const ECEFCoordinates *ecef, ENUCoordinates *enu, int size)
+{
+    simd_double sin_lat = simd_set(proj->sin_lat), cos_lat = simd_set(proj->cos_lat);
+    simd_double sin_lon = simd_set(proj->sin_lon), cos_lon = simd_set(proj->cos_lon);
+    simd_double x0 = simd_set(proj->ecef_x * proj->cos_lon);
+    simd_double y0 = simd_set(proj->ecef_x * proj->sin_lon);
+    simd_double z0 = simd_set(proj->ecef_z);
+    simd_double dx, dy, dz, t;
+    int i;
+
+    for (i = 0; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        simd_load_xyz(&ecef[i].x, &dx, &dy, &dz);
+        dx = simd_sub(dx, x0);
+        dy = simd_sub(dy, y0);
+        dz = simd_sub(dz, z0);
+
+        t = simd_add(simd_mul(cos_lon, dx), simd_mul(sin_lon, dy));
+        simd_store_xyz(&enu[i].east, simd_sub(simd_mul(cos_lon, dy), simd_mul(sin_lon, dx)),
+                       simd_sub(simd_mul(cos_lat, dz), simd_mul(sin_lat, t)),
+                       simd_add(simd_mul(cos_lat, t), simd_mul(sin_lat, dz)));
+    }
+
+    return i;
+}
+
+// loc_geometry_local_enu_to_ecef() on SIMD_LANES coordinates at a time, returning the number converted
+static int enu_to_ecef_lanes(const LocalProjection *proj, const ENUCoordinates *enu, ECEFCoordinates *ecef, int size)
+{
+    simd_double sin_lat = simd_set(proj->sin_lat), cos_lat = simd_set(proj->cos_lat);
+    simd_double sin_lon = simd_set(proj->sin_lon), cos_lon = simd_set(proj->cos_lon);
+    simd_double x0 = simd_set(proj->ecef_x * proj->cos_lon);
+    simd_double y0 = simd_set(proj->ecef_x * proj->sin_lon);
+    simd_double z0 = simd_set(proj->ecef_z);
+    simd_double east, north, up, t;
+    int i;
+
+    for (i = 0; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        simd_load_xyz(&enu[i].east, &east, &north, &up);
+
+        t = simd_sub(simd_mul(cos_lat, up), simd_mul(sin_lat, north));
+        simd_store_xyz(&ecef[i].x, simd_sub(simd_add(x0, simd_mul(cos_lon, t)), simd_mul(sin_lon, east)),
+                       simd_add(simd_add(y0, simd_mul(sin_lon, t)), simd_mul(cos_lon, east)),
+                       simd_add(simd_add(z0, simd_mul(sin_lat, up)), simd_mul(cos_lat, north)));
+    }
+
+    return i;
+}
+#endif
+
+void calc_sum_of_squares(GEOCoordinates *measures, int size, GEOCoordinates *ref_position,
+                         STATS_PROJECTION projection, double *sum_x, double *sum_y)
+{
+    UTMCoordinates utmRef, utmMeasured;
+    LocalProjection local;
+    GEOCoordinates origin;
+    double east, north;
+    int i;
+
+    *sum_x = *sum_y = 0;
+
+    if (projection == STATS_PROJECTION_LOCAL) {
+        origin = ref_position ? *ref_position : get_avg_geo(measures, size);
+        local_init(&local, &origin);
+
+        for (i=0; i<size; i++) {
+            local_project(&local, &measures[i], &east, &north);
+
+            *sum_x += east * east;
+            *sum_y += north * north;
+        }
+
+        return;
+    }
+
+    if (ref_position) {
+        utmRef = loc_geometry_convert_wgs84_to_utm(*ref_position);
+    } else {
+        utmRef = get_avg_utm(measures, size);
+    }
+
+    for (i=0; i<size; i++) {
+        utmMeasured = loc_geometry_convert_wgs84_to_utm(measures[i]);
+
+        *sum_x += pow((utmMeasured.easting - utmRef.easting), 2.0);
+        *sum_y += pow((utmMeasured.northing - utmRef.northing), 2.0);
+    }
+}
+
+void stats_accumulate(StatsAccumulator *acc, double x, double y)
+{
+    double dx = x - acc->mean_x;
+    double dy = y - acc->mean_y;
+
+    acc->count++;
+    acc->mean_x += dx / acc->count;
+    acc->mean_y += dy / acc->count;
+    acc->m2_x += dx * (x - acc->mean_x);
+    acc->m2_y += dy * (y - acc->mean_y);
+}
+
+// Chan's pairwise update, exact for any split of the samples
+void stats_merge(StatsAccumulator *acc, const StatsAccumulator *other)
+{
+    double dx, dy, count;
+
+    if (other->count == 0)
+        return;
+
+    if (acc->count == 0) {
+        *acc = *other;
+        return;
+    }
+
+    count = (double)acc->count + other->count;
+    dx = other->mean_x - acc->mean_x;
+    dy = other->mean_y - acc->mean_y;
+
+    acc->mean_x += dx * other->count / count;
+    acc->mean_y += dy * other->count / count;
+    acc->m2_x += other->m2_x + dx * dx * acc->count * other->count / count;
+    acc->m2_y += other->m2_y + dy * dy * acc->count * other->count / count;
+    acc->count += other->count;
+}
+
+void stats_run_chunk(StatsJob *job, int chunk)
+{
+    StatsAccumulator *acc = &job->chunks[chunk];
+    UTMCoordinates utmMeasured;
+    double east, north;
+    int i, first, last;
+
+    first = chunk * STATS_CHUNK_SIZE;
+    last = MIN(first + STATS_CHUNK_SIZE, job->size);
+
+    for (i = first; i < last; i++) {
+        if (job->projection == STATS_PROJECTION_LOCAL) {
+            local_project(&job->local_origin, &job->measures[i], &east, &north);
+        } else {
+            utmMeasured = loc_geometry_convert_wgs84_to_utm(job->measures[i]);
+            east = utmMeasured.easting - job->utm_origin.easting;
+            north = utmMeasured.northing - job->utm_origin.northing;
+        }
+
+        stats_accumulate(acc, east, north);
+    }
+}
+
+gpointer stats_run_worker(gpointer data)
+{
+    StatsWorker *worker = (StatsWorker *)data;
+    int chunk;
+
+    for (chunk = worker->first_chunk; chunk < worker->job->num_chunks; chunk += worker->job->num_threads)
+        stats_run_chunk(worker->job, chunk);
+
+    return NULL;
+}
+
+void quantile_init(QuantileSketch *sketch, double p)
+{
+    memset(sketch, 0, sizeof(QuantileSketch));
+    sketch->p = p;
+}
+
+void quantile_add(QuantileSketch *sketch, double x)
+{
+    const double p = sketch->p;
+    const double increments[5] = { 0, p / 2, p, (1 + p) / 2, 1 };
+    double *q = sketch->heights;
+    double *n = sketch->positions;
+    double d, parabolic;
+    int i, k;
+
+    if (sketch->count < 5) {
+        // insertion into the sorted initial samples
+        for (i = sketch->count; i > 0 && q[i - 1] > x; i--)
+            q[i] = q[i - 1];
+        q[i] = x;
+
+        if (++sketch->count == 5) {
+            for (i = 0; i < 5; i++) {
+                n[i] = i + 1;
+                sketch->desired[i] = 1 + 4 * increments[i];
+            }
+        }
+        return;
+    }
+
+    // cell of the new sample, extending the extreme markers if needed
+    if (x < q[0]) {
+        q[0] = x;
+        k = 0;
+    } else if (x >= q[4]) {
+        q[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; k < 3 && x >= q[k + 1]; k++)
+            ;
+    }
+
+    for (i = k + 1; i < 5; i++)
+        n[i] += 1;
+    for (i = 0; i < 5; i++)
+        sketch->desired[i] += increments[i];
+    sketch->count++;
+
+    // move the middle markers by one position towards where they should be
+    for (i = 1; i < 4; i++) {
+        d = sketch->desired[i] - n[i];
+        if ((d >= 1 && n[i + 1] - n[i] > 1) || (d <= -1 && n[i - 1] - n[i] < -1)) {
+            d = (d > 0) ? 1 : -1;
+
+            parabolic = q[i] + d / (n[i + 1] - n[i - 1]) *
+                        ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                         (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+
+            if (q[i - 1] < parabolic && parabolic < q[i + 1])
+                q[i] = parabolic;
+            else
+                q[i] += d * (q[i + (int)d] - q[i]) / (n[i + (int)d] - n[i]);
+
+            n[i] += d;
+        }
+    }
+}
+
+// Exact while either side still holds its first samples. Otherwise the middle markers are
+// the count weighted mean of both, placed at their desired positions for the total count.
+void quantile_merge(QuantileSketch *sketch, const QuantileSketch *other)
+{
+    const double p = sketch->p;
+    const double increments[5] = { 0, p / 2, p, (1 + p) / 2, 1 };
+    QuantileSketch merged;
+    double wa, wb;
+    int i;
+
+    if (other->count < 5) {
+        for (i = 0; i < other->count; i++)
+            quantile_add(sketch, other->heights[i]);
+        return;
+    }
+
+    if (sketch->count < 5) {
+        merged = *other;
+        for (i = 0; i < sketch->count; i++)
+            quantile_add(&merged, sketch->heights[i]);
+        *sketch = merged;
+        return;
+    }
+
+    wa = (double)sketch->count / (sketch->count + other->count);
+    wb = 1.0 - wa;
+
+    sketch->count += other->count;
+    sketch->heights[0] = fmin(sketch->heights[0], other->heights[0]);
+    sketch->heights[4] = fmax(sketch->heights[4], other->heights[4]);
+    for (i = 1; i < 4; i++)
+        sketch->heights[i] = wa * sketch->heights[i] + wb * other->heights[i];
+
+    for (i = 0; i < 5; i++) {
+        sketch->desired[i] = 1 + (sketch->count - 1) * increments[i];
+        sketch->positions[i] = floor(sketch->desired[i] + 0.5);
+    }
+
+    // markers must stay on distinct positions
+    for (i = 1; i < 4; i++)
+        sketch->positions[i] = fmax(sketch->positions[i], sketch->positions[i - 1] + 1);
+    for (i = 3; i > 0; i--)
+        sketch->positions[i] = fmin(sketch->positions[i], sketch->positions[i + 1] - 1);
+}
+
+double quantile_get(const QuantileSketch *sketch)
+{
+    double rank;
+    int i;
+
+    if (sketch->count == 0)
+        return 0;
+
+    if (sketch->count >= 5)
+        return sketch->heights[2];
+
+    // interpolated from the samples while there are too few for the markers
+    rank = sketch->p * (sketch->count - 1);
+    i = (int)rank;
+    if (i + 1 >= sketch->count)
+        return sketch->heights[sketch->count - 1];
+
+    return sketch->heights[i] + (rank - i) * (sketch->heights[i + 1] - sketch->heights[i]);
+}
+
+// New calculator with the reference position and settings of rtcep, without its window
+RTCEPCalculator* rtcep_create_like(RTCEPCalculator *rtcep)
+{
+    RTCEPCalculator *copy = loc_geometry_rtcep_create(&(rtcep->ref_geo_pos));
+
+    if (copy) {
+        copy->projection = rtcep->projection;
+        copy->estimate = rtcep->estimate;
+        copy->max_count = rtcep->max_count;
+    }
+
+    return copy;
+}
+
+gboolean rtcep_merge(RTCEPCalculator *rtcep, RTCEPCalculator *other)
+{
+    if (rtcep->window || other->window)
+        return FALSE;
+
+    if (rtcep->ref_geo_pos.latitude != other->ref_geo_pos.latitude ||
+        rtcep->ref_geo_pos.longitude != other->ref_geo_pos.longitude ||
+        rtcep->projection != other->projection)
+        return FALSE;
+
+    rtcep->lamda_x += other->lamda_x;
+    rtcep->lamda_y += other->lamda_y;
+    rtcep->count += other->count;
+
+    quantile_merge(&(rtcep->sketch_cep), &(other->sketch_cep));
+    quantile_merge(&(rtcep->sketch_r95), &(other->sketch_r95));
+
+    return TRUE;
+}
+
+void rtcep_add(RTCEPCalculator *rtcep, GEOCoordinates *measured_position, long long timestamp)
+{
+    UTMCoordinates utmMeasured;
+    RTCEPSample *sample;
+    double east, north;
+
+    if (rtcep->window) {
+        rtcep_evict(rtcep, timestamp);
+
+        // only a window bounded by time alone is still full here
+        if (rtcep->count == rtcep->window_size && !rtcep_window_grow(rtcep))
+            return;
+    } else if (rtcep->max_count > 0 && rtcep->count >= rtcep->max_count) {
+        return;
+    }
+
+    if (rtcep->projection == STATS_PROJECTION_LOCAL) {
+        local_project(&(rtcep->ref_local), measured_position, &east, &north);
+    } else {
+        utmMeasured = loc_geometry_convert_wgs84_to_utm(*measured_position);
+
+        east = utmMeasured.easting - rtcep->ref_utm_pos.easting;
+        north = utmMeasured.northing - rtcep->ref_utm_pos.northing;
+    }
+
+    rtcep->lamda_x += east * east;
+    rtcep->lamda_y += north * north;
+
+    if (rtcep->window) {
+        sample = &(rtcep->window[(rtcep->window_head + rtcep->count) % rtcep->window_size]);
+        sample->east = east;
+        sample->north = north;
+        sample->timestamp = timestamp;
+
+        if (rtcep->estimate == RTCEP_ESTIMATE_QUANTILE)
+            rtcep_window_insert(rtcep, sqrt(east * east + north * north));
+
+        // sums kept by adding and subtracting drift, so they are refreshed once per turn of the ring
+        if (++rtcep->window_updates >= rtcep->window_size) {
+            rtcep->count++;
+            rtcep_window_recompute(rtcep);
+            return;
+        }
+    } else if (rtcep->estimate == RTCEP_ESTIMATE_QUANTILE) {
+        quantile_add(&(rtcep->sketch_cep), sqrt(east * east + north * north));
+        quantile_add(&(rtcep->sketch_r95), sqrt(east * east + north * north));
+    }
+
+    rtcep->count++;
+}
+
+// Drop the oldest samples while the window is full or they are older than the window time
+void rtcep_evict(RTCEPCalculator *rtcep, long long timestamp)
+{
+    RTCEPSample *oldest;
+
+    while (rtcep->count > 0) {
+        oldest = &(rtcep->window[rtcep->window_head]);
+
+        if ((rtcep->window_fixes <= 0 || rtcep->count < rtcep->window_fixes) &&
+            (rtcep->window_time <= 0 || timestamp - oldest->timestamp <= rtcep->window_time))
+            break;
+
+        if (rtcep->estimate == RTCEP_ESTIMATE_QUANTILE)
+            rtcep_window_remove(rtcep, sqrt(oldest->east * oldest->east + oldest->north * oldest->north));
+
+        rtcep->lamda_x -= oldest->east * oldest->east;
+        rtcep->lamda_y -= oldest->north * oldest->north;
+        rtcep->window_head = (rtcep->window_head + 1) % rtcep->window_size;
+        rtcep->count--;
+    }
+
+    if (rtcep->count == 0)
+        rtcep->lamda_x = rtcep->lamda_y = 0;
+}
+
+void rtcep_window_recompute(RTCEPCalculator *rtcep)
+{
+    RTCEPSample *sample;
+    int i;
+
+    rtcep->lamda_x = rtcep->lamda_y = 0;
+    for (i = 0; i < rtcep->count; i++) {
+        sample = &(rtcep->window[(rtcep->window_head + i) % rtcep->window_size]);
+        rtcep->lamda_x += sample->east * sample->east;
+        rtcep->lamda_y += sample->north * sample->north;
+    }
+
+    rtcep->window_updates = 0;
+}
+
+// Double the ring of a window bounded by time alone, with its samples moved to the start
+gboolean rtcep_window_grow(RTCEPCalculator *rtcep)
+{
+    RTCEPSample *window;
+    double *radii;
+    int i, size;
+
+    if (rtcep->window_size > G_MAXINT / 2)
+        return FALSE;
+
+    size = rtcep->window_size * 2;
+
+    radii = (double *)realloc(rtcep->window_radii, sizeof(double) * size);
+    if (!radii)
+        return FALSE;
+    rtcep->window_radii = radii;
+
+    window = (RTCEPSample *)malloc(sizeof(RTCEPSample) * size);
+    if (!window)
+        return FALSE;
+
+    for (i = 0; i < rtcep->count; i++)
+        window[i] = rtcep->window[(rtcep->window_head + i) % rtcep->window_size];
+
+    free(rtcep->window);
+    rtcep->window = window;
+    rtcep->window_size = size;
+    rtcep->window_head = 0;
+
+    return TRUE;
+}
+
+// Radii of the samples in the window sorted, for a window which did not keep them
+void rtcep_window_rank(RTCEPCalculator *rtcep)
+{
+    RTCEPSample *sample;
+    int i;
+
+    for (i = 0; i < rtcep->count; i++) {
+        sample = &(rtcep->window[(rtcep->window_head + i) % rtcep->window_size]);
+        rtcep->window_radii[i] = sqrt(sample->east * sample->east + sample->north * sample->north);
+    }
+
+    qsort(rtcep->window_radii, rtcep->count, sizeof(double), compare_double);
+}
+
+// First index of the sorted radii of the window which is not below radius
+int rtcep_window_search(const RTCEPCalculator *rtcep, double radius)
+{
+    int low = 0, high = rtcep->count, middle;
+
+    while (low < high) {
+        middle = low + (high - low) / 2;
+
+        if (rtcep->window_radii[middle] < radius)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+// Insert the radius of a sample added to the window, before count is increased
+void rtcep_window_insert(RTCEPCalculator *rtcep, double radius)
+{
+    int i = rtcep_window_search(rtcep, radius);
+
+    memmove(&(rtcep->window_radii[i + 1]), &(rtcep->window_radii[i]), sizeof(double) * (rtcep->count - i));
+    rtcep->window_radii[i] = radius;
+}
+
+// Remove the radius of a sample dropped from the window, before count is decreased
+void rtcep_window_remove(RTCEPCalculator *rtcep, double radius)
+{
+    int i = rtcep_window_search(rtcep, radius);
+
+    if (i >= rtcep->count)
+        i = rtcep->count - 1;
+
+    memmove(&(rtcep->window_radii[i]), &(rtcep->window_radii[i + 1]), sizeof(double) * (rtcep->count - i - 1));
+}
+
+// Exact quantile of the horizontal error radius in the window, same interpolation as quantile_get()
+double rtcep_window_quantile(RTCEPCalculator *rtcep, double p)
+{
+    double rank;
+    int i;
+
+    if (rtcep->count == 0)
+        return 0;
+
+    rank = p * (rtcep->count - 1);
+    i = (int)rank;
+    if (i + 1 >= rtcep->count)
+        return rtcep->window_radii[rtcep->count - 1];
+
+    return rtcep->window_radii[i] + (rank - i) * (rtcep->window_radii[i + 1] - rtcep->window_radii[i]);
+}
+
+// East and North offsets of measured positions from their references, as rtcep_add() projects them
+// The local tangent planes are gathered from the arrays of the engine by reference index.
+void rtcep_engine_project(RTCEPEngine *engine, const int *ref_indexes, const GEOCoordinates *measured_positions,
+                          int size, double *east, double *north)
+{
+    UTMCoordinates utmMeasured;
+    double phi, dlambda, sin_phi, cos_phi, N, x, z;
+    int i, ref;
+
+    for (i = 0; i < size; i++) {
+        ref = ref_indexes[i];
+        east[i] = north[i] = 0;
+
+        if (ref < 0 || ref >= engine->num_refs)
+            continue;
+
+        if (engine->projection == STATS_PROJECTION_LOCAL) {
+            phi = loc_geometry_degrees_to_radians(measured_positions[i].latitude);
+            dlambda = loc_geometry_degrees_to_radians(measured_positions[i].longitude -
+                                                      engine->ref_geo_pos[ref].longitude);
+            sin_phi = sin(phi);
+            cos_phi = cos(phi);
+
+            N = WGS84_EQUITORIAL_RADIUS / sqrt(1.0 - WGS84_SQ_ECCENTRICITY * sin_phi * sin_phi);
+            x = N * cos_phi * cos(dlambda) - engine->ecef_x[ref];
+            z = N * (1.0 - WGS84_SQ_ECCENTRICITY) * sin_phi - engine->ecef_z[ref];
+
+            east[i] = N * cos_phi * sin(dlambda);
+            north[i] = engine->cos_lat[ref] * z - engine->sin_lat[ref] * x;
+        } else {
+            utmMeasured = loc_geometry_convert_wgs84_to_utm(measured_positions[i]);
+
+            east[i] = utmMeasured.easting - engine->ref_easting[ref];
+            north[i] = utmMeasured.northing - engine->ref_northing[ref];
+        }
+    }
+}
+
+void rtcep_engine_add(RTCEPEngine *engine, int ref_index, double east, double north)
+{
+    if (ref_index < 0 || ref_index >= engine->num_refs)
+        return;
+
+    if (engine->max_count > 0 && engine->count[ref_index] >= engine->max_count)
+        return;
+
+    engine->lamda_x[ref_index] += east * east;
+    engine->lamda_y[ref_index] += north * north;
+
+    if (engine->estimate == RTCEP_ESTIMATE_QUANTILE) {
+        quantile_add(&(engine->sketch_cep[ref_index]), sqrt(east * east + north * north));
+        quantile_add(&(engine->sketch_r95[ref_index]), sqrt(east * east + north * north));
+    }
+
+    engine->count[ref_index]++;
+}
+
+int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Positions are rotated from earth centered coordinates, so that the distance in the grid is the straight
+// line between them wherever they are, and the grid cells are eps wide in East and North.
+gboolean cluster_grid_init(ClusterGrid *grid, const GEOCoordinates *positions, int size, double eps)
+{
+    LocalProjection proj;
+    GEOCoordinates origin = positions[0];
+    LocalProjection *proj_ref = &proj;
+    ECEFCoordinates ecef;
+    int i;
+
+    grid->size = size;
+    grid->eps = eps;
+    grid->enu = (ENUCoordinates *)malloc(sizeof(ENUCoordinates) * size);
+    grid->cells = (ClusterCell *)malloc(sizeof(ClusterCell) * size);
+    if (!grid->enu || !grid->cells) {
+        cluster_grid_free(grid);
+        return FALSE;
+    }
+
+    local_init(&proj, &origin);
+    for (i = 0; i < size; i++) {
+        geodetic_to_ecef(positions[i].latitude, positions[i].longitude, 0, GEOMETRY_PRECISION_EXACT, &ecef);
+        loc_geometry_local_ecef_to_enu(&proj_ref, &ecef, &grid->enu[i], 1);
+
+        grid->cells[i].x = (long long)floor(grid->enu[i].east / eps);
+        grid->cells[i].y = (long long)floor(grid->enu[i].north / eps);
+        grid->cells[i].index = i;
+    }
+
+    qsort(grid->cells, size, sizeof(ClusterCell), compare_cluster_cell);
+
+    return TRUE;
+}
+
+void cluster_grid_free(ClusterGrid *grid)
+{
+    free(grid->enu);
+    free(grid->cells);
+    grid->enu = NULL;
+    grid->cells = NULL;
+}
+
+// Positions within eps of a given one, itself included, stored into neighbors. Returns their number.
+// A straight line is never shorter in the plane, so they are all in the 3 x 3 cells around its cell,
+// three runs of cells of consecutive rows in the sorted cells.
+int cluster_grid_query(const ClusterGrid *grid, int position, int *neighbors)
+{
+    const ENUCoordinates *p = &grid->enu[position];
+    const ENUCoordinates *q;
+    long long x = (long long)floor(p->east / grid->eps);
+    long long y = (long long)floor(p->north / grid->eps);
+    double sq_eps = grid->eps * grid->eps;
+    double de, dn, du;
+    int count = 0;
+    int dx, k;
+
+    for (dx = -1; dx <= 1; dx++) {
+        for (k = cluster_grid_find(grid, x + dx, y - 1);
+             k < grid->size && grid->cells[k].x == x + dx && grid->cells[k].y <= y + 1; k++) {
+            q = &grid->enu[grid->cells[k].index];
+            de = q->east - p->east;
+            dn = q->north - p->north;
+            du = q->up - p->up;
+
+            if (de * de + dn * dn + du * du <= sq_eps)
+                neighbors[count++] = grid->cells[k].index;
+        }
+    }
+
+    return count;
+}
+
+// First of the sorted cells at or after column x, row y
+int cluster_grid_find(const ClusterGrid *grid, long long x, long long y)
+{
+    int lo = 0, hi = grid->size, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+
+        if (grid->cells[mid].x < x || (grid->cells[mid].x == x && grid->cells[mid].y < y))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+int compare_cluster_cell(const void *a, const void *b)
+{
+    const ClusterCell *p = (const ClusterCell *)a;
+    const ClusterCell *q = (const ClusterCell *)b;
+
+    if (p->x != q->x)
+        return (p->x > q->x) - (p->x < q->x);
+    if (p->y != q->y)
+        return (p->y > q->y) - (p->y < q->y);
+
+    return (p->index > q->index) - (p->index < q->index);
+}
+
+// Grow cluster from the count neighbors of a core position. Each position is queued once, as it joins,
+// and the neighbors of the core ones among them join in turn. Noise within reach joins as border.
+void cluster_expand(const ClusterGrid *grid, int min_points, int cluster, int *labels, int *neighbors, int *queue,
+                    int count)
+{
+    int head = 0, tail = 0;
+    int i, j;
+
+    for (;;) {
+        for (i = 0; i < count; i++) {
+            j = neighbors[i];
+
+            if (labels[j] == CLUSTER_NOISE) {
+                labels[j] = cluster;
+            } else if (labels[j] == CLUSTER_UNVISITED) {
+                labels[j] = cluster;
+                queue[tail++] = j;
+            }
+        }
+
+        if (head == tail)
+            break;
+
+        count = cluster_grid_query(grid, queue[head++], neighbors);
+        if (count < min_points)
+            count = 0;
+    }
+}
+
+// Distance from (x, y) to the segment from the origin to (end_x, end_y)
+double segment_distance(double x, double y, double end_x, double end_y)
+{
+    double sq_length = end_x * end_x + end_y * end_y;
+    double t = 0;
+
+    if (sq_length > 0) {
+        t = (x * end_x + y * end_y) / sq_length;
+        t = (t < 0) ? 0 : ((t > 1) ? 1 : t);
+    }
+
+    return hypot(x - t * end_x, y - t * end_y);
+}
+
+void reduced_latitude(double latitude, GEOMETRY_PRECISION precision, double *sin_u, double *cos_u)
+{
+    double u, sin_phi, cos_phi, norm;
+
+    if (precision != GEOMETRY_PRECISION_FAST) {
+        u = atan((1 - WGS84_FLATTENING) * tan(latitude * MATH_PI / 180));
+        *sin_u = sin(u);
+        *cos_u = cos(u);
+        return;
+    }
+
+    // tan(u) = (1 - f) tan(phi), normalized
+    fast_sincos(latitude * MATH_PI / 180, &sin_phi, &cos_phi);
+    sin_phi *= 1 - WGS84_FLATTENING;
+    norm = sqrt(sin_phi * sin_phi + cos_phi * cos_phi);
+    *sin_u = sin_phi / norm;
+    *cos_u = cos_phi / norm;
+}
+
+// Vincenty distances of size pairs, whose coordinates are stride doubles apart
+void distance_pairs(const double *lat1, const double *lon1, const double *lat2, const double *lon2, int stride,
+                    double *distances, int size, GEOMETRY_PRECISION precision)
+{
+    double sin_u1, cos_u1, sin_u2, cos_u2;
+    int i = 0, k;
+#if defined(SIMD_LANES)
+    double lanes[4][SIMD_LANES], delta_lon;
+    simd_double sin_v1, cos_v1, sin_v2, cos_v2;
+    simd_mask skip;
+    int l, bits, antipodal;
+
+    // SIMD_LANES pairs at a time at the fast precision, whose polynomials are evaluated lane by lane
+    for (; precision == GEOMETRY_PRECISION_FAST && i + SIMD_LANES <= size; i += SIMD_LANES) {
+        for (l = 0; l < SIMD_LANES; l++) {
+            k = (i + l) * stride;
+            lanes[0][l] = lat1[k];
+            lanes[1][l] = lon1[k];
+            lanes[2][l] = lat2[k];
+            lanes[3][l] = lon2[k];
+        }
+
+        skip = simd_or(simd_reduced_latitude(simd_load(lanes[0]), &sin_v1, &cos_v1),
+                       simd_reduced_latitude(simd_load(lanes[2]), &sin_v2, &cos_v2));
+        bits = vincenty_lanes(sin_v1, cos_v1, sin_v2, cos_v2,
+                              simd_div(simd_mul(simd_sub(simd_load(lanes[3]), simd_load(lanes[1])), simd_set(MATH_PI)),
+                                       simd_set(180)),
+                              skip, &distances[i], &antipodal);
+
+        for (l = 0; bits; l++, bits >>= 1, antipodal >>= 1) {
+            if (!(bits & 1))
+                continue;
+
+            reduced_latitude(lanes[0][l], precision, &sin_u1, &cos_u1);
+            reduced_latitude(lanes[2][l], precision, &sin_u2, &cos_u2);
+            delta_lon = (lanes[3][l] - lanes[1][l]) * MATH_PI / 180;
+            if (antipodal & 1)
+                distances[i + l] = distance_antipodal(sin_u1, cos_u1, sin_u2, cos_u2, delta_lon);
+            else
+                distances[i + l] = vincenty_pair(sin_u1, cos_u1, sin_u2, cos_u2, delta_lon, precision);
+        }
+    }
+#endif
+
+    for (; i < size; i++) {
+        k = i * stride;
+        reduced_latitude(lat1[k], precision, &sin_u1, &cos_u1);
+        reduced_latitude(lat2[k], precision, &sin_u2, &cos_u2);
+        distances[i] = vincenty_pair(sin_u1, cos_u1, sin_u2, cos_u2, (lon2[k] - lon1[k]) * MATH_PI / 180, precision);
+    }
+}
+
+// Vincenty distances from ref to size points, whose coordinates are stride doubles apart
+void distance_from_ref(const GEOCoordinates *ref, const double *latitudes, const double *longitudes, int stride,
+                       double *distances, int size, GEOMETRY_PRECISION precision)
+{
+    double sin_ref, cos_ref, sin_u, cos_u;
+    int i = 0, k;
+#if defined(SIMD_LANES)
+    double lanes[2][SIMD_LANES], delta_lon;
+    simd_double sin_v, cos_v;
+    simd_mask skip;
+    int l, bits, antipodal;
+#endif
+
+    // the reference point's reduced latitude is shared by every pair
+    reduced_latitude(ref->latitude, precision, &sin_ref, &cos_ref);
+
+#if defined(SIMD_LANES)
+    for (; precision == GEOMETRY_PRECISION_FAST && i + SIMD_LANES <= size; i += SIMD_LANES) {
+        for (l = 0; l < SIMD_LANES; l++) {
+            k = (i + l) * stride;
+            lanes[0][l] = latitudes[k];
+            lanes[1][l] = longitudes[k];
+        }
+
+        skip = simd_reduced_latitude(simd_load(lanes[0]), &sin_v, &cos_v);
+        bits = vincenty_lanes(simd_set(sin_ref), simd_set(cos_ref), sin_v, cos_v,
+                              simd_div(simd_mul(simd_sub(simd_load(lanes[1]), simd_set(ref->longitude)),
+                                                simd_set(MATH_PI)), simd_set(180)),
+                              skip, &distances[i], &antipodal);
+
+        for (l = 0; bits; l++, bits >>= 1, antipodal >>= 1) {
+            if (!(bits & 1))
+                continue;
+
+            reduced_latitude(lanes[0][l], precision, &sin_u, &cos_u);
+            delta_lon = (lanes[1][l] - ref->longitude) * MATH_PI / 180;
+            if (antipodal & 1)
+                distances[i + l] = distance_antipodal(sin_ref, cos_ref, sin_u, cos_u, delta_lon);
+            else
+                distances[i + l] = vincenty_pair(sin_ref, cos_ref, sin_u, cos_u, delta_lon, precision);
+        }
+    }
+#endif
+
+    for (; i < size; i++) {
+        k = i * stride;
+        reduced_latitude(latitudes[k], precision, &sin_u, &cos_u);
+        distances[i] = vincenty_pair(sin_ref, cos_ref, sin_u, cos_u, (longitudes[k] - ref->longitude) * MATH_PI / 180,
+                                     precision);
+    }
+}
+
+// Segments of a polyline. The reduced latitude of each point is taken once, as the end of one
+// segment and the start of the next, and the segment lengths are summed in order.
+double polyline_pass(const GEOCoordinates *points, const long long *timestamps_ms,
+                     double *cumulative, double *speeds, int size, GEOMETRY_PRECISION precision)
+{
+    double sin_u1, cos_u1, sin_u2, cos_u2, length, total = 0;
+    long long dt;
+    int i;
+
+    if (cumulative)
+        cumulative[0] = 0;
+
+    reduced_latitude(points[0].latitude, precision, &sin_u2, &cos_u2);
+
+    for (i = 0; i < size - 1; i++) {
+        sin_u1 = sin_u2;
+        cos_u1 = cos_u2;
+        reduced_latitude(points[i + 1].latitude, precision, &sin_u2, &cos_u2);
+
+        length = vincenty_pair(sin_u1, cos_u1, sin_u2, cos_u2,
+                               (points[i + 1].longitude - points[i].longitude) * MATH_PI / 180, precision);
+        total += length;
+
+        if (cumulative)
+            cumulative[i + 1] = total;
+
+        if (speeds) {
+            dt = timestamps_ms[i + 1] - timestamps_ms[i];
+            speeds[i] = (dt > 0) ? length * 1000 / dt : 0;
+        }
+    }
+
+    return total;
+}
+
+// Vincenty inverse formula for one pair, given the reduced latitudes of its points and their
+// longitude difference in radians, so that the batch paths compute the reduced latitude of a
+// point shared by several pairs only once.
+// Same result as distance_vincenty() at the exact precision.
+double vincenty_pair(double sin_u1, double cos_u1, double sin_u2, double cos_u2, double delta_lon,
+                     GEOMETRY_PRECISION precision)
+{
+    const double a = WGS84_EQUITORIAL_RADIUS;
+    const double b = WGS84_SEMI_MINOR_AXIS;
+    const double f = WGS84_FLATTENING;
+
+    double lambda = delta_lon, lambdaP;
+    double sin_lambda, cos_lambda, sin_sigma, cos_sigma, sigma;
+    double sin_alpha, sq_cos_alpha, cos_2sigma, C;
+    double sq_u, cal1, cal2, delta_sigma, x, y;
+    int iter_limit = VINCENTY_ITER_LIMIT;
+
+    do {
+        if (precision == GEOMETRY_PRECISION_FAST) {
+            fast_sincos(lambda, &sin_lambda, &cos_lambda);
+        } else {
+            sin_lambda = sin(lambda);
+            cos_lambda = cos(lambda);
+        }
+
+        x = cos_u2 * sin_lambda;
+        y = cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda;
+        sin_sigma = sqrt(x * x + y * y);
+
+        // co-incident points
+        if (sin_sigma == 0)
+            return 0;
+
+        cos_sigma = sin_u1 * sin_u2 + cos_u1 * cos_u2 * cos_lambda;
+
+        if (precision == GEOMETRY_PRECISION_FAST)
+            sigma = fast_atan2(sin_sigma, cos_sigma);
+        else
+            sigma = atan2(sin_sigma, cos_sigma);
+
+        sin_alpha = cos_u1 * cos_u2 * sin_lambda / sin_sigma;
+        sq_cos_alpha = 1.0 - sin_alpha * sin_alpha;
+        cos_2sigma = cos_sigma - 2.0 * sin_u1 * sin_u2 / sq_cos_alpha;
+
+        if (isnan(cos_2sigma))
+            cos_2sigma = 0;
+
+        C = f / 16.0 * sq_cos_alpha * (4.0 + f * (4.0 - 3.0 * sq_cos_alpha));
+        lambdaP = lambda;
+        lambda = delta_lon + (1.0 - C) * f * sin_alpha *
+                 (sigma + C * sin_sigma * (cos_2sigma + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma)));
+    } while (fabs(lambda - lambdaP) > VINCENTY_THRESHOLD && --iter_limit > 0);
+
+    if (iter_limit == 0)
+        return distance_antipodal(sin_u1, cos_u1, sin_u2, cos_u2, delta_lon);
+
+    sq_u = sq_cos_alpha * (a * a - b * b) / (b * b);
+    cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
+    cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
+    delta_sigma = cal2 * sin_sigma * (cos_2sigma + cal2 / 4.0 * (cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma) -
+                  cal2 / 6.0 * cos_2sigma * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * cos_2sigma * cos_2sigma)));
+
+    return b * cal1 * (sigma - delta_sigma);
+}
+
+#if defined(SIMD_LANES)
+// reduced_latitude() at the fast precision on each lane, returning the lanes out of the range
+// of the fast polynomials, which are left to it
+static simd_mask simd_reduced_latitude(simd_double latitude, simd_double *sin_u, simd_double *cos_u)
+{
+    simd_double phi = simd_div(simd_mul(latitude, simd_set(MATH_PI)), simd_set(180));
+    simd_double sin_phi, cos_phi, norm;
+
+    simd_fast_sincos(phi, &sin_phi, &cos_phi);
+    sin_phi = simd_mul(sin_phi, simd_set(1 - WGS84_FLATTENING));
+    norm = simd_sqrt(simd_add(simd_mul(sin_phi, sin_phi), simd_mul(cos_phi, cos_phi)));
+    *sin_u = simd_div(sin_phi, norm);
+    *cos_u = simd_div(cos_phi, norm);
+
+    return simd_not(simd_lt(simd_abs(phi), simd_set(FAST_TRIG_LIMIT)));
+}
+
+// vincenty_pair() at the fast precision on SIMD_LANES pairs, each lane iterating until it converges
+// while the others go on. The distances of the lanes set in skip, out of the range of the fast
+// polynomials, or of those that do not converge are not stored: they are returned as bits, for
+// vincenty_pair() to compute, those that do not converge also in antipodal, for distance_antipodal().
+static int vincenty_lanes(simd_double sin_u1, simd_double cos_u1, simd_double sin_u2, simd_double cos_u2,
+                          simd_double delta_lon, simd_mask skip, double *distances, int *antipodal)
+{
+    const double a = WGS84_EQUITORIAL_RADIUS;
+    const double b = WGS84_SEMI_MINOR_AXIS;
+    const double f = WGS84_FLATTENING;
+
+    simd_double lambda = delta_lon, lambda_next, sin_lambda, cos_lambda, x, y;
+    simd_double sin_sigma, cos_sigma, sigma, sin_alpha, sq_cos_alpha, cos_2sigma, C;
+    simd_double cos_u12 = simd_mul(cos_u1, cos_u2), sin_u1_cos_u2 = simd_mul(sin_u1, cos_u2);
+    simd_double state[5], sq_u, cal1, cal2, delta_sigma;
+    simd_mask active, coincident, done;
+    int iter_limit = VINCENTY_ITER_LIMIT;
+
+    active = simd_not(skip);
+    coincident = simd_none();
+    state[0] = state[1] = state[2] = state[3] = state[4] = simd_set(0);
+
+    do {
+        done = simd_not(simd_lt(simd_abs(lambda), simd_set(FAST_TRIG_LIMIT)));
+        skip = simd_or(skip, simd_and(active, done));
+        active = simd_andnot(active, done);
+
+        simd_fast_sincos(lambda, &sin_lambda, &cos_lambda);
+
+        x = simd_mul(cos_u2, sin_lambda);
+        y = simd_sub(simd_mul(cos_u1, sin_u2), simd_mul(sin_u1_cos_u2, cos_lambda));
+        sin_sigma = simd_sqrt(simd_add(simd_mul(x, x), simd_mul(y, y)));
+
+        // co-incident points
+        done = simd_and(active, simd_eq(sin_sigma, simd_set(0)));
+        coincident = simd_or(coincident, done);
+        active = simd_andnot(active, done);
+
+        cos_sigma = simd_add(simd_mul(sin_u1, sin_u2), simd_mul(cos_u12, cos_lambda));
+
+        // where fast_atan2() would take atan2(), and whatever else is not finite
+        done = simd_or(simd_eq(cos_sigma, simd_set(0)),
+                       simd_not(simd_lt(simd_add(sin_sigma, simd_abs(cos_sigma)), simd_set(INFINITY))));
+        skip = simd_or(skip, simd_and(active, done));
+        active = simd_andnot(active, done);
+
+        sigma = simd_fast_atan2(sin_sigma, cos_sigma);
+        sin_alpha = simd_div(simd_mul(cos_u12, sin_lambda), sin_sigma);
+        sq_cos_alpha = simd_sub(simd_set(1.0), simd_mul(sin_alpha, sin_alpha));
+        cos_2sigma = simd_sub(cos_sigma, simd_div(simd_mul(simd_mul(simd_set(2.0), sin_u1), sin_u2), sq_cos_alpha));
+        cos_2sigma = simd_select(simd_isnan(cos_2sigma), simd_set(0), cos_2sigma);
+
+        C = simd_mul(simd_mul(simd_set(f / 16.0), sq_cos_alpha),
+                     simd_add(simd_set(4.0), simd_mul(simd_set(f), simd_sub(simd_set(4.0),
+                                                                            simd_mul(simd_set(3.0), sq_cos_alpha)))));
+        lambda_next = simd_mul(simd_mul(C, cos_sigma),
+                               simd_add(simd_set(-1.0), simd_mul(simd_mul(simd_set(2.0), cos_2sigma), cos_2sigma)));
+        lambda_next = simd_add(sigma, simd_mul(simd_mul(C, sin_sigma), simd_add(cos_2sigma, lambda_next)));
+        lambda_next = simd_add(delta_lon, simd_mul(simd_mul(simd_mul(simd_sub(simd_set(1.0), C), simd_set(f)),
+                                                            sin_alpha), lambda_next));
+
+        // the lanes still iterating take this step, the others keep their last one
+        state[0] = simd_select(active, sin_sigma, state[0]);
+        state[1] = simd_select(active, cos_sigma, state[1]);
+        state[2] = simd_select(active, sigma, state[2]);
+        state[3] = simd_select(active, sq_cos_alpha, state[3]);
+        state[4] = simd_select(active, cos_2sigma, state[4]);
+
+        done = simd_not(simd_lt(simd_set(VINCENTY_THRESHOLD), simd_abs(simd_sub(lambda_next, lambda))));
+        lambda = simd_select(active, lambda_next, lambda);
+        active = simd_andnot(active, done);
+    } while (simd_bits(active) && --iter_limit > 0);
+
+    // near-antipodal lanes, where the iteration does not converge
+    *antipodal = simd_bits(active);
+    skip = simd_or(skip, active);
+
+    sin_sigma = state[0];
+    cos_sigma = state[1];
+    sigma = state[2];
+    sq_cos_alpha = state[3];
+    cos_2sigma = state[4];
+
+    sq_u = simd_div(simd_mul(sq_cos_alpha, simd_set(a * a - b * b)), simd_set(b * b));
+    cal1 = simd_sub(simd_set(320.0), simd_mul(simd_set(175.0), sq_u));
+    cal1 = simd_add(simd_set(4096.0), simd_mul(sq_u, simd_add(simd_set(-768.0), simd_mul(sq_u, cal1))));
+    cal1 = simd_add(simd_set(1.0), simd_mul(simd_mul(sq_u, simd_set(1 / 16384.0)), cal1));
+    cal2 = simd_sub(simd_set(74.0), simd_mul(simd_set(47.0), sq_u));
+    cal2 = simd_add(simd_set(256.0), simd_mul(sq_u, simd_add(simd_set(-128.0), simd_mul(sq_u, cal2))));
+    cal2 = simd_mul(simd_mul(sq_u, simd_set(1 / 1024.0)), cal2);
+
+    // cal2 / 6 cos(2 sigma_m) (-3 + 4 sin^2(sigma)) (-3 + 4 cos^2(2 sigma_m))
+    delta_sigma = simd_mul(simd_mul(simd_div(cal2, simd_set(6.0)), cos_2sigma),
+                           simd_add(simd_set(-3.0), simd_mul(simd_mul(simd_set(4.0), sin_sigma), sin_sigma)));
+    delta_sigma = simd_mul(delta_sigma,
+                           simd_add(simd_set(-3.0), simd_mul(simd_mul(simd_set(4.0), cos_2sigma), cos_2sigma)));
+    delta_sigma = simd_sub(simd_mul(cos_sigma, simd_add(simd_set(-1.0),
+                                                        simd_mul(simd_mul(simd_set(2.0), cos_2sigma), cos_2sigma))),
+                           delta_sigma);
+    delta_sigma = simd_mul(simd_mul(cal2, sin_sigma),
+                           simd_add(cos_2sigma, simd_mul(simd_mul(cal2, simd_set(0.25)), delta_sigma)));
+
+    simd_store(distances, simd_select(coincident, simd_set(0),
+                                      simd_mul(simd_mul(simd_set(b), cal1), simd_sub(sigma, delta_sigma))));
+
+    return simd_bits(skip);
+}
+#endif
+
+// Vincenty inverse formula, the exact precision of loc_geometry_calc_distance() and DISTANCE_MODE_GEODESIC
+double distance_vincenty(double lat1, double lon1, double lat2, double lon2)
+{
+    double lambdaP, iter_limit = 100.0;
+    double sin_sigma, sin_alpha, cos_sigma, sigma,  sq_cos_alpha, cos_2sigma, C;
+    double sq_u, cal1, cal2, delta_sigma, cal_dist;
+    double sin_lambda, cos_lambda;
+
+    const double a = 6378137.0;
+    const double b = 6356752.314245;
+    const double f = 1 / 298.257223563;
+    double delta_lon = ((lon2 - lon1) * MATH_PI / 180);
+    double u_1 = atan((1 - f) * tan((lat1) * MATH_PI / 180));
+    double u_2 = atan((1 - f) * tan((lat2) * MATH_PI / 180));
+
+    double lambda = delta_lon;
+    double sin_u1 = sin(u_1);
+    double cos_u1 = cos(u_1);
+    double sin_u2 = sin(u_2);
+    double cos_u2 = cos(u_2);
+
+    do {
+        sin_lambda = sin(lambda);
+        cos_lambda = cos(lambda);
+        sin_sigma = sqrt((cos_u2 * sin_lambda) * (cos_u2 * sin_lambda) +
+                         (cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda) *
+                         (cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda));
+
+        // co-incident points
+        if (sin_sigma == 0)
+            return 0;
+
+        cos_sigma = sin_u1 * sin_u2 + cos_u1 * cos_u2 * cos_lambda;
+        sigma = atan2(sin_sigma, cos_sigma);
+        sin_alpha = cos_u1 * cos_u2 * sin_lambda / sin_sigma;
+        sq_cos_alpha = 1.0 - sin_alpha * sin_alpha;
+        cos_2sigma = cos_sigma - 2.0 * sin_u1 * sin_u2 / sq_cos_alpha;
+
+        if (isnan(cos_2sigma))
+            cos_2sigma = 0;
+
+        C = f / 16.0 * sq_cos_alpha * (4.0 + f * (4.0 - 3.0 * sq_cos_alpha));
+        lambdaP = lambda;
+        lambda = delta_lon + (1.0 - C) * f * sin_alpha *
+                 (sigma + C * sin_sigma * (cos_2sigma + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma)));
+    } while (fabs(lambda - lambdaP) > 1e-12 && --iter_limit > 0);
+
+    // near-antipodal points, where the iteration does not converge
+    if (iter_limit == 0)
+        return distance_antipodal(sin_u1, cos_u1, sin_u2, cos_u2, delta_lon);
+
+    sq_u = sq_cos_alpha * (a * a - b * b) / (b * b);
+    cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
+    cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
+    delta_sigma = cal2 * sin_sigma * (cos_2sigma + cal2 / 4.0 * (cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma) -
+                cal2 / 6.0 * cos_2sigma * (-3.0 + 4.0 * sin_sigma * sin_sigma) * (-3.0 + 4.0 * cos_2sigma * cos_2sigma)));
+
+    cal_dist = b * cal1 * (sigma - delta_sigma);
+
+    return cal_dist;
+}
+
+double distance_equirectangular(double lat1, double lon1, double lat2, double lon2)
+{
+    double delta_lon = lon2 - lon1;
+    double x, y;
+
+    if (delta_lon > 180.0)
+        delta_lon -= 360.0;
+    else if (delta_lon < -180.0)
+        delta_lon += 360.0;
+
+    x = loc_geometry_degrees_to_radians(delta_lon) * cos(loc_geometry_degrees_to_radians((lat1 + lat2) / 2));
+    y = loc_geometry_degrees_to_radians(lat2 - lat1);
+
+    return WGS84_MEAN_RADIUS * sqrt(x * x + y * y);
+}
+
+double distance_haversine(double lat1, double lon1, double lat2, double lon2)
+{
+    double phi1 = loc_geometry_degrees_to_radians(lat1);
+    double phi2 = loc_geometry_degrees_to_radians(lat2);
+    double sin_dphi = sin((phi2 - phi1) / 2);
+    double sin_dlambda = sin(loc_geometry_degrees_to_radians(lon2 - lon1) / 2);
+    double h = sin_dphi * sin_dphi + cos(phi1) * cos(phi2) * sin_dlambda * sin_dlambda;
+
+    return 2 * WGS84_MEAN_RADIUS * asin(sqrt(h < 1.0 ? h : 1.0));
+}
+
+// Lambert's first order ellipsoidal correction of the great circle distance between reduced latitudes
+double distance_andoyer_lambert(double lat1, double lon1, double lat2, double lon2)
+{
+    const double f = WGS84_FLATTENING;
+    double beta1 = atan((1 - f) * tan(loc_geometry_degrees_to_radians(lat1)));
+    double beta2 = atan((1 - f) * tan(loc_geometry_degrees_to_radians(lat2)));
+    double sin_dbeta = sin((beta2 - beta1) / 2);
+    double sin_dlambda = sin(loc_geometry_degrees_to_radians(lon2 - lon1) / 2);
+    double h = sin_dbeta * sin_dbeta + cos(beta1) * cos(beta2) * sin_dlambda * sin_dlambda;
+    double sigma, P, Q, X, Y, sq_cos_half, sq_sin_half;
+
+    if (h <= 0)
+        return 0;
+
+    sigma = 2 * asin(sqrt(h < 1.0 ? h : 1.0));
+    P = (beta1 + beta2) / 2;
+    Q = (beta2 - beta1) / 2;
+    sq_sin_half = h < 1.0 ? h : 1.0;
+    sq_cos_half = 1.0 - sq_sin_half;
+
+    // the correction is singular for antipodal points, where it is dropped
+    X = sin(P) * cos(Q);
+    Y = cos(P) * sin(Q);
+    X = (sq_cos_half > 0) ? (sigma - sin(sigma)) * X * X / sq_cos_half : 0;
+    Y = (sigma + sin(sigma)) * Y * Y / sq_sin_half;
+
+    return WGS84_EQUITORIAL_RADIUS * (sigma - f / 2 * (X + Y));
+}
+
+// Longitude difference reached on the ellipsoid by the geodesic leaving the point at reduced latitude
+// (sin_b1, cos_b1) with azimuth alpha1 when it arrives at reduced latitude (sin_b2, cos_b2).
+// Points are normalized so that beta1 <= 0 and |beta2| <= |beta1|, the result grows with alpha1 in [0, pi].
+// The arc length and terms needed for the distance are returned through the pointers.
+double geodesic_lambda(double sin_b1, double cos_b1, double sin_b2, double cos_b2, double alpha1,
+                       double *sigma, double *sq_cos_alpha, double *cos_2sigma)
+{
+    const double f = WGS84_FLATTENING;
+    double sin_alpha1 = sin(alpha1), cos_alpha1 = cos(alpha1);
+    double sin_alpha0, cos_alpha2, t, n;
+    double sin_sigma1, cos_sigma1, sin_sigma2, cos_sigma2;
+    double sin_omega1, cos_omega1, sin_omega2, cos_omega2, omega;
+    double sin_sigma, cos_sigma, C;
+
+    sin_alpha0 = sin_alpha1 * cos_b1;
+    *sq_cos_alpha = 1.0 - sin_alpha0 * sin_alpha0;
+
+    t = cos_alpha1 * cos_alpha1 * cos_b1 * cos_b1 +
+        (cos_b1 < -sin_b1 ? (cos_b2 - cos_b1) * (cos_b2 + cos_b1) : (sin_b1 - sin_b2) * (sin_b1 + sin_b2));
+    cos_alpha2 = (cos_b2 != cos_b1 || fabs(sin_b2) != -sin_b1) ? sqrt(t > 0 ? t : 0) / cos_b2 : fabs(cos_alpha1);
+
+    // arc and sphere longitude from the equator crossing
+    sin_sigma1 = sin_b1;
+    cos_sigma1 = cos_alpha1 * cos_b1;
+    n = hypot(sin_sigma1, cos_sigma1);
+    sin_sigma1 /= n;
+    cos_sigma1 /= n;
+    sin_omega1 = sin_alpha0 * sin_b1;
+    cos_omega1 = cos_alpha1 * cos_b1;
+
+    sin_sigma2 = sin_b2;
+    cos_sigma2 = cos_alpha2 * cos_b2;
+    n = hypot(sin_sigma2, cos_sigma2);
+    sin_sigma2 /= n;
+    cos_sigma2 /= n;
+    sin_omega2 = sin_alpha0 * sin_b2;
+    cos_omega2 = cos_alpha2 * cos_b2;
+
+    sin_sigma = cos_sigma1 * sin_sigma2 - sin_sigma1 * cos_sigma2;
+    cos_sigma = cos_sigma1 * cos_sigma2 + sin_sigma1 * sin_sigma2;
+    *sigma = atan2(sin_sigma > 0 ? sin_sigma : 0, cos_sigma);
+    *cos_2sigma = cos_sigma1 * cos_sigma2 - sin_sigma1 * sin_sigma2;
+
+    omega = atan2(fmax(0, cos_omega1 * sin_omega2 - sin_omega1 * cos_omega2),
+                  cos_omega1 * cos_omega2 + sin_omega1 * sin_omega2);
+
+    C = f / 16.0 * (*sq_cos_alpha) * (4.0 + f * (4.0 - 3.0 * (*sq_cos_alpha)));
+
+    return omega - (1.0 - C) * f * sin_alpha0 *
+           (*sigma + C * sin(*sigma) * (*cos_2sigma + C * cos(*sigma) * (-1.0 + 2.0 * (*cos_2sigma) * (*cos_2sigma))));
+}
+
+// Distance for the near-antipodal pairs where Vincenty's iteration does not converge, given as in
+// vincenty_pair(), by bisection on the starting azimuth, which always converges as the reached
+// longitude is monotonic in the azimuth.
+double distance_antipodal(double sin_u1, double cos_u1, double sin_u2, double cos_u2, double delta_lon)
+{
+    const double a = WGS84_EQUITORIAL_RADIUS;
+    const double b = WGS84_SEMI_MINOR_AXIS;
+    double target, low, high, alpha1, lambda, tmp;
+    double sigma = 0, sq_cos_alpha = 1, cos_2sigma = 0;
+    double sq_u, cal1, cal2, delta_sigma;
+    int iter_limit = GEODESIC_ITER_LIMIT;
+
+    // normalize: |u1| >= |u2|, u1 <= 0, longitude difference in [0, pi]
+    if (fabs(sin_u2) > fabs(sin_u1)) {
+        tmp = sin_u1; sin_u1 = sin_u2; sin_u2 = tmp;
+        tmp = cos_u1; cos_u1 = cos_u2; cos_u2 = tmp;
+    }
+
+    if (sin_u1 > 0) {
+        sin_u1 = -sin_u1;
+        sin_u2 = -sin_u2;
+    }
+
+    target = fmod(fabs(delta_lon), 2 * MATH_PI);
+    if (target > MATH_PI)
+        target = 2 * MATH_PI - target;
+
+    low = 0;
+    high = MATH_PI;
+    do {
+        alpha1 = (low + high) / 2;
+        lambda = geodesic_lambda(sin_u1, cos_u1, sin_u2, cos_u2, alpha1, &sigma, &sq_cos_alpha, &cos_2sigma);
+
+        if (lambda < target)
+            low = alpha1;
+        else
+            high = alpha1;
+    } while (fabs(lambda - target) > GEODESIC_THRESHOLD && high - low > 1e-15 && --iter_limit > 0);
+
+    sq_u = sq_cos_alpha * (a * a - b * b) / (b * b);
+    cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
+    cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
+    delta_sigma = cal2 * sin(sigma) * (cos_2sigma + cal2 / 4.0 * (cos(sigma) * (-1.0 + 2.0 * cos_2sigma * cos_2sigma) -
+                  cal2 / 6.0 * cos_2sigma * (-3.0 + 4.0 * sin(sigma) * sin(sigma)) * (-3.0 + 4.0 * cos_2sigma * cos_2sigma)));
 
-    return loc_geometry_convert_wgs84_to_utm(avg);
+    return b * cal1 * (sigma - delta_sigma);
 }
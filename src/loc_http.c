@@ -16,7 +16,11 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
 #include <loc_http.h>
 #include <loc_log.h>
 
@@ -27,15 +31,632 @@
 #define NO_SSL_VERIFYHOST       0L
 #define SSL_VERIFYHOST          1L
 
+#define SPOOL_GROUP             "request"
+#define SPOOL_FILE_SUFFIX       ".req"
+#define SPOOL_TEMP_SUFFIX       ".tmp"
+#define DEFAULT_SPOOL_BATCH     4
+
+#define LIMIT_DECREASE_FACTOR   0.5
+#define LIMIT_BACKOFF_FACTOR    0.9
+#define LATENCY_TOLERANCE       2.0
+#define LATENCY_EWMA_WEIGHT     0.2
+#define MIN_LATENCY_DRIFT       0.01
+#define MAX_DEFAULT_HOSTS       64
+
+#define HEDGE_SAMPLES           64
+#define HEDGE_MIN_SAMPLES       16
+#define HEDGE_PERCENTILE        0.95
+#define HEDGE_BUDGET_BURST      1.0
+#define DEFAULT_HEDGE_BUDGET    0.05
+
+#define CASSETTE_MAGIC          "LOCHTTPC"
+#define CASSETTE_VERSION        1
+#define CASSETTE_NO_DATA        0xFFFFFFFFU
+
+typedef struct {
+    char *name;
+    gboolean configured;
+    gint64 lastUsed;
+    double rate;
+    double burst;
+    double tokens;
+    gint64 lastRefill;
+    int pending;
+    int inflight;
+    int minLimit;
+    int maxLimit;
+    double limit;
+    gboolean slowStart;
+    double minLatency;
+    double avgLatency;
+    gint64 lastDecrease;
+    double samples[HEDGE_SAMPLES];
+    int sampleCount;
+    int sampleIndex;
+} HttpHost;
+
+typedef struct {
+    HttpReqTask *primary;
+    HttpReqTask *shadow;
+    guint timer;
+    gboolean primaryFailed;
+} HttpHedge;
+
+typedef struct {
+    CURLcode curlResultCode;
+    long httpResponseCode;
+    gint64 latency;
+    size_t responseSize;
+    char *responseData;
+} HttpCassetteEntry;
+
+typedef struct {
+    GPtrArray *entries;
+    guint next;
+} HttpCassetteTrack;
+
+typedef struct {
+    HttpReqTask *task;
+    HttpCassetteEntry *entry;
+} HttpCassetteReplay;
+
 static gboolean gIsInitialized = FALSE;
 static ResponseCallback gResponseCb = NULL;
+static void *gResponseData = NULL;
 static GHashTable *gHttpTasks = NULL;
 static const char *gHttpHeader[MAX_HTTPHEADER] = { "Accept: application/json",
                                                    "Content-Type: application/json",
                                                    "charsets: utf-8" };
 
+// spool: entries waiting for replay are kept in order of their sequence number,
+// entries being replayed are mapped from their task
+static char *gSpoolDir = NULL;
+static int gSpoolMaxEntries = 0;
+static int gSpoolBatchSize = DEFAULT_SPOOL_BATCH;
+static guint64 gSpoolSeq = 0;
+static GQueue *gSpoolQueue = NULL;
+static GHashTable *gSpoolTasks = NULL;
+static gboolean gSpoolReplaying = FALSE;
+
+// scheduler: per-host state by host name, and tasks held back by their host's limits
+static GHashTable *gHttpHosts = NULL;
+static GQueue *gPendingTasks = NULL;
+static guint gScheduleTimer = 0;
+static GHashTable *gActiveTasks = NULL;
+static int gDefaultMinLimit = 0;
+static int gDefaultMaxLimit = 0;
+static int gDefaultHostCount = 0;
+
+// hedging: hedge records by both their primary and shadow task
+static GHashTable *gHedges = NULL;
+static double gHedgeBudget = DEFAULT_HEDGE_BUDGET;
+static guint64 gRequestCount = 0;
+static int gHedgeSent = 0;
+static int gHedgeWon = 0;
+
+// cassette: recorded responses by request key, and replayed tasks waiting for delivery
+static HTTP_CASSETTE_MODE gCassetteMode = HTTP_CASSETTE_OFF;
+static gboolean gCassetteRealTiming = FALSE;
+static FILE *gCassetteFile = NULL;
+static GHashTable *gCassetteTracks = NULL;
+static GHashTable *gCassetteTasks = NULL;
+
 static void cbLocCurl(void* data);
 static size_t cbWriteMemory(char *, size_t, size_t, void *);
+static gboolean spool_write(HttpReqTask *task);
+static void spool_complete(HttpReqTask *task);
+static void spool_resume();
+static void spool_replay_next();
+static void spool_cancel_replay();
+static gboolean submit_request(HttpReqTask *task);
+static void finish_task(HttpReqTask *task, void *data);
+static gboolean schedule_admit(HttpReqTask *task);
+static void schedule_enqueue(HttpReqTask *task);
+static void schedule_dispatch();
+static void schedule_cancel(HttpReqTask *task);
+static void schedule_clear();
+static gboolean schedule_admit_sync(HttpReqTask *task);
+static void schedule_complete(HttpReqTask *task);
+static void schedule_release(HttpReqTask *task);
+static void cassette_record(HttpReqTask *task);
+static void cassette_serve(HttpReqTask *task);
+static gboolean cassette_submit(HttpReqTask *task);
+static void cassette_clear();
+static gboolean hedge_is_shadow(HttpReqTask *task);
+static void hedge_arm(HttpReqTask *task);
+static HttpReqTask *hedge_complete(HttpReqTask *task);
+static void hedge_finish(HttpHedge *hedge);
+static void hedge_clear();
+
+static gint cmpSpoolEntry(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    return strcmp((const gchar *)a, (const gchar *)b);
+}
+
+static gchar *spool_entry_path(const gchar *name, const gchar *suffix)
+{
+    return g_strdup_printf("%s/%s%s", gSpoolDir, name, suffix);
+}
+
+static void spool_drop_entry(gchar *name)
+{
+    gchar *path = spool_entry_path(name, SPOOL_FILE_SUFFIX);
+
+    unlink(path);
+
+    g_free(path);
+    g_free(name);
+}
+
+static gboolean spool_sync_dir()
+{
+    gboolean ret = FALSE;
+    int fd = -1;
+
+    if ((fd = open(gSpoolDir, O_RDONLY | O_DIRECTORY)) < 0)
+        return FALSE;
+
+    ret = (fsync(fd) == 0);
+    close(fd);
+
+    return ret;
+}
+
+static gchar *get_url_host(const char *url)
+{
+    const char *start = NULL;
+    const char *end = NULL;
+    const char *ptr = NULL;
+
+    if ((start = strstr(url, "://")) != NULL)
+        start += 3;
+    else
+        start = url;
+
+    end = start + strcspn(start, "/?#");
+
+    // skip user info
+    for (ptr = start; ptr < end; ptr++) {
+        if (*ptr == '@')
+            start = ptr + 1;
+    }
+
+    // strip port, keeping IPv6 literals as they are
+    if (*start == '[') {
+        if ((ptr = memchr(start, ']', end - start)) != NULL)
+            end = ptr + 1;
+    } else if ((ptr = memchr(start, ':', end - start)) != NULL) {
+        end = ptr;
+    }
+
+    return g_ascii_strdown(start, end - start);
+}
+
+static void free_http_host(gpointer data)
+{
+    HttpHost *host = (HttpHost *)data;
+
+    free(host->name);
+    free(host);
+}
+
+static HttpHost *new_http_host(const gchar *key)
+{
+    HttpHost *host = NULL;
+
+    if (gHttpHosts == NULL)
+        gHttpHosts = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free_http_host);
+
+    host = (HttpHost *)malloc(sizeof(HttpHost));
+    if (host) {
+        memset(host, 0, sizeof(HttpHost));
+        host->name = strdup(key);
+        g_hash_table_insert(gHttpHosts, host->name, host);
+    }
+
+    return host;
+}
+
+// hosts are known by the host part of a url, so that "host", "host:port" and any url
+// to the host name the same one as the urls of the tasks.
+// Hosts looked up to be configured are kept for good.
+static HttpHost *get_http_host(const char *name, gboolean create)
+{
+    HttpHost *host = NULL;
+    gchar *key = get_url_host(name);
+
+    if (gHttpHosts)
+        host = (HttpHost *)g_hash_table_lookup(gHttpHosts, key);
+
+    if (create) {
+        if (!host) {
+            host = new_http_host(key);
+        } else if (!host->configured) {
+            gDefaultHostCount--;
+        }
+
+        if (host)
+            host->configured = TRUE;
+    }
+
+    g_free(key);
+
+    return host;
+}
+
+// forget the least recently used host that only has the default limits and no request
+static void evict_idle_host()
+{
+    GHashTableIter iter;
+    gpointer value;
+    HttpHost *host = NULL;
+    HttpHost *victim = NULL;
+
+    g_hash_table_iter_init(&iter, gHttpHosts);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        host = (HttpHost *)value;
+        if (host->configured || host->pending > 0 || host->inflight > 0)
+            continue;
+
+        if (!victim || host->lastUsed < victim->lastUsed)
+            victim = host;
+    }
+
+    if (victim) {
+        LS_LOG_DEBUG("schedule: forgetting idle host %s\n", victim->name);
+        g_hash_table_remove(gHttpHosts, victim->name);
+        gDefaultHostCount--;
+    }
+}
+
+static void host_set_concurrency(HttpHost *host, int min_limit, int max_limit)
+{
+    if (max_limit <= 0) {
+        host->maxLimit = 0;
+        return;
+    }
+
+    // a newly limited host starts low and grows quickly until the first sign of congestion
+    if (host->maxLimit <= 0) {
+        host->limit = 0;
+        host->slowStart = TRUE;
+    }
+
+    host->minLimit = MAX(1, min_limit);
+    host->maxLimit = MAX(host->minLimit, max_limit);
+    host->limit = CLAMP(host->limit, host->minLimit, host->maxLimit);
+}
+
+static HttpHost *get_task_host(HttpReqTask *task)
+{
+    HttpHost *host = NULL;
+    gchar *name = NULL;
+    gboolean track = FALSE;
+
+    // hosts of hedged requests are tracked for the latency that picks the hedge delay
+    track = (gDefaultMaxLimit > 0 || task->hedgeUrl || hedge_is_shadow(task));
+
+    if (!task->url || (!gHttpHosts && !track))
+        return NULL;
+
+    name = get_url_host(task->url);
+    if (gHttpHosts)
+        host = (HttpHost *)g_hash_table_lookup(gHttpHosts, name);
+
+    // hosts only under the default limits, or only tracked for hedging, are kept up to
+    // a bound, so that a client reaching many hosts does not keep the state of all of them
+    if (!host && track) {
+        if (gDefaultHostCount >= MAX_DEFAULT_HOSTS)
+            evict_idle_host();
+
+        if ((host = new_http_host(name)) != NULL) {
+            host_set_concurrency(host, gDefaultMinLimit, gDefaultMaxLimit);
+            gDefaultHostCount++;
+        }
+    }
+    g_free(name);
+
+    if (host)
+        host->lastUsed = g_get_monotonic_time();
+
+    return host;
+}
+
+static void host_refill(HttpHost *host, gint64 now)
+{
+    host->tokens = MIN(host->burst, host->tokens + (now - host->lastRefill) * host->rate / G_USEC_PER_SEC);
+    host->lastRefill = now;
+}
+
+static void host_add_sample(HttpHost *host, double latency)
+{
+    host->samples[host->sampleIndex] = latency;
+    host->sampleIndex = (host->sampleIndex + 1) % HEDGE_SAMPLES;
+    if (host->sampleCount < HEDGE_SAMPLES)
+        host->sampleCount++;
+}
+
+static int cmpLatency(const void *a, const void *b)
+{
+    double diff = *(const double *)a - *(const double *)b;
+
+    return (diff > 0) - (diff < 0);
+}
+
+static double host_get_percentile(HttpHost *host, double percentile)
+{
+    double sorted[HEDGE_SAMPLES];
+
+    if (host->sampleCount < HEDGE_MIN_SAMPLES)
+        return 0;
+
+    memcpy(sorted, host->samples, sizeof(double) * host->sampleCount);
+    qsort(sorted, host->sampleCount, sizeof(double), cmpLatency);
+
+    return sorted[(int)(percentile * (host->sampleCount - 1))];
+}
+
+static gboolean host_ready(HttpHost *host, gint64 now)
+{
+    if (host->maxLimit > 0 && host->inflight >= (int)host->limit)
+        return FALSE;
+
+    if (host->rate > 0) {
+        host_refill(host, now);
+        if (host->tokens < 1.0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void host_acquire(HttpHost *host)
+{
+    if (host->rate > 0)
+        host->tokens -= 1.0;
+}
+
+// time (milliseconds) until a new request gets its token, after the requests already waiting
+static double host_token_delay(HttpHost *host)
+{
+    double needed = host->pending + 1.0 - host->tokens;
+
+    return (needed > 0) ? needed * 1000.0 / host->rate : 0;
+}
+
+// give back the token of a request that was not sent after all
+static void host_refund(HttpHost *host)
+{
+    if (host->rate > 0)
+        host->tokens = MIN(host->burst, host->tokens + 1.0);
+}
+
+// AIMD on the measured completion: additive increase while latency stays near
+// the lowest seen, multiplicative decrease on errors or queueing at the server
+static void host_update_limit(HttpHost *host, double latency, gboolean error)
+{
+    gint64 now = g_get_monotonic_time();
+    gboolean saturated = (host->inflight + 1 >= (int)host->limit);
+    gboolean congested = FALSE;
+
+    if (!error) {
+        if (host->minLatency <= 0 || latency < host->minLatency)
+            host->minLatency = latency;
+        else
+            host->minLatency += (latency - host->minLatency) * MIN_LATENCY_DRIFT;
+
+        if (host->avgLatency <= 0)
+            host->avgLatency = latency;
+        else
+            host->avgLatency += (latency - host->avgLatency) * LATENCY_EWMA_WEIGHT;
+
+        congested = (host->avgLatency > LATENCY_TOLERANCE * host->minLatency);
+    }
+
+    if (host->maxLimit <= 0)
+        return;
+
+    if (error || congested) {
+        // decrease at most once per round trip, a burst of failures is one congestion event
+        if (now - host->lastDecrease > (gint64)host->avgLatency) {
+            host->limit *= error ? LIMIT_DECREASE_FACTOR : LIMIT_BACKOFF_FACTOR;
+            host->lastDecrease = now;
+            host->slowStart = FALSE;
+        }
+    } else if (saturated) {
+        host->limit += host->slowStart ? 1.0 : 1.0 / host->limit;
+    }
+
+    host->limit = CLAMP(host->limit, host->minLimit, host->maxLimit);
+}
+
+static gchar *get_cassette_key(HttpReqTask *task)
+{
+    return g_strdup_printf("%s\n%s", task->url ? task->url : "", task->post_data ? task->post_data : "");
+}
+
+static void free_cassette_entry(gpointer data)
+{
+    HttpCassetteEntry *entry = (HttpCassetteEntry *)data;
+
+    g_free(entry->responseData);
+    free(entry);
+}
+
+static void free_cassette_track(gpointer data)
+{
+    HttpCassetteTrack *track = (HttpCassetteTrack *)data;
+
+    g_ptr_array_free(track->entries, TRUE);
+    g_free(track);
+}
+
+static void cbCassetteSourceRemove(gpointer data)
+{
+    g_source_remove(GPOINTER_TO_UINT(data));
+}
+
+static gboolean read_cassette_data(const gchar **ptr, const gchar *end, void *out, size_t size)
+{
+    if ((size_t)(end - *ptr) < size)
+        return FALSE;
+
+    memcpy(out, *ptr, size);
+    *ptr += size;
+
+    return TRUE;
+}
+
+static gboolean read_cassette_string(const gchar **ptr, const gchar *end, gchar **out, size_t *outSize)
+{
+    guint32 size = 0;
+
+    if (!read_cassette_data(ptr, end, &size, sizeof(size)))
+        return FALSE;
+
+    if (size == CASSETTE_NO_DATA) {
+        *out = NULL;
+        *outSize = 0;
+        return TRUE;
+    }
+
+    if ((guint32)(end - *ptr) < size)
+        return FALSE;
+
+    // binary safe, response bodies may hold NUL bytes
+    *out = (gchar *)g_malloc(size + 1);
+    memcpy(*out, *ptr, size);
+    (*out)[size] = '\0';
+    *outSize = size;
+    *ptr += size;
+
+    return TRUE;
+}
+
+static void write_cassette_string(const char *data, size_t size)
+{
+    guint32 size32 = data ? (guint32)size : CASSETTE_NO_DATA;
+
+    fwrite(&size32, sizeof(size32), 1, gCassetteFile);
+    if (data)
+        fwrite(data, size, 1, gCassetteFile);
+}
+
+// cassette file: magic, version and then records of
+// url, post data, curl result, http response code, latency (usec) and response data
+// strings are prefixed with their length, integers are in host byte order
+static gboolean cassette_load(const char *path)
+{
+    gchar *contents = NULL;
+    gsize length = 0;
+    const gchar *ptr = NULL;
+    const gchar *end = NULL;
+    gchar *url = NULL;
+    gchar *postData = NULL;
+    gchar *key = NULL;
+    size_t size = 0;
+    guint32 version = 0;
+    gint32 curlResult = 0;
+    gint32 httpCode = 0;
+    gint64 latency = 0;
+    HttpCassetteEntry *entry = NULL;
+    HttpCassetteTrack *track = NULL;
+    gboolean ret = FALSE;
+
+    if (!g_file_get_contents(path, &contents, &length, NULL)) {
+        LS_LOG_ERROR("cassette: failed to read [%s]\n", path);
+        return FALSE;
+    }
+
+    ptr = contents;
+    end = contents + length;
+
+    if (length < strlen(CASSETTE_MAGIC) || memcmp(ptr, CASSETTE_MAGIC, strlen(CASSETTE_MAGIC)) != 0)
+        goto CLEANUP;
+    ptr += strlen(CASSETTE_MAGIC);
+
+    if (!read_cassette_data(&ptr, end, &version, sizeof(version)) || version != CASSETTE_VERSION)
+        goto CLEANUP;
+
+    gCassetteTracks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free_cassette_track);
+
+    while (ptr < end) {
+        if (!read_cassette_string(&ptr, end, &url, &size) ||
+            !read_cassette_string(&ptr, end, &postData, &size) ||
+            !read_cassette_data(&ptr, end, &curlResult, sizeof(curlResult)) ||
+            !read_cassette_data(&ptr, end, &httpCode, sizeof(httpCode)) ||
+            !read_cassette_data(&ptr, end, &latency, sizeof(latency))) {
+            LS_LOG_WARNING("cassette: truncated record in [%s]\n", path);
+            break;
+        }
+
+        entry = (HttpCassetteEntry *)malloc(sizeof(HttpCassetteEntry));
+        if (!entry)
+            break;
+        memset(entry, 0, sizeof(HttpCassetteEntry));
+
+        entry->curlResultCode = (CURLcode)curlResult;
+        entry->httpResponseCode = httpCode;
+        entry->latency = latency;
+
+        if (!read_cassette_string(&ptr, end, &(entry->responseData), &(entry->responseSize))) {
+            LS_LOG_WARNING("cassette: truncated record in [%s]\n", path);
+            free_cassette_entry(entry);
+            break;
+        }
+
+        key = g_strdup_printf("%s\n%s", url ? url : "", postData ? postData : "");
+        if ((track = (HttpCassetteTrack *)g_hash_table_lookup(gCassetteTracks, key)) == NULL) {
+            track = g_new0(HttpCassetteTrack, 1);
+            track->entries = g_ptr_array_new_with_free_func(free_cassette_entry);
+            g_hash_table_insert(gCassetteTracks, key, track);
+        } else {
+            g_free(key);
+        }
+        g_ptr_array_add(track->entries, entry);
+
+        g_free(url);
+        g_free(postData);
+        url = postData = NULL;
+    }
+
+    g_free(url);
+    g_free(postData);
+    ret = TRUE;
+
+CLEANUP:
+    if (!ret)
+        LS_LOG_ERROR("cassette: invalid file [%s]\n", path);
+
+    g_free(contents);
+
+    return ret;
+}
+
+static gboolean prepare_post_data(HttpReqTask *task)
+{
+    CURLcode curlRc = CURLE_OK;
+
+    if (task->post_data == NULL)
+        return TRUE;
+
+    if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_POST, 1)) != CURLE_OK) {
+        LS_LOG_ERROR("curl set opt: CURLOPT_POST failed [%s]\n", curl_easy_strerror(curlRc));
+        return FALSE;
+    }
+
+    if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_POSTFIELDSIZE, (long)strlen(task->post_data))) != CURLE_OK) {
+        LS_LOG_ERROR("curl set opt: CURLOPT_POSTFIELDSIZE failed [%s]\n", curl_easy_strerror(curlRc));
+        return FALSE;
+    }
+
+    if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_POSTFIELDS, task->post_data)) != CURLE_OK) {
+        LS_LOG_ERROR("curl set opt: CURLOPT_POSTFIELDS failed [%s]\n", curl_easy_strerror(curlRc));
+        return FALSE;
+    }
+
+    return TRUE;
+}
 
 HttpReqTask *loc_create_http_task(const char **headers, int size, void *message, void *userdata)
 {
@@ -109,6 +730,16 @@ void loc_http_task_destroy(HttpReqTask **task_ref)
         task->post_data = NULL;
     }
 
+    if (task->url) {
+        free(task->url);
+        task->url = NULL;
+    }
+
+    if (task->hedgeUrl) {
+        free(task->hedgeUrl);
+        task->hedgeUrl = NULL;
+    }
+
     if (task->responseData) {
         free(task->responseData);
         task->responseData = NULL;
@@ -132,6 +763,10 @@ gboolean loc_http_task_prepare_connection(HttpReqTask **task_ref, char *url)
         return FALSE;
     }
 
+    if (task->url)
+        free(task->url);
+    task->url = strdup(url);
+
     if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_WRITEFUNCTION, cbWriteMemory)) != CURLE_OK) {
         LS_LOG_ERROR("curl set opt: CURLOPT_WRITEFUNCTION failed [%s]\n", curl_easy_strerror(curlRc));
         return FALSE;
@@ -181,6 +816,11 @@ void loc_http_stop()
     if (!gIsInitialized)
         return;
 
+    spool_cancel_replay();
+    hedge_clear();
+    schedule_clear();
+    cassette_clear();
+
     loc_curl_cleanup();
 
     if (gHttpTasks) {
@@ -194,13 +834,13 @@ void loc_http_stop()
 void loc_http_set_callback(ResponseCallback response_cb, void *user_data)
 {
     gResponseCb = response_cb;
+    gResponseData = user_data;
     loc_curl_set_callback(cbLocCurl, user_data);
 }
 
 gboolean loc_http_add_request(HttpReqTask *task, gboolean sync)
 {
     CURLcode curlRc = CURLE_OK;
-    CURLMcode curlMRc = CURLM_OK;
 
     if (!task)
         return FALSE;
@@ -208,22 +848,8 @@ gboolean loc_http_add_request(HttpReqTask *task, gboolean sync)
     if (task->curlDesc.handle == NULL)
         return FALSE;
 
-    if (task->post_data != NULL) {
-        if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_POST, 1)) != CURLE_OK) {
-            LS_LOG_ERROR("curl set opt: CURLOPT_POST failed [%s]\n", curl_easy_strerror(curlRc));
-            return FALSE;
-        }
-
-        if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_POSTFIELDSIZE, (long)strlen(task->post_data))) != CURLE_OK) {
-            LS_LOG_ERROR("curl set opt: CURLOPT_POSTFIELDSIZE failed [%s]\n", curl_easy_strerror(curlRc));
-            return FALSE;
-        }
-
-        if ((curlRc = curl_easy_setopt(task->curlDesc.handle, CURLOPT_POSTFIELDS, task->post_data)) != CURLE_OK) {
-            LS_LOG_ERROR("curl set opt: CURLOPT_POSTFIELDS failed [%s]\n", curl_easy_strerror(curlRc));
-            return FALSE;
-        }
-    }
+    if (!prepare_post_data(task))
+        return FALSE;
 
     if (!gIsInitialized)
         loc_http_start();
@@ -238,12 +864,33 @@ gboolean loc_http_add_request(HttpReqTask *task, gboolean sync)
     task->curlDesc.httpResponseCode = 0;
     task->curlDesc.httpConnectCode = 0;
     task->responseSize = 0;
+    task->queueDelay = 0;
 
     if (sync) {
+        // over the quota of its host, a synchronous request fails at once instead of waiting
+        if (!schedule_admit_sync(task)) {
+            task->curlDesc.curlResultCode = CURLE_AGAIN;
+            task->curlDesc.curlResultErrorStr = (char *)curl_easy_strerror(CURLE_AGAIN);
+            LS_LOG_WARNING("schedule: synchronous request over the quota, retry in %ld ms\n", task->queueDelay);
+            return FALSE;
+        }
+
+        task->startTime = g_get_monotonic_time();
+
+        if (gCassetteMode == HTTP_CASSETTE_REPLAY) {
+            cassette_serve(task);
+            return (task->curlDesc.curlResultCode == CURLE_OK);
+        }
+
         if ((task->curlDesc.curlResultCode = curl_easy_perform(task->curlDesc.handle)) != CURLE_OK) {
             task->curlDesc.curlResultErrorStr = (char *)curl_easy_strerror(task->curlDesc.curlResultCode);
             LS_LOG_ERROR("curl easy perform: failed [%s]\n", task->curlDesc.curlResultErrorStr);
 
+            cassette_record(task);
+
+            if (task->spool)
+                spool_write(task);
+
             return FALSE;
         }
 
@@ -256,21 +903,21 @@ gboolean loc_http_add_request(HttpReqTask *task, gboolean sync)
                                         CURLINFO_HTTP_CONNECTCODE,
                                         &(task->curlDesc.httpConnectCode))) != CURLE_OK)
             LS_LOG_WARNING("get info: CURLINFO_HTTP_CONNECTCODE failed [%s]\n", curl_easy_strerror(curlRc));
+
+        cassette_record(task);
+        spool_resume();
     } else {
-        if (gHttpTasks == NULL) {
-            gHttpTasks = g_hash_table_new_full(g_direct_hash,
-                                               g_direct_equal,
-                                               NULL,
-                                               NULL);
+        if (!schedule_admit(task)) {
+            schedule_enqueue(task);
+            return TRUE;
         }
 
-        if ((curlMRc = loc_curl_add(task->curlDesc.handle)) != CURLM_OK) {
-            LS_LOG_ERROR("loc_curl_add: failed [%s]\n", curl_multi_strerror(curlMRc));
+        if (!submit_request(task)) {
+            if (task->spool)
+                spool_write(task);
 
             return FALSE;
         }
-
-        g_hash_table_insert(gHttpTasks, task->curlDesc.handle, task);
     }
 
     return TRUE;
@@ -278,35 +925,347 @@ gboolean loc_http_add_request(HttpReqTask *task, gboolean sync)
 
 void loc_http_remove_request(HttpReqTask *task)
 {
+    HttpHedge *hedge = NULL;
+
     if (!task)
         return;
 
     if (task->curlDesc.handle == NULL)
         return;
 
-    loc_curl_remove(task->curlDesc.handle);
+    if (gHedges && (hedge = (HttpHedge *)g_hash_table_lookup(gHedges, task)) != NULL && hedge->primary == task)
+        hedge_finish(hedge);
 
-    if (gHttpTasks)
-        g_hash_table_remove(gHttpTasks, task->curlDesc.handle);
+    if (gPendingTasks && g_queue_find(gPendingTasks, task)) {
+        schedule_cancel(task);
+        return;
+    }
+
+    schedule_release(task);
+
+    if (gCassetteTasks && g_hash_table_contains(gCassetteTasks, task)) {
+        g_hash_table_remove(gCassetteTasks, task);
+        return;
+    }
+
+    // only requests handed to curl are removed from it
+    if (gHttpTasks && g_hash_table_remove(gHttpTasks, task->curlDesc.handle))
+        loc_curl_remove(task->curlDesc.handle);
 }
 
-static void cbLocCurl(void* data)
+gboolean loc_http_spool_start(const char *directory, int max_entries)
 {
-    CURLMsg* msg = NULL;
-    CURLcode curlRc = CURLE_OK;
-    int inQueue = 0;
-    HttpReqTask *task = NULL;
-
-    LS_LOG_DEBUG("cbLocCurl start\n");
+    GDir *dir = NULL;
+    GPtrArray *names = NULL;
+    const gchar *fileName = NULL;
+    gchar *path = NULL;
+    gchar *name = NULL;
+    guint64 seq = 0;
+    guint i;
+
+    if (!directory || max_entries <= 0)
+        return FALSE;
 
-    while (1) {
-        msg = curl_multi_info_read(loc_curl_handle(), &inQueue);
-        LS_LOG_DEBUG("msg = %p, inQueue = %d\n", msg, inQueue);
-        if (msg == 0)
-            break;
+    loc_http_spool_stop();
 
-        if (msg->msg != CURLMSG_DONE)
-            continue;
+    if (g_mkdir_with_parents(directory, 0700) != 0) {
+        LS_LOG_ERROR("spool: failed to create directory [%s]\n", directory);
+        return FALSE;
+    }
+
+    if ((dir = g_dir_open(directory, 0, NULL)) == NULL) {
+        LS_LOG_ERROR("spool: failed to open directory [%s]\n", directory);
+        return FALSE;
+    }
+
+    names = g_ptr_array_new();
+    while ((fileName = g_dir_read_name(dir)) != NULL) {
+        if (g_str_has_suffix(fileName, SPOOL_TEMP_SUFFIX)) {
+            // left behind by an interrupted write, never renamed to a valid entry
+            path = g_build_filename(directory, fileName, NULL);
+            unlink(path);
+            g_free(path);
+        } else if (g_str_has_suffix(fileName, SPOOL_FILE_SUFFIX)) {
+            g_ptr_array_add(names, g_strndup(fileName, strlen(fileName) - strlen(SPOOL_FILE_SUFFIX)));
+        }
+    }
+    g_dir_close(dir);
+
+    gSpoolDir = strdup(directory);
+    gSpoolMaxEntries = max_entries;
+    gSpoolQueue = g_queue_new();
+    gSpoolTasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+    gSpoolSeq = 0;
+
+    for (i = 0; i < names->len; i++) {
+        name = (gchar *)g_ptr_array_index(names, i);
+        seq = g_ascii_strtoull(name, NULL, 10);
+        if (seq >= gSpoolSeq)
+            gSpoolSeq = seq + 1;
+
+        g_queue_insert_sorted(gSpoolQueue, name, cmpSpoolEntry, NULL);
+    }
+    g_ptr_array_free(names, TRUE);
+
+    while (g_queue_get_length(gSpoolQueue) > (guint)gSpoolMaxEntries)
+        spool_drop_entry((gchar *)g_queue_pop_head(gSpoolQueue));
+
+    LS_LOG_INFO("spool: started [%s] with %u entries\n", gSpoolDir, g_queue_get_length(gSpoolQueue));
+
+    return TRUE;
+}
+
+void loc_http_spool_stop()
+{
+    if (!gSpoolDir)
+        return;
+
+    spool_cancel_replay();
+
+    g_hash_table_destroy(gSpoolTasks);
+    gSpoolTasks = NULL;
+
+    g_queue_free_full(gSpoolQueue, g_free);
+    gSpoolQueue = NULL;
+
+    free(gSpoolDir);
+    gSpoolDir = NULL;
+}
+
+void loc_http_task_set_spool(HttpReqTask *task, gboolean spool)
+{
+    if (!task)
+        return;
+
+    task->spool = spool;
+}
+
+gboolean loc_http_spool_add(HttpReqTask *task)
+{
+    if (!task)
+        return FALSE;
+
+    return spool_write(task);
+}
+
+void loc_http_spool_replay(int batch_size)
+{
+    if (!gSpoolDir)
+        return;
+
+    gSpoolBatchSize = (batch_size > 0) ? batch_size : DEFAULT_SPOOL_BATCH;
+    gSpoolReplaying = TRUE;
+
+    spool_replay_next();
+}
+
+int loc_http_spool_get_count()
+{
+    if (!gSpoolDir)
+        return 0;
+
+    return (int)(g_queue_get_length(gSpoolQueue) + g_hash_table_size(gSpoolTasks));
+}
+
+void loc_http_set_rate_limit(const char *host, double rate, int burst)
+{
+    HttpHost *httpHost = NULL;
+    gint64 now = g_get_monotonic_time();
+
+    if (!host)
+        return;
+
+    if ((httpHost = get_http_host(host, TRUE)) == NULL)
+        return;
+
+    if (rate > 0) {
+        if (httpHost->rate > 0)
+            host_refill(httpHost, now);
+        else
+            httpHost->tokens = (burst > 1) ? burst : 1;
+
+        httpHost->rate = rate;
+        httpHost->burst = (burst > 1) ? burst : 1;
+        httpHost->tokens = MIN(httpHost->tokens, httpHost->burst);
+        httpHost->lastRefill = now;
+    } else {
+        httpHost->rate = 0;
+    }
+
+    // requests waiting for this host are released or re-timed
+    schedule_dispatch();
+}
+
+long loc_http_get_queue_delay(const char *host)
+{
+    HttpHost *httpHost = NULL;
+    double needed;
+    double delay = 0;
+
+    if (!host)
+        return 0;
+
+    httpHost = get_http_host(host, FALSE);
+    if (!httpHost)
+        return 0;
+
+    // a new request gets its token after all the requests already waiting
+    if (httpHost->rate > 0) {
+        host_refill(httpHost, g_get_monotonic_time());
+        delay = host_token_delay(httpHost);
+    }
+
+    // and its slot after the requests ahead of it have completed
+    if (httpHost->maxLimit > 0) {
+        needed = httpHost->pending + 1.0 - ((int)httpHost->limit - httpHost->inflight);
+        if (needed > 0)
+            delay = MAX(delay, needed * httpHost->avgLatency / 1000.0 / httpHost->limit);
+    }
+
+    return (long)ceil(delay);
+}
+
+void loc_http_set_adaptive_concurrency(const char *host, int min_limit, int max_limit)
+{
+    GHashTableIter iter;
+    gpointer value;
+    HttpHost *httpHost = NULL;
+
+    if (host) {
+        if ((httpHost = get_http_host(host, TRUE)) != NULL)
+            host_set_concurrency(httpHost, min_limit, max_limit);
+    } else {
+        // default of every host, applied to the hosts already known as well
+        gDefaultMinLimit = min_limit;
+        gDefaultMaxLimit = max_limit;
+
+        if (gHttpHosts) {
+            g_hash_table_iter_init(&iter, gHttpHosts);
+            while (g_hash_table_iter_next(&iter, NULL, &value))
+                host_set_concurrency((HttpHost *)value, min_limit, max_limit);
+        }
+    }
+
+    schedule_dispatch();
+}
+
+int loc_http_get_concurrency_limit(const char *host)
+{
+    HttpHost *httpHost = NULL;
+
+    if (!host)
+        return 0;
+
+    httpHost = get_http_host(host, FALSE);
+    if (!httpHost || httpHost->maxLimit <= 0)
+        return 0;
+
+    return (int)httpHost->limit;
+}
+
+gboolean loc_http_cassette_start(const char *path, HTTP_CASSETTE_MODE mode, gboolean real_timing)
+{
+    guint32 version = CASSETTE_VERSION;
+
+    if (!path)
+        return FALSE;
+
+    loc_http_cassette_stop();
+
+    if (mode == HTTP_CASSETTE_RECORD) {
+        if ((gCassetteFile = fopen(path, "wb")) == NULL) {
+            LS_LOG_ERROR("cassette: failed to open [%s]\n", path);
+            return FALSE;
+        }
+
+        fwrite(CASSETTE_MAGIC, strlen(CASSETTE_MAGIC), 1, gCassetteFile);
+        fwrite(&version, sizeof(version), 1, gCassetteFile);
+        fflush(gCassetteFile);
+    } else if (mode == HTTP_CASSETTE_REPLAY) {
+        if (!cassette_load(path))
+            return FALSE;
+
+        gCassetteTasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, cbCassetteSourceRemove);
+    } else {
+        return TRUE;
+    }
+
+    gCassetteMode = mode;
+    gCassetteRealTiming = real_timing;
+
+    return TRUE;
+}
+
+void loc_http_cassette_stop()
+{
+    gCassetteMode = HTTP_CASSETTE_OFF;
+    gCassetteRealTiming = FALSE;
+
+    cassette_clear();
+
+    if (gCassetteFile) {
+        fclose(gCassetteFile);
+        gCassetteFile = NULL;
+    }
+
+    if (gCassetteTracks) {
+        g_hash_table_destroy(gCassetteTracks);
+        gCassetteTracks = NULL;
+    }
+}
+
+gboolean loc_http_task_set_hedge(HttpReqTask *task, const char *alt_url, long delay_ms)
+{
+    if (!task)
+        return FALSE;
+
+    if (task->hedgeUrl) {
+        free(task->hedgeUrl);
+        task->hedgeUrl = NULL;
+    }
+
+    if (!alt_url)
+        return TRUE;
+
+    // the hosts are tracked once the requests are sent, see get_task_host()
+    if ((task->hedgeUrl = strdup(alt_url)) == NULL)
+        return FALSE;
+    task->hedgeDelay = delay_ms;
+
+    return TRUE;
+}
+
+void loc_http_set_hedge_budget(double ratio)
+{
+    gHedgeBudget = (ratio > 0) ? ratio : 0;
+}
+
+void loc_http_get_hedge_stats(int *sent, int *won)
+{
+    if (sent)
+        *sent = gHedgeSent;
+
+    if (won)
+        *won = gHedgeWon;
+}
+
+static void cbLocCurl(void* data)
+{
+    CURLMsg* msg = NULL;
+    CURLcode curlRc = CURLE_OK;
+    int inQueue = 0;
+    HttpReqTask *task = NULL;
+
+    LS_LOG_DEBUG("cbLocCurl start\n");
+
+    while (1) {
+        msg = curl_multi_info_read(loc_curl_handle(), &inQueue);
+        LS_LOG_DEBUG("msg = %p, inQueue = %d\n", msg, inQueue);
+        if (msg == 0)
+            break;
+
+        if (msg->msg != CURLMSG_DONE)
+            continue;
 
         LS_LOG_DEBUG("CURLMSG_DONE\n");
         if ((task = (HttpReqTask *)g_hash_table_lookup(gHttpTasks, msg->easy_handle)) != NULL) {
@@ -324,9 +1283,8 @@ static void cbLocCurl(void* data)
             if (msg->data.result != CURLE_OK)
                 task->curlDesc.curlResultErrorStr = (char *)curl_easy_strerror(msg->data.result);
 
-            if (gResponseCb)
-                (*gResponseCb)(task, data);
-
+            cassette_record(task);
+            finish_task(task, data);
         }
     }
 
@@ -353,3 +1311,836 @@ static size_t cbWriteMemory(char *ptr, size_t size, size_t nmemb, void *userdata
     return realsize;
 }
 
+static gboolean spool_write(HttpReqTask *task)
+{
+    GKeyFile *keyFile = NULL;
+    GPtrArray *headers = NULL;
+    struct curl_slist *header = NULL;
+    gchar *data = NULL;
+    gchar *name = NULL;
+    gchar *tmpPath = NULL;
+    gchar *path = NULL;
+    gsize size = 0;
+    gboolean ret = FALSE;
+    int fd = -1;
+
+    if (!gSpoolDir || !task->url)
+        return FALSE;
+
+    keyFile = g_key_file_new();
+    g_key_file_set_string(keyFile, SPOOL_GROUP, "url", task->url);
+
+    headers = g_ptr_array_new();
+    for (header = task->curlDesc.headerList; header; header = header->next)
+        g_ptr_array_add(headers, header->data);
+    g_key_file_set_string_list(keyFile, SPOOL_GROUP, "headers", (const gchar * const *)headers->pdata, headers->len);
+    g_ptr_array_free(headers, TRUE);
+
+    if (task->post_data)
+        g_key_file_set_string(keyFile, SPOOL_GROUP, "post_data", task->post_data);
+
+    data = g_key_file_to_data(keyFile, &size, NULL);
+    g_key_file_free(keyFile);
+
+    // bounded spool: make room by dropping the oldest entries, entries being replayed
+    // count as well but cannot be dropped, so the spool refuses new ones when they fill it
+    while (loc_http_spool_get_count() >= gSpoolMaxEntries && !g_queue_is_empty(gSpoolQueue)) {
+        LS_LOG_WARNING("spool: full, dropping oldest entry\n");
+        spool_drop_entry((gchar *)g_queue_pop_head(gSpoolQueue));
+    }
+
+    if (loc_http_spool_get_count() >= gSpoolMaxEntries) {
+        LS_LOG_WARNING("spool: full of entries being replayed, request not spooled\n");
+        g_free(data);
+        return FALSE;
+    }
+
+    name = g_strdup_printf("%016" G_GUINT64_FORMAT, gSpoolSeq++);
+    tmpPath = spool_entry_path(name, SPOOL_TEMP_SUFFIX);
+    path = spool_entry_path(name, SPOOL_FILE_SUFFIX);
+
+    // write the entry under a temporary name and publish it with an atomic rename,
+    // so a crash never leaves a partial entry behind
+    if ((fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0600)) < 0) {
+        LS_LOG_ERROR("spool: failed to open [%s]\n", tmpPath);
+        goto CLEANUP;
+    }
+
+    if (write(fd, data, size) != (ssize_t)size || fsync(fd) != 0) {
+        LS_LOG_ERROR("spool: failed to write [%s]\n", tmpPath);
+        close(fd);
+        unlink(tmpPath);
+        goto CLEANUP;
+    }
+    close(fd);
+
+    if (rename(tmpPath, path) != 0) {
+        LS_LOG_ERROR("spool: failed to rename [%s]\n", tmpPath);
+        unlink(tmpPath);
+        goto CLEANUP;
+    }
+
+    // the rename itself is only durable once the directory is
+    if (!spool_sync_dir()) {
+        LS_LOG_ERROR("spool: failed to sync [%s]\n", gSpoolDir);
+        unlink(path);
+        goto CLEANUP;
+    }
+
+    g_queue_push_tail(gSpoolQueue, name);
+    name = NULL;
+    ret = TRUE;
+
+CLEANUP:
+    g_free(name);
+    g_free(tmpPath);
+    g_free(path);
+    g_free(data);
+
+    return ret;
+}
+
+static HttpReqTask *spool_read(const gchar *name)
+{
+    GKeyFile *keyFile = NULL;
+    HttpReqTask *task = NULL;
+    gchar *path = NULL;
+    gchar *url = NULL;
+    gchar *postData = NULL;
+    gchar **headers = NULL;
+    gsize size = 0;
+
+    keyFile = g_key_file_new();
+    path = spool_entry_path(name, SPOOL_FILE_SUFFIX);
+
+    if (!g_key_file_load_from_file(keyFile, path, G_KEY_FILE_NONE, NULL))
+        goto CLEANUP;
+
+    if ((url = g_key_file_get_string(keyFile, SPOOL_GROUP, "url", NULL)) == NULL)
+        goto CLEANUP;
+
+    headers = g_key_file_get_string_list(keyFile, SPOOL_GROUP, "headers", &size, NULL);
+    postData = g_key_file_get_string(keyFile, SPOOL_GROUP, "post_data", NULL);
+
+    if ((task = loc_http_task_create((const char **)headers, (int)size)) == NULL)
+        goto CLEANUP;
+
+    if (!loc_http_task_prepare_connection(&task, url)) {
+        loc_http_task_destroy(&task);
+        task = NULL;
+        goto CLEANUP;
+    }
+
+    if (postData)
+        task->post_data = strdup(postData);
+
+CLEANUP:
+    g_strfreev(headers);
+    g_free(postData);
+    g_free(url);
+    g_free(path);
+    g_key_file_free(keyFile);
+
+    return task;
+}
+
+static void spool_replay_next()
+{
+    HttpReqTask *task = NULL;
+    gchar *name = NULL;
+
+    while (gSpoolReplaying && !g_queue_is_empty(gSpoolQueue) &&
+           g_hash_table_size(gSpoolTasks) < (guint)gSpoolBatchSize) {
+        name = (gchar *)g_queue_pop_head(gSpoolQueue);
+
+        if ((task = spool_read(name)) == NULL) {
+            LS_LOG_WARNING("spool: dropping unreadable entry [%s]\n", name);
+            spool_drop_entry(name);
+            continue;
+        }
+
+        g_hash_table_insert(gSpoolTasks, task, name);
+
+        if (!loc_http_add_request(task, FALSE)) {
+            g_hash_table_remove(gSpoolTasks, task);
+            loc_http_task_destroy(&task);
+            g_queue_insert_sorted(gSpoolQueue, name, cmpSpoolEntry, NULL);
+            gSpoolReplaying = FALSE;
+        }
+    }
+
+    if (g_queue_is_empty(gSpoolQueue) && g_hash_table_size(gSpoolTasks) == 0)
+        gSpoolReplaying = FALSE;
+}
+
+static void spool_complete(HttpReqTask *task)
+{
+    gchar *name = (gchar *)g_hash_table_lookup(gSpoolTasks, task);
+
+    g_hash_table_remove(gSpoolTasks, task);
+    loc_http_remove_request(task);
+
+    if (task->curlDesc.curlResultCode == CURLE_OK) {
+        spool_drop_entry(name);
+    } else {
+        // still offline: keep the entry and wait for the next sign of connectivity
+        LS_LOG_WARNING("spool: replay failed [%s]\n", task->curlDesc.curlResultErrorStr);
+        g_queue_insert_sorted(gSpoolQueue, name, cmpSpoolEntry, NULL);
+        gSpoolReplaying = FALSE;
+    }
+
+    loc_http_task_destroy(&task);
+
+    spool_replay_next();
+}
+
+static void spool_resume()
+{
+    if (!gSpoolDir || gSpoolReplaying || g_queue_is_empty(gSpoolQueue))
+        return;
+
+    gSpoolReplaying = TRUE;
+    spool_replay_next();
+}
+
+static void spool_cancel_replay()
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    HttpReqTask *task = NULL;
+
+    gSpoolReplaying = FALSE;
+
+    if (!gSpoolTasks)
+        return;
+
+    g_hash_table_iter_init(&iter, gSpoolTasks);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        task = (HttpReqTask *)key;
+
+        loc_http_remove_request(task);
+        loc_http_task_destroy(&task);
+        g_queue_insert_sorted(gSpoolQueue, value, cmpSpoolEntry, NULL);
+    }
+
+    g_hash_table_remove_all(gSpoolTasks);
+}
+
+static gboolean submit_request(HttpReqTask *task)
+{
+    CURLMcode curlMRc = CURLM_OK;
+
+    HttpHost *host = get_task_host(task);
+
+    task->startTime = g_get_monotonic_time();
+
+    if (host) {
+        if (gActiveTasks == NULL)
+            gActiveTasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+
+        g_hash_table_insert(gActiveTasks, task, host);
+        host->inflight++;
+    }
+
+    if (gCassetteMode == HTTP_CASSETTE_REPLAY) {
+        if (cassette_submit(task))
+            return TRUE;
+
+        if (host)
+            host_refund(host);
+        schedule_release(task);
+        return FALSE;
+    }
+
+    if (gHttpTasks == NULL) {
+        gHttpTasks = g_hash_table_new_full(g_direct_hash,
+                                           g_direct_equal,
+                                           NULL,
+                                           NULL);
+    }
+
+    if ((curlMRc = loc_curl_add(task->curlDesc.handle)) != CURLM_OK) {
+        LS_LOG_ERROR("loc_curl_add: failed [%s]\n", curl_multi_strerror(curlMRc));
+        if (host)
+            host_refund(host);
+        schedule_release(task);
+        return FALSE;
+    }
+
+    g_hash_table_insert(gHttpTasks, task->curlDesc.handle, task);
+
+    // hedges are counted apart from the requests that make their budget
+    if (!hedge_is_shadow(task)) {
+        gRequestCount++;
+        hedge_arm(task);
+    }
+
+    return TRUE;
+}
+
+static void finish_task(HttpReqTask *task, void *data)
+{
+    schedule_complete(task);
+
+    if (gHedges && (task = hedge_complete(task)) == NULL)
+        return;
+
+    if (gSpoolTasks && g_hash_table_contains(gSpoolTasks, task)) {
+        spool_complete(task);
+        return;
+    }
+
+    if (task->curlDesc.curlResultCode != CURLE_OK) {
+        if (task->spool)
+            spool_write(task);
+    } else {
+        spool_resume();
+    }
+
+    if (gResponseCb)
+        (*gResponseCb)(task, data);
+}
+
+static gboolean schedule_admit(HttpReqTask *task)
+{
+    HttpHost *host = get_task_host(task);
+
+    if (!host)
+        return TRUE;
+
+    // keep the order of requests to the same host
+    if (host->pending > 0)
+        return FALSE;
+
+    if (!host_ready(host, g_get_monotonic_time()))
+        return FALSE;
+
+    host_acquire(host);
+
+    return TRUE;
+}
+
+static gboolean cbSchedule(gpointer data)
+{
+    gScheduleTimer = 0;
+    schedule_dispatch();
+
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_arm()
+{
+    GList *item = NULL;
+    HttpHost *host = NULL;
+    gint64 delay, minDelay = -1;
+
+    if (gScheduleTimer) {
+        g_source_remove(gScheduleTimer);
+        gScheduleTimer = 0;
+    }
+
+    if (!gPendingTasks)
+        return;
+
+    // wake up when the first waiting host gets its next token,
+    // hosts waiting for a free slot are woken up by completions
+    for (item = gPendingTasks->head; item; item = item->next) {
+        host = get_task_host((HttpReqTask *)item->data);
+        if (!host || host->rate <= 0 || host->tokens >= 1.0)
+            continue;
+
+        delay = (gint64)ceil((1.0 - host->tokens) * G_USEC_PER_SEC / host->rate);
+        if (minDelay < 0 || delay < minDelay)
+            minDelay = delay;
+    }
+
+    if (minDelay >= 0)
+        gScheduleTimer = g_timeout_add((guint)MAX(1, (minDelay + 999) / 1000), cbSchedule, NULL);
+}
+
+static void schedule_enqueue(HttpReqTask *task)
+{
+    HttpHost *host = get_task_host(task);
+
+    if (gPendingTasks == NULL)
+        gPendingTasks = g_queue_new();
+
+    g_queue_push_tail(gPendingTasks, task);
+    task->queueTime = g_get_monotonic_time();
+
+    if (host)
+        host->pending++;
+
+    LS_LOG_DEBUG("schedule: request queued, %u waiting\n", g_queue_get_length(gPendingTasks));
+
+    schedule_arm();
+}
+
+static void schedule_dispatch()
+{
+    GList *item = NULL;
+    GList *next = NULL;
+    HttpReqTask *task = NULL;
+    HttpHost *host = NULL;
+    gint64 now = g_get_monotonic_time();
+
+    if (!gPendingTasks)
+        return;
+
+    for (item = gPendingTasks->head; item; item = next) {
+        next = item->next;
+        task = (HttpReqTask *)item->data;
+        host = get_task_host(task);
+
+        if (host) {
+            if (!host_ready(host, now))
+                continue;
+
+            host_acquire(host);
+        }
+
+        g_queue_delete_link(gPendingTasks, item);
+        if (host)
+            host->pending--;
+
+        task->queueDelay = (long)((now - task->queueTime) / 1000);
+
+        if (!submit_request(task)) {
+            task->curlDesc.curlResultCode = CURLE_FAILED_INIT;
+            task->curlDesc.curlResultErrorStr = (char *)curl_easy_strerror(CURLE_FAILED_INIT);
+            finish_task(task, gResponseData);
+
+            // the callback may have changed the queue
+            next = gPendingTasks ? gPendingTasks->head : NULL;
+        }
+    }
+
+    schedule_arm();
+}
+
+static void schedule_cancel(HttpReqTask *task)
+{
+    HttpHost *host = get_task_host(task);
+
+    g_queue_remove(gPendingTasks, task);
+    if (host)
+        host->pending--;
+
+    schedule_arm();
+}
+
+static void schedule_clear()
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    if (gScheduleTimer) {
+        g_source_remove(gScheduleTimer);
+        gScheduleTimer = 0;
+    }
+
+    if (gPendingTasks) {
+        g_queue_free(gPendingTasks);
+        gPendingTasks = NULL;
+    }
+
+    if (gActiveTasks) {
+        g_hash_table_destroy(gActiveTasks);
+        gActiveTasks = NULL;
+    }
+
+    if (gHttpHosts) {
+        g_hash_table_iter_init(&iter, gHttpHosts);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            ((HttpHost *)value)->pending = 0;
+            ((HttpHost *)value)->inflight = 0;
+        }
+    }
+}
+
+// a synchronous request is not queued: it takes a token if one is left after the requests
+// already waiting for the host, or is refused with the time until its token in queueDelay.
+// It is not counted in flight, so the concurrency limit does not hold it back.
+static gboolean schedule_admit_sync(HttpReqTask *task)
+{
+    HttpHost *host = get_task_host(task);
+
+    if (!host || host->rate <= 0)
+        return TRUE;
+
+    host_refill(host, g_get_monotonic_time());
+
+    if (host->pending > 0 || host->tokens < 1.0) {
+        task->queueDelay = (long)ceil(host_token_delay(host));
+        return FALSE;
+    }
+
+    host_acquire(host);
+
+    return TRUE;
+}
+
+static void cassette_record(HttpReqTask *task)
+{
+    gint32 curlResult = task->curlDesc.curlResultCode;
+    gint32 httpCode = (gint32)task->curlDesc.httpResponseCode;
+    gint64 latency = g_get_monotonic_time() - task->startTime;
+
+    if (gCassetteMode != HTTP_CASSETTE_RECORD || !gCassetteFile)
+        return;
+
+    write_cassette_string(task->url ? task->url : "", task->url ? strlen(task->url) : 0);
+    write_cassette_string(task->post_data, task->post_data ? strlen(task->post_data) : 0);
+    fwrite(&curlResult, sizeof(curlResult), 1, gCassetteFile);
+    fwrite(&httpCode, sizeof(httpCode), 1, gCassetteFile);
+    fwrite(&latency, sizeof(latency), 1, gCassetteFile);
+    write_cassette_string(task->responseData, task->responseSize);
+    fflush(gCassetteFile);
+}
+
+static HttpCassetteEntry *cassette_lookup(HttpReqTask *task)
+{
+    HttpCassetteTrack *track = NULL;
+    HttpCassetteEntry *entry = NULL;
+    gchar *key = get_cassette_key(task);
+
+    // identical requests get the recorded responses in order, the last one repeats
+    if ((track = (HttpCassetteTrack *)g_hash_table_lookup(gCassetteTracks, key)) != NULL) {
+        entry = (HttpCassetteEntry *)g_ptr_array_index(track->entries, track->next);
+        if (track->next + 1 < track->entries->len)
+            track->next++;
+    } else {
+        LS_LOG_WARNING("cassette: no record for [%s]\n", task->url ? task->url : "");
+    }
+
+    g_free(key);
+
+    return entry;
+}
+
+static void cassette_fill(HttpReqTask *task, HttpCassetteEntry *entry)
+{
+    if (!entry) {
+        task->curlDesc.curlResultCode = CURLE_COULDNT_CONNECT;
+        task->curlDesc.curlResultErrorStr = (char *)curl_easy_strerror(CURLE_COULDNT_CONNECT);
+        return;
+    }
+
+    task->curlDesc.curlResultCode = entry->curlResultCode;
+    if (entry->curlResultCode != CURLE_OK)
+        task->curlDesc.curlResultErrorStr = (char *)curl_easy_strerror(entry->curlResultCode);
+    task->curlDesc.httpResponseCode = entry->httpResponseCode;
+
+    if (entry->responseData) {
+        task->responseData = (char *)malloc(entry->responseSize + 1);
+        if (task->responseData) {
+            memcpy(task->responseData, entry->responseData, entry->responseSize);
+            task->responseData[entry->responseSize] = 0;
+            task->responseSize = entry->responseSize;
+        }
+    }
+}
+
+static void cassette_serve(HttpReqTask *task)
+{
+    HttpCassetteEntry *entry = cassette_lookup(task);
+
+    if (entry && gCassetteRealTiming && entry->latency > 0)
+        g_usleep(entry->latency);
+
+    cassette_fill(task, entry);
+}
+
+static gboolean cbCassetteReplay(gpointer data)
+{
+    HttpCassetteReplay *replay = (HttpCassetteReplay *)data;
+    HttpReqTask *task = replay->task;
+
+    // the source is done, remove the task without removing the source again
+    g_hash_table_steal(gCassetteTasks, task);
+
+    cassette_fill(task, replay->entry);
+    finish_task(task, gResponseData);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean cassette_submit(HttpReqTask *task)
+{
+    HttpCassetteReplay *replay = NULL;
+    guint delay = 0;
+    guint source = 0;
+
+    replay = (HttpCassetteReplay *)malloc(sizeof(HttpCassetteReplay));
+    if (!replay)
+        return FALSE;
+
+    // the response is taken now, so that identical requests in flight together
+    // get the recorded responses in the order they were sent, each with its own latency
+    replay->task = task;
+    replay->entry = cassette_lookup(task);
+
+    if (gCassetteRealTiming && replay->entry)
+        delay = (guint)(replay->entry->latency / 1000);
+
+    // responses are delivered from the main loop like those from curl
+    source = g_timeout_add_full(G_PRIORITY_DEFAULT, delay, cbCassetteReplay, replay, free);
+    g_hash_table_insert(gCassetteTasks, task, GUINT_TO_POINTER(source));
+
+    return TRUE;
+}
+
+static void cassette_clear()
+{
+    if (gCassetteTasks) {
+        g_hash_table_destroy(gCassetteTasks);
+        gCassetteTasks = NULL;
+    }
+
+    if (gCassetteMode == HTTP_CASSETTE_REPLAY)
+        gCassetteTasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, cbCassetteSourceRemove);
+}
+
+static void schedule_complete(HttpReqTask *task)
+{
+    HttpHost *host = NULL;
+    gboolean error = FALSE;
+
+    if (!gActiveTasks || (host = (HttpHost *)g_hash_table_lookup(gActiveTasks, task)) == NULL)
+        return;
+
+    g_hash_table_remove(gActiveTasks, task);
+    host->inflight--;
+
+    error = (task->curlDesc.curlResultCode != CURLE_OK ||
+             task->curlDesc.httpResponseCode == 429 ||
+             task->curlDesc.httpResponseCode >= 500);
+    host_update_limit(host, (double)(g_get_monotonic_time() - task->startTime), error);
+    if (task->curlDesc.curlResultCode == CURLE_OK)
+        host_add_sample(host, (double)(g_get_monotonic_time() - task->startTime));
+
+    LS_LOG_DEBUG("schedule: %s limit %.2f inflight %d latency %.0f/%.0f us\n",
+                 host->name, host->limit, host->inflight, host->avgLatency, host->minLatency);
+
+    schedule_dispatch();
+}
+
+static void schedule_release(HttpReqTask *task)
+{
+    HttpHost *host = NULL;
+
+    if (!gActiveTasks || (host = (HttpHost *)g_hash_table_lookup(gActiveTasks, task)) == NULL)
+        return;
+
+    g_hash_table_remove(gActiveTasks, task);
+    host->inflight--;
+
+    schedule_dispatch();
+}
+
+static HttpReqTask *create_hedge_task(HttpReqTask *primary)
+{
+    HttpReqTask *shadow = NULL;
+    GPtrArray *headers = NULL;
+    struct curl_slist *header = NULL;
+
+    headers = g_ptr_array_new();
+    for (header = primary->curlDesc.headerList; header; header = header->next)
+        g_ptr_array_add(headers, header->data);
+
+    shadow = loc_http_task_create((const char **)headers->pdata, (int)headers->len);
+    g_ptr_array_free(headers, TRUE);
+
+    if (!shadow)
+        return NULL;
+
+    if (!loc_http_task_prepare_connection(&shadow, primary->hedgeUrl))
+        goto FAILED;
+
+    if (primary->post_data) {
+        if ((shadow->post_data = strdup(primary->post_data)) == NULL || !prepare_post_data(shadow))
+            goto FAILED;
+    }
+
+    shadow->message = primary->message;
+    shadow->recepient = primary->recepient;
+
+    return shadow;
+
+FAILED:
+    loc_http_task_destroy(&shadow);
+    return NULL;
+}
+
+static gboolean cbHedge(gpointer data)
+{
+    HttpHedge *hedge = (HttpHedge *)data;
+    HttpReqTask *shadow = NULL;
+
+    hedge->timer = 0;
+
+    // hedges are kept to a fraction of the primary requests
+    if (gHedgeSent + 1 > gHedgeBudget * gRequestCount + HEDGE_BUDGET_BURST) {
+        LS_LOG_DEBUG("hedge: over budget, %d hedges of %" G_GUINT64_FORMAT " requests\n", gHedgeSent, gRequestCount);
+        hedge_finish(hedge);
+        return G_SOURCE_REMOVE;
+    }
+
+    if ((shadow = create_hedge_task(hedge->primary)) == NULL) {
+        hedge_finish(hedge);
+        return G_SOURCE_REMOVE;
+    }
+
+    hedge->shadow = shadow;
+    g_hash_table_insert(gHedges, shadow, hedge);
+
+    // the hedge is subject to the rate and concurrency limits of the alternate host
+    if (!schedule_admit(shadow)) {
+        schedule_enqueue(shadow);
+    } else if (!submit_request(shadow)) {
+        hedge_finish(hedge);
+        return G_SOURCE_REMOVE;
+    }
+
+    gHedgeSent++;
+
+    LS_LOG_DEBUG("hedge: sent to [%s]\n", hedge->primary->hedgeUrl);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean hedge_is_shadow(HttpReqTask *task)
+{
+    HttpHedge *hedge = NULL;
+
+    if (!gHedges || (hedge = (HttpHedge *)g_hash_table_lookup(gHedges, task)) == NULL)
+        return FALSE;
+
+    return (hedge->shadow == task);
+}
+
+static void hedge_arm(HttpReqTask *task)
+{
+    HttpHedge *hedge = NULL;
+    HttpHost *host = NULL;
+    long delay = task->hedgeDelay;
+
+    if (!task->hedgeUrl)
+        return;
+
+    if (delay <= 0) {
+        if ((host = get_task_host(task)) == NULL)
+            return;
+
+        // no hedge until enough responses have been seen to know the tail latency
+        if ((delay = (long)(host_get_percentile(host, HEDGE_PERCENTILE) / 1000)) <= 0)
+            return;
+    }
+
+    hedge = (HttpHedge *)malloc(sizeof(HttpHedge));
+    if (!hedge)
+        return;
+    memset(hedge, 0, sizeof(HttpHedge));
+
+    if (gHedges == NULL)
+        gHedges = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+
+    hedge->primary = task;
+    hedge->timer = g_timeout_add((guint)delay, cbHedge, hedge);
+    g_hash_table_insert(gHedges, task, hedge);
+}
+
+// decide on the completion of either request of a hedge,
+// returns the primary task to deliver or NULL to keep waiting for the other one
+static HttpReqTask *hedge_complete(HttpReqTask *task)
+{
+    HttpHedge *hedge = (HttpHedge *)g_hash_table_lookup(gHedges, task);
+    HttpReqTask *primary = NULL;
+    HttpReqTask *shadow = NULL;
+    gboolean success = (task->curlDesc.curlResultCode == CURLE_OK);
+    gboolean primaryRunning = FALSE;
+
+    if (!hedge)
+        return task;
+
+    primary = hedge->primary;
+    shadow = hedge->shadow;
+
+    if (task == primary) {
+        if (!success && shadow && !hedge->primaryFailed) {
+            hedge->primaryFailed = TRUE;
+            return NULL;
+        }
+
+        hedge_finish(hedge);
+        return primary;
+    }
+
+    if (!success && !hedge->primaryFailed) {
+        // the primary may still succeed
+        g_hash_table_remove(gHedges, shadow);
+        hedge->shadow = NULL;
+        loc_http_remove_request(shadow);
+        loc_http_task_destroy(&shadow);
+        return NULL;
+    }
+
+    if (success) {
+        gHedgeWon++;
+
+        if (primary->responseData)
+            free(primary->responseData);
+
+        primary->responseData = shadow->responseData;
+        primary->responseSize = shadow->responseSize;
+        primary->curlDesc.curlResultCode = shadow->curlDesc.curlResultCode;
+        primary->curlDesc.curlResultErrorStr = shadow->curlDesc.curlResultErrorStr;
+        primary->curlDesc.httpResponseCode = shadow->curlDesc.httpResponseCode;
+        primary->curlDesc.httpConnectCode = shadow->curlDesc.httpConnectCode;
+
+        shadow->responseData = NULL;
+        shadow->responseSize = 0;
+    }
+
+    primaryRunning = !hedge->primaryFailed;
+    hedge_finish(hedge);
+
+    // cancel the slower primary request
+    if (primaryRunning)
+        loc_http_remove_request(primary);
+
+    return primary;
+}
+
+static void hedge_finish(HttpHedge *hedge)
+{
+    HttpReqTask *shadow = hedge->shadow;
+
+    if (hedge->timer)
+        g_source_remove(hedge->timer);
+
+    g_hash_table_remove(gHedges, hedge->primary);
+
+    if (shadow) {
+        g_hash_table_remove(gHedges, shadow);
+        loc_http_remove_request(shadow);
+        loc_http_task_destroy(&shadow);
+    }
+
+    free(hedge);
+}
+
+static void hedge_clear()
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    if (!gHedges)
+        return;
+
+    while (g_hash_table_size(gHedges) > 0) {
+        g_hash_table_iter_init(&iter, gHedges);
+        if (g_hash_table_iter_next(&iter, NULL, &value))
+            hedge_finish((HttpHedge *)value);
+    }
+}
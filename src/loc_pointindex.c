@@ -0,0 +1,621 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <loc_pointindex.h>
+
+#define POINTINDEX_MAGIC            "LOCPIDX"
+#define POINTINDEX_VERSION          1
+#define POINTINDEX_BYTE_ORDER       0x01020304
+
+// Candidates of the straight line search are taken this much further than the k-th one,
+// so that the geodesic ranking can reorder them
+#define POINTINDEX_KNN_SLACK        1.001
+
+
+// File layout: the header followed by the nodes, as they are in memory
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t node_size;
+    uint32_t count;
+} PointIndexHeader;
+
+// Nodes of the implicit tree: the node of range [lo, hi) is at (lo + hi) / 2,
+// its children are the ranges on both sides, split along axis
+typedef struct {
+    double xyz[3];
+    double latitude;
+    double longitude;
+    int32_t index;
+    int32_t axis;
+} PointIndexNode;
+
+struct _PointIndex {
+    const PointIndexNode *nodes;
+    int count;
+    PointIndexNode *data;
+    void *map;
+    size_t map_size;
+    // node of each point, by its position in the array the index was built from
+    int32_t *node_of;
+};
+
+typedef struct {
+    double distance;
+    int node;
+} PointIndexCandidate;
+
+// Bounded list of the nearest candidates, worst first (max heap)
+typedef struct {
+    PointIndexCandidate *items;
+    int count;
+    int capacity;
+} CandidateHeap;
+
+// Growable list of candidates
+typedef struct {
+    PointIndexCandidate *items;
+    int count;
+    int capacity;
+} CandidateList;
+
+
+static void to_ecef(double latitude, double longitude, double *xyz);
+static bool map_nodes(PointIndex *index);
+static void build_tree(PointIndexNode *nodes, int lo, int hi);
+static void select_nth(PointIndexNode *nodes, int lo, int hi, int nth, int axis);
+static void search_knn(const PointIndex *index, int lo, int hi, const double *xyz, CandidateHeap *heap);
+static bool search_radius(const PointIndex *index, int lo, int hi, const double *xyz, double sq_radius,
+                          CandidateList *list);
+static void heap_push(CandidateHeap *heap, double distance, int node);
+static bool list_append(CandidateList *list, double distance, int node);
+static int rank_by_geodesic(const PointIndex *index, GEOCoordinates *position, CandidateList *list, double radius);
+static int compare_candidate(const void *a, const void *b);
+
+
+
+PointIndex* loc_pointindex_create(const GEOCoordinates *points, int size)
+{
+    PointIndex *index = NULL;
+    int i;
+
+    if (!points || size <= 0)
+        return NULL;
+
+    index = (PointIndex *)calloc(1, sizeof(PointIndex));
+    if (!index)
+        return NULL;
+
+    index->data = (PointIndexNode *)calloc(size, sizeof(PointIndexNode));
+    if (!index->data) {
+        free(index);
+        return NULL;
+    }
+
+    for (i = 0; i < size; i++) {
+        to_ecef(points[i].latitude, points[i].longitude, index->data[i].xyz);
+        index->data[i].latitude = points[i].latitude;
+        index->data[i].longitude = points[i].longitude;
+        index->data[i].index = i;
+    }
+
+    build_tree(index->data, 0, size);
+
+    index->nodes = index->data;
+    index->count = size;
+
+    if (!map_nodes(index))
+        loc_pointindex_destroy(&index);
+
+    return index;
+}
+
+PointIndex* loc_pointindex_load(const char *path)
+{
+    PointIndex *index = NULL;
+    const PointIndexHeader *header;
+    struct stat st;
+    void *map;
+    int fd;
+
+    if (!path)
+        return NULL;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    // the whole file is mapped, so its size is also a size_t
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(PointIndexHeader) || (off_t)(size_t)st.st_size != st.st_size) {
+        close(fd);
+        return NULL;
+    }
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    header = (const PointIndexHeader *)map;
+    if (memcmp(header->magic, POINTINDEX_MAGIC, sizeof(POINTINDEX_MAGIC)) != 0 ||
+        header->version != POINTINDEX_VERSION ||
+        header->byte_order != POINTINDEX_BYTE_ORDER ||
+        header->node_size != sizeof(PointIndexNode) ||
+        header->count == 0 || header->count > INT32_MAX ||
+        (uint64_t)st.st_size != sizeof(PointIndexHeader) + (uint64_t)header->count * sizeof(PointIndexNode)) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+
+    index = (PointIndex *)calloc(1, sizeof(PointIndex));
+    if (!index) {
+        munmap(map, st.st_size);
+        return NULL;
+    }
+
+    index->nodes = (const PointIndexNode *)((const char *)map + sizeof(PointIndexHeader));
+    index->count = header->count;
+    index->map = map;
+    index->map_size = st.st_size;
+
+    // nodes of a corrupted file are not searched
+    if (!map_nodes(index))
+        loc_pointindex_destroy(&index);
+
+    return index;
+}
+
+int loc_pointindex_save(PointIndex **index_ref, const char *path)
+{
+    PointIndex *index = *index_ref;
+    PointIndexHeader header;
+    FILE *file = NULL;
+    char *tmp_path;
+    bool written;
+    int fd;
+
+    if (!index || !path)
+        return 0;
+
+    memset(&header, 0, sizeof(PointIndexHeader));
+    memcpy(header.magic, POINTINDEX_MAGIC, sizeof(POINTINDEX_MAGIC));
+    header.version = POINTINDEX_VERSION;
+    header.byte_order = POINTINDEX_BYTE_ORDER;
+    header.node_size = sizeof(PointIndexNode);
+    header.count = index->count;
+
+    // written aside and renamed over path, as processes may have the old file mapped
+    tmp_path = (char *)malloc(strlen(path) + sizeof(".XXXXXX"));
+    if (!tmp_path)
+        return 0;
+
+    sprintf(tmp_path, "%s.XXXXXX", path);
+
+    fd = mkstemp(tmp_path);
+    if (fd < 0 || fchmod(fd, 0644) != 0 || (file = fdopen(fd, "wb")) == NULL) {
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmp_path);
+        }
+        free(tmp_path);
+        return 0;
+    }
+
+    written = fwrite(&header, sizeof(PointIndexHeader), 1, file) == 1 &&
+              fwrite(index->nodes, sizeof(PointIndexNode), index->count, file) == (size_t)index->count &&
+              fflush(file) == 0 && fsync(fd) == 0;
+
+    if (fclose(file) != 0 || !written || rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        free(tmp_path);
+        return 0;
+    }
+
+    free(tmp_path);
+
+    return 1;
+}
+
+void loc_pointindex_destroy(PointIndex **index_ref)
+{
+    PointIndex *index = *index_ref;
+
+    if (!index)
+        return;
+
+    if (index->map)
+        munmap(index->map, index->map_size);
+
+    free(index->data);
+    free(index->node_of);
+    free(index);
+    *index_ref = NULL;
+}
+
+int loc_pointindex_get_count(PointIndex **index_ref)
+{
+    PointIndex *index = *index_ref;
+
+    if (!index)
+        return 0;
+
+    return index->count;
+}
+
+GEOCoordinates loc_pointindex_get_point(PointIndex **index_ref, int point_index)
+{
+    PointIndex *index = *index_ref;
+    GEOCoordinates point = {0};
+    const PointIndexNode *node;
+
+    if (!index || point_index < 0 || point_index >= index->count)
+        return point;
+
+    node = &index->nodes[index->node_of[point_index]];
+    point.latitude = node->latitude;
+    point.longitude = node->longitude;
+
+    return point;
+}
+
+int loc_pointindex_knn(PointIndex **index_ref, GEOCoordinates *position, int k, int *indexes, double *distances)
+{
+    PointIndex *index = *index_ref;
+    CandidateHeap heap;
+    CandidateList list;
+    double xyz[3], reach;
+    int i, found;
+
+    if (!index || !position || k <= 0)
+        return 0;
+
+    k = (k < index->count) ? k : index->count;
+
+    heap.items = (PointIndexCandidate *)malloc(sizeof(PointIndexCandidate) * k);
+    if (!heap.items)
+        return 0;
+
+    heap.count = 0;
+    heap.capacity = k;
+
+    to_ecef(position->latitude, position->longitude, xyz);
+    search_knn(index, 0, index->count, xyz, &heap);
+
+    // heap root is the k-th straight line distance, squared
+    reach = sqrt(heap.items[0].distance) * POINTINDEX_KNN_SLACK;
+    free(heap.items);
+
+    memset(&list, 0, sizeof(CandidateList));
+    if (!search_radius(index, 0, index->count, xyz, reach * reach, &list)) {
+        free(list.items);
+        return 0;
+    }
+
+    rank_by_geodesic(index, position, &list, -1);
+
+    found = (list.count < k) ? list.count : k;
+    for (i = 0; i < found; i++) {
+        if (indexes)
+            indexes[i] = index->nodes[list.items[i].node].index;
+        if (distances)
+            distances[i] = list.items[i].distance;
+    }
+
+    free(list.items);
+
+    return found;
+}
+
+int loc_pointindex_radius(PointIndex **index_ref, GEOCoordinates *position, double radius,
+                          int *indexes, double *distances, int max_results)
+{
+    PointIndex *index = *index_ref;
+    CandidateList list;
+    double xyz[3];
+    int i, found;
+
+    if (!index || !position || radius < 0)
+        return 0;
+
+    to_ecef(position->latitude, position->longitude, xyz);
+
+    memset(&list, 0, sizeof(CandidateList));
+    if (!search_radius(index, 0, index->count, xyz, radius * radius, &list)) {
+        free(list.items);
+        return 0;
+    }
+
+    found = rank_by_geodesic(index, position, &list, radius);
+
+    for (i = 0; i < found && i < max_results; i++) {
+        if (indexes)
+            indexes[i] = index->nodes[list.items[i].node].index;
+        if (distances)
+            distances[i] = list.items[i].distance;
+    }
+
+    free(list.items);
+
+    return found;
+}
+
+// Earth centered, earth fixed coordinates on the ellipsoid surface
+static void to_ecef(double latitude, double longitude, double *xyz)
+{
+    GEOCoordinates position = { latitude, longitude };
+    ECEFCoordinates ecef = loc_geometry_convert_wgs84_to_ecef(position, 0);
+
+    xyz[0] = ecef.x;
+    xyz[1] = ecef.y;
+    xyz[2] = ecef.z;
+}
+
+// Map of the points to their nodes, failing on nodes a search could not follow:
+// an axis out of 0 to 2, or a point index out of range or taken twice
+static bool map_nodes(PointIndex *index)
+{
+    const PointIndexNode *node;
+    int i;
+
+    index->node_of = (int32_t *)malloc(sizeof(int32_t) * index->count);
+    if (!index->node_of)
+        return false;
+
+    memset(index->node_of, 0xff, sizeof(int32_t) * index->count);
+
+    for (i = 0; i < index->count; i++) {
+        node = &index->nodes[i];
+
+        if (node->axis < 0 || node->axis > 2 || node->index < 0 || node->index >= index->count ||
+            index->node_of[node->index] >= 0)
+            return false;
+
+        index->node_of[node->index] = i;
+    }
+
+    return true;
+}
+
+// Median split along the axis of the widest spread, recursively
+static void build_tree(PointIndexNode *nodes, int lo, int hi)
+{
+    double min[3], max[3];
+    int i, a, axis, mid;
+
+    if (hi - lo <= 0)
+        return;
+
+    mid = lo + (hi - lo) / 2;
+
+    for (a = 0; a < 3; a++)
+        min[a] = max[a] = nodes[lo].xyz[a];
+
+    for (i = lo + 1; i < hi; i++) {
+        for (a = 0; a < 3; a++) {
+            min[a] = fmin(min[a], nodes[i].xyz[a]);
+            max[a] = fmax(max[a], nodes[i].xyz[a]);
+        }
+    }
+
+    axis = 0;
+    for (a = 1; a < 3; a++) {
+        if (max[a] - min[a] > max[axis] - min[axis])
+            axis = a;
+    }
+
+    select_nth(nodes, lo, hi, mid, axis);
+    nodes[mid].axis = axis;
+
+    build_tree(nodes, lo, mid);
+    build_tree(nodes, mid + 1, hi);
+}
+
+// Quickselect: nodes[nth] gets the node of its rank along axis, smaller ones before it
+static void select_nth(PointIndexNode *nodes, int lo, int hi, int nth, int axis)
+{
+    PointIndexNode tmp;
+    double pivot;
+    int i, j;
+
+    hi--;
+    while (lo < hi) {
+        pivot = nodes[lo + (hi - lo) / 2].xyz[axis];
+        i = lo;
+        j = hi;
+
+        while (i <= j) {
+            while (nodes[i].xyz[axis] < pivot)
+                i++;
+            while (nodes[j].xyz[axis] > pivot)
+                j--;
+
+            if (i <= j) {
+                tmp = nodes[i];
+                nodes[i] = nodes[j];
+                nodes[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+
+        if (nth <= j)
+            hi = j;
+        else if (nth >= i)
+            lo = i;
+        else
+            break;
+    }
+}
+
+static void search_knn(const PointIndex *index, int lo, int hi, const double *xyz, CandidateHeap *heap)
+{
+    const PointIndexNode *node;
+    double d, dx, dy, dz;
+    int mid;
+
+    if (hi - lo <= 0)
+        return;
+
+    mid = lo + (hi - lo) / 2;
+    node = &index->nodes[mid];
+
+    dx = node->xyz[0] - xyz[0];
+    dy = node->xyz[1] - xyz[1];
+    dz = node->xyz[2] - xyz[2];
+    heap_push(heap, dx * dx + dy * dy + dz * dz, mid);
+
+    // near side first, the far side only if the splitting plane is closer than the worst candidate
+    d = xyz[node->axis] - node->xyz[node->axis];
+    if (d < 0) {
+        search_knn(index, lo, mid, xyz, heap);
+        if (heap->count < heap->capacity || d * d < heap->items[0].distance)
+            search_knn(index, mid + 1, hi, xyz, heap);
+    } else {
+        search_knn(index, mid + 1, hi, xyz, heap);
+        if (heap->count < heap->capacity || d * d < heap->items[0].distance)
+            search_knn(index, lo, mid, xyz, heap);
+    }
+}
+
+static bool search_radius(const PointIndex *index, int lo, int hi, const double *xyz, double sq_radius,
+                          CandidateList *list)
+{
+    const PointIndexNode *node;
+    double d, dx, dy, dz;
+    int mid;
+
+    if (hi - lo <= 0)
+        return true;
+
+    mid = lo + (hi - lo) / 2;
+    node = &index->nodes[mid];
+
+    dx = node->xyz[0] - xyz[0];
+    dy = node->xyz[1] - xyz[1];
+    dz = node->xyz[2] - xyz[2];
+    if (dx * dx + dy * dy + dz * dz <= sq_radius && !list_append(list, 0, mid))
+        return false;
+
+    d = xyz[node->axis] - node->xyz[node->axis];
+    if ((d < 0 || d * d <= sq_radius) && !search_radius(index, lo, mid, xyz, sq_radius, list))
+        return false;
+    if ((d >= 0 || d * d <= sq_radius) && !search_radius(index, mid + 1, hi, xyz, sq_radius, list))
+        return false;
+
+    return true;
+}
+
+static void heap_push(CandidateHeap *heap, double distance, int node)
+{
+    PointIndexCandidate item = { distance, node };
+    PointIndexCandidate tmp;
+    int i, child;
+
+    if (heap->count < heap->capacity) {
+        // sift up
+        i = heap->count++;
+        while (i > 0 && heap->items[(i - 1) / 2].distance < distance) {
+            heap->items[i] = heap->items[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap->items[i] = item;
+        return;
+    }
+
+    if (distance >= heap->items[0].distance)
+        return;
+
+    // replace the worst and sift down
+    heap->items[0] = item;
+    i = 0;
+    while ((child = 2 * i + 1) < heap->count) {
+        if (child + 1 < heap->count && heap->items[child + 1].distance > heap->items[child].distance)
+            child++;
+        if (heap->items[child].distance <= heap->items[i].distance)
+            break;
+
+        tmp = heap->items[i];
+        heap->items[i] = heap->items[child];
+        heap->items[child] = tmp;
+        i = child;
+    }
+}
+
+static bool list_append(CandidateList *list, double distance, int node)
+{
+    PointIndexCandidate *items;
+
+    if (list->count == list->capacity) {
+        items = (PointIndexCandidate *)realloc(list->items, sizeof(PointIndexCandidate) *
+                                               (list->capacity ? list->capacity * 2 : 16));
+        if (!items)
+            return false;
+
+        list->items = items;
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+    }
+
+    list->items[list->count].distance = distance;
+    list->items[list->count].node = node;
+    list->count++;
+
+    return true;
+}
+
+// Geodesic distances of the candidates, nearest first, dropping those beyond radius if it is not negative
+static int rank_by_geodesic(const PointIndex *index, GEOCoordinates *position, CandidateList *list, double radius)
+{
+    const PointIndexNode *node;
+    int i, count = 0;
+
+    for (i = 0; i < list->count; i++) {
+        node = &index->nodes[list->items[i].node];
+        list->items[count].node = list->items[i].node;
+        list->items[count].distance = loc_geometry_calc_distance_mode(position->latitude, position->longitude,
+                                                                      node->latitude, node->longitude,
+                                                                      DISTANCE_MODE_GEODESIC);
+        if (radius < 0 || list->items[count].distance <= radius)
+            count++;
+    }
+
+    list->count = count;
+    if (count > 1)
+        qsort(list->items, count, sizeof(PointIndexCandidate), compare_candidate);
+
+    return count;
+}
+
+static int compare_candidate(const void *a, const void *b)
+{
+    const PointIndexCandidate *x = (const PointIndexCandidate *)a;
+    const PointIndexCandidate *y = (const PointIndexCandidate *)b;
+
+    if (x->distance != y->distance)
+        return (x->distance > y->distance) - (x->distance < y->distance);
+
+    return x->node - y->node;
+}
@@ -0,0 +1,342 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Geofence engine against a linear scan of its circles: 10K small circles mixed with
+// large ones and circles around the poles, queried with 200K fixes, then with some removed.
+// Then polygons, convex and concave, fences at the antimeridian, and the exact transitions
+// of an entity walking through a circle and a concave polygon.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <PmLogLib.h>
+#include <loc_geofence.h>
+
+#define TEST_CELL_SIZE      0.0001
+#define TEST_CIRCLES        10000
+#define TEST_LARGE_CIRCLES  20
+#define TEST_POLAR_CIRCLES  4
+#define TEST_FENCES         (TEST_CIRCLES + TEST_LARGE_CIRCLES + TEST_POLAR_CIRCLES)
+#define TEST_FIXES          200000
+#define TEST_CHECK_STEP     10
+#define TEST_MAX_EVENTS     16
+
+// Walk north along a meridian, one step a second, through a circle and then a concave polygon
+#define WALK_LONGITUDE      127.0
+#define WALK_START          37.0005
+#define WALK_STEP           0.001
+#define WALK_STEPS          1000
+#define WALK_DWELL_MS       30000
+
+typedef struct {
+    GEOCoordinates center;
+    double radius;
+    int id;
+} TestCircle;
+
+// the library logs into the context of its application
+PmLogContext gLsLogContext;
+
+static TestCircle gCircles[TEST_FENCES];
+static GeofenceEvent gEvents[TEST_MAX_EVENTS];
+static int gNumEvents = 0;
+static int gFailures = 0;
+
+// U open to the north, around the walk: its base is crossed, then the walk goes up the notch
+static GEOCoordinates gPolygonU[] = {
+    { 37.700, 126.950 }, { 37.700, 127.050 }, { 37.800, 127.050 }, { 37.800, 127.010 },
+    { 37.725, 127.010 }, { 37.725, 126.990 }, { 37.800, 126.990 }, { 37.800, 126.950 }
+};
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            gFailures++;                                                    \
+        }                                                                   \
+    } while (0)
+
+static double uniform(double low, double high)
+{
+    return low + (high - low) * (rand() / (double)RAND_MAX);
+}
+
+static double elapsed_ms(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+// fence ids of the circles containing position, in ascending order as the engine reports them
+static int scan_circles(GEOCoordinates *position, int *ids, int max_ids)
+{
+    int i, count = 0;
+
+    for (i = 0; i < TEST_FENCES; i++) {
+        if (gCircles[i].id < 0)
+            continue;
+
+        // no degree of latitude is shorter than at the equator
+        if (fabs(gCircles[i].center.latitude - position->latitude) * 110574.0 > gCircles[i].radius)
+            continue;
+
+        if (loc_geometry_calc_distance_mode(gCircles[i].center.latitude, gCircles[i].center.longitude,
+                                            position->latitude, position->longitude,
+                                            DISTANCE_MODE_GEODESIC) > gCircles[i].radius)
+            continue;
+
+        if (count < max_ids)
+            ids[count] = gCircles[i].id;
+        count++;
+    }
+
+    return count;
+}
+
+static void check_fixes(GeofenceEngine **engine, GEOCoordinates *fixes, int size)
+{
+    int expected[TEST_FENCES], found[TEST_FENCES];
+    int i, num_expected, num_found, mismatches = 0;
+
+    for (i = 0; i < size; i += TEST_CHECK_STEP) {
+        num_expected = scan_circles(&fixes[i], expected, TEST_FENCES);
+        num_found = loc_geofence_query(engine, &fixes[i], found, TEST_FENCES);
+
+        if (num_found != num_expected || memcmp(found, expected, sizeof(int) * num_found) != 0)
+            mismatches++;
+    }
+
+    CHECK(mismatches == 0);
+}
+
+static void cbTransition(const GeofenceEvent *event, void *user_data)
+{
+    if (gNumEvents < TEST_MAX_EVENTS)
+        gEvents[gNumEvents] = *event;
+    gNumEvents++;
+}
+
+static bool query_is(GeofenceEngine **engine, double latitude, double longitude, int fence_id)
+{
+    GEOCoordinates position = { latitude, longitude };
+    int found[2];
+
+    if (fence_id < 0)
+        return loc_geofence_query(engine, &position, found, 2) == 0;
+
+    return loc_geofence_query(engine, &position, found, 2) == 1 && found[0] == fence_id;
+}
+
+static void check_polygons()
+{
+    GeofenceEngine *engine = loc_geofence_create(0.01);
+    GEOCoordinates triangle[] = { { 35.0, 129.0 }, { 35.0, 129.2 }, { 35.2, 129.1 } };
+    int u, t;
+
+    u = loc_geofence_add_polygon(&engine, gPolygonU, sizeof(gPolygonU) / sizeof(gPolygonU[0]));
+    t = loc_geofence_add_polygon(&engine, triangle, 3);
+    CHECK(u == 0 && t == 1);
+
+    // the base and both arms of the U, not its notch nor around it
+    CHECK(query_is(&engine, 37.710, 127.000, u));
+    CHECK(query_is(&engine, 37.760, 126.970, u));
+    CHECK(query_is(&engine, 37.760, 127.030, u));
+    CHECK(query_is(&engine, 37.760, 127.000, -1));
+    CHECK(query_is(&engine, 37.790, 127.005, -1));
+    CHECK(query_is(&engine, 37.850, 127.000, -1));
+    CHECK(query_is(&engine, 37.690, 127.000, -1));
+    CHECK(query_is(&engine, 37.760, 127.060, -1));
+
+    // inside the triangle, and inside its bounding box only
+    CHECK(query_is(&engine, 35.050, 129.100, t));
+    CHECK(query_is(&engine, 35.150, 129.100, t));
+    CHECK(query_is(&engine, 35.150, 129.010, -1));
+    CHECK(query_is(&engine, 35.150, 129.190, -1));
+
+    loc_geofence_remove(&engine, u);
+    CHECK(query_is(&engine, 37.710, 127.000, -1));
+    CHECK(query_is(&engine, 35.050, 129.100, t));
+
+    loc_geofence_destroy(&engine);
+}
+
+static void check_antimeridian()
+{
+    GeofenceEngine *engine = loc_geofence_create(0.001);
+    GEOCoordinates east = { -16.5, 179.99 };
+    GEOCoordinates west = { -16.5, -179.99 };
+    GEOCoordinates wide = { 0.0, 0.0 };
+    GEOCoordinates beyond = { 0.0, 181.0 };
+    GEOCoordinates crossing[] = { { -16.0, 179.5 }, { -16.0, -179.5 }, { -17.0, -179.5 }, { -17.0, 179.5 } };
+    int e, w, all;
+
+    e = loc_geofence_add_circle(&engine, &east, 5000);
+    w = loc_geofence_add_circle(&engine, &west, 5000);
+    all = loc_geofence_add_circle(&engine, &wide, 15000000);
+    CHECK(e == 0 && w == 1 && all == 2);
+
+    // both circles reach across, and are found from either side
+    CHECK(loc_geofence_query(&engine, &west, NULL, 0) == 2);
+    CHECK(loc_geofence_query(&engine, &east, NULL, 0) == 2);
+    CHECK(query_is(&engine, -16.5, 179.96, e));
+    CHECK(query_is(&engine, -16.5, -179.96, w));
+    CHECK(query_is(&engine, -16.5, 179.94, -1));
+    CHECK(query_is(&engine, -16.5, -179.94, -1));
+
+    // the circle around the whole earth but its antipode
+    CHECK(query_is(&engine, 60.0, 90.0, all));
+    CHECK(query_is(&engine, 0.0, 180.0, -1));
+
+    CHECK(loc_geofence_add_polygon(&engine, crossing, 4) == -1);
+    CHECK(loc_geofence_add_circle(&engine, &beyond, 100) == -1);
+    CHECK(loc_geofence_get_count(&engine) == 3);
+
+    loc_geofence_destroy(&engine);
+}
+
+static bool event_is(int index, int fence_id, GEOFENCE_TRANSITION transition, int step)
+{
+    return gEvents[index].fence_id == fence_id && gEvents[index].entity_id == 7 &&
+           gEvents[index].transition == transition && gEvents[index].timestamp == step * 1000LL;
+}
+
+// the entity enters the circle, dwells in it, leaves it, then enters the base of the U and
+// leaves it up the notch, too soon to dwell
+static void check_walk()
+{
+    GeofenceEngine *engine = loc_geofence_create(0.01);
+    GEOCoordinates center = { 37.5, WALK_LONGITUDE };
+    GEOCoordinates walk = { 0, WALK_LONGITUDE };
+    int circle, u, i, enter = -1, exit = -1;
+
+    circle = loc_geofence_add_circle(&engine, &center, 10000);
+    u = loc_geofence_add_polygon(&engine, gPolygonU, sizeof(gPolygonU) / sizeof(gPolygonU[0]));
+    loc_geofence_set_callback(&engine, cbTransition, NULL);
+    loc_geofence_set_dwell_time(&engine, WALK_DWELL_MS);
+
+    for (i = 0; i < WALK_STEPS; i++) {
+        walk.latitude = WALK_START + i * WALK_STEP;
+        loc_geofence_update(&engine, 7, &walk, i * 1000LL);
+
+        if (loc_geometry_calc_distance_mode(center.latitude, center.longitude, walk.latitude, walk.longitude,
+                                            DISTANCE_MODE_GEODESIC) <= 10000) {
+            if (enter < 0)
+                enter = i;
+        } else if (enter >= 0 && exit < 0) {
+            exit = i;
+        }
+    }
+
+    // the steps where the walk is at 37.7005 and 37.7255
+    CHECK(gNumEvents == 5);
+    CHECK(enter > 0 && exit > enter + WALK_DWELL_MS / 1000);
+    CHECK(event_is(0, circle, GEOFENCE_TRANSITION_ENTER, enter));
+    CHECK(event_is(1, circle, GEOFENCE_TRANSITION_DWELL, enter + WALK_DWELL_MS / 1000));
+    CHECK(event_is(2, circle, GEOFENCE_TRANSITION_EXIT, exit));
+    CHECK(event_is(3, u, GEOFENCE_TRANSITION_ENTER, 700));
+    CHECK(event_is(4, u, GEOFENCE_TRANSITION_EXIT, 725));
+
+    loc_geofence_destroy(&engine);
+}
+
+int main(int argc, char *argv[])
+{
+    GeofenceEngine *engine = NULL;
+    GEOCoordinates *fixes = NULL;
+    struct timespec start;
+    double add_ms, query_ms;
+    int i, found = 0;
+
+    PmLogGetContext("loc-geofence-test", &gLsLogContext);
+    srand(39);
+
+    engine = loc_geofence_create(TEST_CELL_SIZE);
+    fixes = (GEOCoordinates *)malloc(sizeof(GEOCoordinates) * TEST_FIXES);
+    CHECK(engine != NULL && fixes != NULL);
+    if (!engine || !fixes)
+        return 1;
+
+    // small circles over a city, large ones over the region around it, and some around the poles
+    for (i = 0; i < TEST_FENCES; i++) {
+        if (i < TEST_CIRCLES) {
+            gCircles[i].center.latitude = uniform(37.0, 38.0);
+            gCircles[i].center.longitude = uniform(126.5, 127.5);
+            gCircles[i].radius = uniform(50, 2000);
+        } else if (i < TEST_CIRCLES + TEST_LARGE_CIRCLES) {
+            gCircles[i].center.latitude = uniform(37.0, 38.0);
+            gCircles[i].center.longitude = uniform(126.5, 127.5);
+            gCircles[i].radius = uniform(20000, 100000);
+        } else {
+            gCircles[i].center.latitude = (i % 2) ? uniform(88.5, 89.9) : uniform(-89.9, -88.5);
+            gCircles[i].center.longitude = uniform(-179.0, 179.0);
+            gCircles[i].radius = uniform(20000, 200000);
+        }
+    }
+
+    // adding a fence lists it in a bounded number of cells, whatever its size against the cells
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < TEST_FENCES; i++) {
+        gCircles[i].id = loc_geofence_add_circle(&engine, &gCircles[i].center, gCircles[i].radius);
+        CHECK(gCircles[i].id == i);
+    }
+    add_ms = elapsed_ms(&start);
+    CHECK(loc_geofence_get_count(&engine) == TEST_FENCES);
+
+    for (i = 0; i < TEST_FIXES; i++) {
+        if (i % 20 == 0) {
+            fixes[i].latitude = (i % 40) ? uniform(88.0, 90.0) : uniform(-90.0, -88.0);
+            fixes[i].longitude = uniform(-180.0, 180.0);
+        } else {
+            fixes[i].latitude = uniform(36.5, 38.5);
+            fixes[i].longitude = uniform(126.0, 128.0);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < TEST_FIXES; i++)
+        found += loc_geofence_query(&engine, &fixes[i], NULL, 0);
+    query_ms = elapsed_ms(&start);
+    CHECK(found > 0);
+
+    // against the linear scan, on every tenth fix, the polar ones among them
+    check_fixes(&engine, fixes, TEST_FIXES);
+
+    for (i = 0; i < TEST_FENCES; i += 3) {
+        loc_geofence_remove(&engine, gCircles[i].id);
+        gCircles[i].id = -1;
+    }
+    CHECK(loc_geofence_get_count(&engine) == TEST_FENCES - (TEST_FENCES + 2) / 3);
+    check_fixes(&engine, fixes, TEST_FIXES);
+
+    loc_geofence_destroy(&engine);
+    CHECK(engine == NULL);
+    free(fixes);
+
+    check_polygons();
+    check_antimeridian();
+    check_walk();
+
+    printf("%s: %d fences added in %.1f ms, %.2f us per query, %d failures\n",
+           argv[0], TEST_FENCES, add_ms, query_ms * 1000 / TEST_FIXES, gFailures);
+
+    return gFailures ? 1 : 0;
+}
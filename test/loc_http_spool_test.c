@@ -0,0 +1,322 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Offline spool of loc_http against a local server switched off and on:
+// failed requests are spooled up to the bound, survive a restart of the spool,
+// and are replayed in order once a request goes through again.
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <glib.h>
+#include <PmLogLib.h>
+#include <loc_http.h>
+
+#define TEST_TIMEOUT_MS     10000
+#define TEST_SETTLE_MS      200
+#define TEST_MAX_ENTRIES    4
+#define TEST_REQUESTS       6
+#define SERVER_MAX_BODIES   16
+#define SERVER_BUFFER_SIZE  4096
+
+typedef struct {
+    int listenFd;
+    int port;
+    GThread *thread;
+    GMutex lock;
+    int received;
+    char *bodies[SERVER_MAX_BODIES];
+} LocalServer;
+
+// the library logs into the context of its application
+PmLogContext gLsLogContext;
+
+static LocalServer gServer;
+static int gSucceeded = 0;
+static int gFailed = 0;
+static int gFailures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            gFailures++;                                                    \
+        }                                                                   \
+    } while (0)
+
+// read one request and answer it with an empty JSON object
+static void server_handle(int fd)
+{
+    static const char response[] = "HTTP/1.1 200 OK\r\n"
+                                   "Content-Type: application/json\r\n"
+                                   "Content-Length: 2\r\n"
+                                   "Connection: close\r\n\r\n{}";
+    char buffer[SERVER_BUFFER_SIZE];
+    char *headerEnd = NULL;
+    char *length = NULL;
+    size_t size = 0;
+    size_t bodySize = 0;
+    ssize_t n;
+
+    while (size < sizeof(buffer) - 1) {
+        if ((n = read(fd, buffer + size, sizeof(buffer) - 1 - size)) <= 0)
+            return;
+        size += n;
+        buffer[size] = '\0';
+
+        if (!headerEnd && (headerEnd = strstr(buffer, "\r\n\r\n")) != NULL) {
+            headerEnd += 4;
+            if ((length = strcasestr(buffer, "Content-Length:")) != NULL && length < headerEnd)
+                bodySize = strtoul(length + strlen("Content-Length:"), NULL, 10);
+        }
+
+        if (headerEnd && size >= (size_t)(headerEnd - buffer) + bodySize)
+            break;
+    }
+
+    if (!headerEnd)
+        return;
+
+    g_mutex_lock(&gServer.lock);
+    if (gServer.received < SERVER_MAX_BODIES)
+        gServer.bodies[gServer.received] = g_strndup(headerEnd, bodySize);
+    gServer.received++;
+    g_mutex_unlock(&gServer.lock);
+
+    if (write(fd, response, strlen(response)) < 0)
+        perror("write");
+}
+
+static gpointer server_run(gpointer data)
+{
+    int fd;
+
+    // ends when the listening socket is shut down
+    while ((fd = accept(gServer.listenFd, NULL, NULL)) >= 0) {
+        server_handle(fd);
+        close(fd);
+    }
+
+    return NULL;
+}
+
+static gboolean server_on()
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    int reuse = 1;
+
+    if ((gServer.listenFd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return FALSE;
+    setsockopt(gServer.listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(gServer.port);
+
+    if (bind(gServer.listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(gServer.listenFd, 16) != 0 ||
+        getsockname(gServer.listenFd, (struct sockaddr *)&addr, &addrLen) != 0) {
+        close(gServer.listenFd);
+        return FALSE;
+    }
+
+    gServer.port = ntohs(addr.sin_port);
+    gServer.thread = g_thread_new("server", server_run, NULL);
+
+    return TRUE;
+}
+
+static void server_off()
+{
+    shutdown(gServer.listenFd, SHUT_RDWR);
+    close(gServer.listenFd);
+    g_thread_join(gServer.thread);
+    gServer.thread = NULL;
+}
+
+static int server_received()
+{
+    int received;
+
+    g_mutex_lock(&gServer.lock);
+    received = gServer.received;
+    g_mutex_unlock(&gServer.lock);
+
+    return received;
+}
+
+static void cbResponse(HttpReqTask *task, void *user_data)
+{
+    if (task->curlDesc.curlResultCode == CURLE_OK)
+        gSucceeded++;
+    else
+        gFailed++;
+
+    loc_http_remove_request(task);
+    loc_http_task_destroy(&task);
+}
+
+static gboolean send_request(const char *body, gboolean spool)
+{
+    HttpReqTask *task = NULL;
+    char *url = NULL;
+    gboolean ret = FALSE;
+
+    if ((task = loc_http_task_create(NULL, 0)) == NULL)
+        return FALSE;
+
+    url = g_strdup_printf("http://127.0.0.1:%d/upload", gServer.port);
+    task->post_data = strdup(body);
+    loc_http_task_set_spool(task, spool);
+
+    if (loc_http_task_prepare_connection(&task, url) && loc_http_add_request(task, FALSE))
+        ret = TRUE;
+    else
+        loc_http_task_destroy(&task);
+
+    g_free(url);
+
+    return ret;
+}
+
+static gboolean offline_done()
+{
+    return gFailed >= TEST_REQUESTS;
+}
+
+static gboolean online_done()
+{
+    return gSucceeded >= 1 && server_received() >= TEST_MAX_ENTRIES + 1 && loc_http_spool_get_count() == 0;
+}
+
+// run the main loop until done, or for timeout_ms if done is NULL
+static gboolean run_until(gboolean (*done)(), int timeout_ms)
+{
+    gint64 end = g_get_monotonic_time() + timeout_ms * 1000LL;
+
+    while (!done || !done()) {
+        if (g_get_monotonic_time() > end)
+            return (done == NULL);
+
+        if (!g_main_context_iteration(NULL, FALSE))
+            g_usleep(1000);
+    }
+
+    return TRUE;
+}
+
+static int count_files(const char *directory)
+{
+    GDir *dir = g_dir_open(directory, 0, NULL);
+    int count = 0;
+
+    if (!dir)
+        return -1;
+
+    while (g_dir_read_name(dir) != NULL)
+        count++;
+    g_dir_close(dir);
+
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    char body[32];
+    char *directory = NULL;
+    int i;
+
+    PmLogGetContext("loc-http-spool-test", &gLsLogContext);
+    g_mutex_init(&gServer.lock);
+
+    // take a free port and leave it closed, so that requests are refused
+    if (!server_on()) {
+        fprintf(stderr, "failed to start the local server\n");
+        return 1;
+    }
+    server_off();
+
+    directory = g_dir_make_tmp("loc-http-spool-XXXXXX", NULL);
+    CHECK(directory != NULL);
+    if (!directory)
+        return 1;
+
+    loc_http_start();
+    loc_http_set_callback(cbResponse, NULL);
+    CHECK(loc_http_spool_start(directory, TEST_MAX_ENTRIES));
+
+    // offline: every request fails and is spooled, the oldest ones are dropped beyond the bound
+    for (i = 0; i < TEST_REQUESTS; i++) {
+        snprintf(body, sizeof(body), "{\"request\":%d}", i);
+        CHECK(send_request(body, TRUE));
+    }
+    CHECK(run_until(offline_done, TEST_TIMEOUT_MS));
+    CHECK(loc_http_spool_get_count() == TEST_MAX_ENTRIES);
+    CHECK(count_files(directory) == TEST_MAX_ENTRIES);
+
+    // a replay while still offline keeps the entries, one at a time from now on
+    loc_http_spool_replay(1);
+    run_until(NULL, TEST_SETTLE_MS);
+    CHECK(loc_http_spool_get_count() == TEST_MAX_ENTRIES);
+    CHECK(count_files(directory) == TEST_MAX_ENTRIES);
+
+    // entries are on disk and survive a restart of the spool
+    loc_http_spool_stop();
+    CHECK(loc_http_spool_start(directory, TEST_MAX_ENTRIES));
+    CHECK(loc_http_spool_get_count() == TEST_MAX_ENTRIES);
+    loc_http_spool_replay(1);
+    run_until(NULL, TEST_SETTLE_MS);
+
+    // online: the next successful request resumes the replay of the spool in order
+    CHECK(server_on());
+    CHECK(send_request("{\"live\":true}", FALSE));
+    CHECK(run_until(online_done, TEST_TIMEOUT_MS));
+    server_off();
+
+    CHECK(server_received() == TEST_MAX_ENTRIES + 1);
+    CHECK(loc_http_spool_get_count() == 0);
+    CHECK(count_files(directory) == 0);
+
+    if (server_received() == TEST_MAX_ENTRIES + 1) {
+        CHECK(strcmp(gServer.bodies[0], "{\"live\":true}") == 0);
+        for (i = 0; i < TEST_MAX_ENTRIES; i++) {
+            snprintf(body, sizeof(body), "{\"request\":%d}", TEST_REQUESTS - TEST_MAX_ENTRIES + i);
+            CHECK(strcmp(gServer.bodies[i + 1], body) == 0);
+        }
+    }
+
+    loc_http_spool_stop();
+    loc_http_stop();
+
+    for (i = 0; i < SERVER_MAX_BODIES; i++)
+        g_free(gServer.bodies[i]);
+
+    rmdir(directory);
+    g_free(directory);
+    g_mutex_clear(&gServer.lock);
+
+    printf("%s: %d failures\n", argv[0], gFailures);
+
+    return gFailures ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Point index against a brute force ranking of its points: 10K points over a city, with
+// duplicates and some around the poles and the antimeridian, searched by kNN and radius.
+// Then the same searches on the index saved and loaded back, and files which must not load:
+// truncated ones, and ones with a node of a bad axis or point index.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <PmLogLib.h>
+#include <loc_pointindex.h>
+
+#define TEST_POINTS         10000
+#define TEST_DUPLICATES     100
+#define TEST_FAR_POINTS     200
+#define TEST_QUERIES        150
+#define TEST_K              16
+#define TEST_RADIUS         1500.0
+
+// File layout of the index: a header of 24 bytes, its node size at 16 and its count at 20,
+// then the nodes, each ending with its point index and its axis
+#define FILE_HEADER_SIZE    24
+#define FILE_NODE_SIZE_AT   16
+
+// the library logs into the context of its application
+PmLogContext gLsLogContext;
+
+static GEOCoordinates gPoints[TEST_POINTS];
+static double gDistances[TEST_POINTS];
+static int gFailures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            gFailures++;                                                    \
+        }                                                                   \
+    } while (0)
+
+static double uniform(double low, double high)
+{
+    return low + (high - low) * (rand() / (double)RAND_MAX);
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+
+    return (da > db) - (da < db);
+}
+
+// distances of all points to position, by point index, and sorted into sorted
+static void scan_points(GEOCoordinates *position, double *sorted)
+{
+    int i;
+
+    for (i = 0; i < TEST_POINTS; i++) {
+        gDistances[i] = loc_geometry_calc_distance_mode(position->latitude, position->longitude,
+                                                        gPoints[i].latitude, gPoints[i].longitude,
+                                                        DISTANCE_MODE_GEODESIC);
+        sorted[i] = gDistances[i];
+    }
+
+    qsort(sorted, TEST_POINTS, sizeof(double), compare_double);
+}
+
+// results nearest first, each at the distance of its point, the same distances as the scan
+// (points at the same distance may come in any order)
+static bool results_match(const int *indexes, const double *distances, const double *sorted, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (indexes[i] < 0 || indexes[i] >= TEST_POINTS || distances[i] != gDistances[indexes[i]] ||
+            distances[i] != sorted[i])
+            return false;
+    }
+
+    return true;
+}
+
+static void check_queries(PointIndex **index, GEOCoordinates *queries)
+{
+    static double sorted[TEST_POINTS];
+    int indexes[TEST_POINTS];
+    double distances[TEST_POINTS];
+    int i, found, within, mismatches = 0;
+
+    for (i = 0; i < TEST_QUERIES; i++) {
+        scan_points(&queries[i], sorted);
+
+        found = loc_pointindex_knn(index, &queries[i], TEST_K, indexes, distances);
+        if (found != TEST_K || !results_match(indexes, distances, sorted, found))
+            mismatches++;
+
+        for (within = 0; within < TEST_POINTS && sorted[within] <= TEST_RADIUS; within++)
+            ;
+
+        found = loc_pointindex_radius(index, &queries[i], TEST_RADIUS, indexes, distances, TEST_POINTS);
+        if (found != within || !results_match(indexes, distances, sorted, found))
+            mismatches++;
+
+        // the count is of all the points within radius, only max_results of them stored
+        if (loc_pointindex_radius(index, &queries[i], TEST_RADIUS, indexes, distances, 1) != within)
+            mismatches++;
+    }
+
+    CHECK(mismatches == 0);
+}
+
+static bool write_file(const char *path, const char *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    bool written;
+
+    if (!file)
+        return false;
+
+    written = fwrite(data, 1, size, file) == size;
+
+    return fclose(file) == 0 && written;
+}
+
+static bool loads(const char *path)
+{
+    PointIndex *index = loc_pointindex_load(path);
+    bool loaded = (index != NULL);
+
+    loc_pointindex_destroy(&index);
+
+    return loaded;
+}
+
+// the saved file, truncated or with one field of a node changed, must not load
+static void check_corrupted(const char *path, const char *bad_path)
+{
+    char *data, *node;
+    uint32_t node_size;
+    long size;
+    FILE *file;
+
+    file = fopen(path, "rb");
+    CHECK(file != NULL);
+    if (!file)
+        return;
+
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    rewind(file);
+
+    data = (char *)malloc(size);
+    CHECK(data != NULL && fread(data, 1, size, file) == (size_t)size);
+    fclose(file);
+    if (!data)
+        return;
+
+    memcpy(&node_size, data + FILE_NODE_SIZE_AT, sizeof(uint32_t));
+    CHECK(size == FILE_HEADER_SIZE + (long)node_size * TEST_POINTS);
+
+    // unchanged, it loads
+    CHECK(write_file(bad_path, data, size) && loads(bad_path));
+
+    // cut in a node, before the last node, and in the header
+    CHECK(write_file(bad_path, data, size - 1) && !loads(bad_path));
+    CHECK(write_file(bad_path, data, size - node_size) && !loads(bad_path));
+    CHECK(write_file(bad_path, data, FILE_HEADER_SIZE / 2) && !loads(bad_path));
+    CHECK(write_file(bad_path, data, 0) && !loads(bad_path));
+
+    // the axis, then the point index, of a node in the middle of the file
+    node = data + FILE_HEADER_SIZE + (size_t)node_size * (TEST_POINTS / 2);
+
+    memcpy(node + node_size - 4, &(int32_t){ 3 }, sizeof(int32_t));
+    CHECK(write_file(bad_path, data, size) && !loads(bad_path));
+    memcpy(node + node_size - 4, &(int32_t){ -1 }, sizeof(int32_t));
+    CHECK(write_file(bad_path, data, size) && !loads(bad_path));
+    memcpy(node + node_size - 4, &(int32_t){ 0 }, sizeof(int32_t));
+
+    memcpy(node + node_size - 8, &(int32_t){ TEST_POINTS }, sizeof(int32_t));
+    CHECK(write_file(bad_path, data, size) && !loads(bad_path));
+    memcpy(node + node_size - 8, &(int32_t){ -1 }, sizeof(int32_t));
+    CHECK(write_file(bad_path, data, size) && !loads(bad_path));
+
+    // a point index taken twice: that of the first node
+    memcpy(node + node_size - 8, data + FILE_HEADER_SIZE + node_size - 8, sizeof(int32_t));
+    CHECK(write_file(bad_path, data, size) && !loads(bad_path));
+
+    free(data);
+}
+
+int main(int argc, char *argv[])
+{
+    PointIndex *index = NULL, *loaded = NULL;
+    GEOCoordinates queries[TEST_QUERIES];
+    GEOCoordinates point;
+    char path[] = "/tmp/loc_pointindex_test.XXXXXX";
+    char bad_path[sizeof(path) + 4];
+    int i, fd;
+
+    PmLogGetContext("loc-pointindex-test", &gLsLogContext);
+    srand(40);
+
+    // points over a city, some of them the same as others, then around the poles and the antimeridian
+    for (i = 0; i < TEST_POINTS; i++) {
+        if (i < TEST_POINTS - TEST_FAR_POINTS) {
+            gPoints[i].latitude = uniform(37.4, 37.7);
+            gPoints[i].longitude = uniform(126.8, 127.2);
+        } else {
+            gPoints[i].latitude = (i % 2) ? uniform(89.9, 90.0) : uniform(-16.52, -16.48);
+            gPoints[i].longitude = (i % 4 < 2) ? uniform(-180.0, 180.0) : uniform(179.98, 180.0) - 360.0 * (i % 8 < 4);
+        }
+    }
+
+    for (i = 0; i < TEST_DUPLICATES; i++)
+        gPoints[i * 7] = gPoints[i * 7 + 1];
+
+    for (i = 0; i < TEST_QUERIES; i++) {
+        if (i % 10 == 0) {
+            queries[i].latitude = (i % 20) ? 90.0 : -16.5;
+            queries[i].longitude = (i % 30) ? 180.0 : uniform(-180.0, 180.0);
+        } else if (i % 10 == 1) {
+            queries[i] = gPoints[i * 7];
+        } else {
+            queries[i].latitude = uniform(37.4, 37.7);
+            queries[i].longitude = uniform(126.8, 127.2);
+        }
+    }
+
+    CHECK(loc_pointindex_create(gPoints, 0) == NULL);
+    CHECK(loc_pointindex_create(NULL, TEST_POINTS) == NULL);
+
+    index = loc_pointindex_create(gPoints, TEST_POINTS);
+    CHECK(index != NULL);
+    if (!index)
+        return 1;
+
+    CHECK(loc_pointindex_get_count(&index) == TEST_POINTS);
+    point = loc_pointindex_get_point(&index, TEST_POINTS - 1);
+    CHECK(point.latitude == gPoints[TEST_POINTS - 1].latitude && point.longitude == gPoints[TEST_POINTS - 1].longitude);
+
+    check_queries(&index, queries);
+
+    fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd < 0)
+        return 1;
+    close(fd);
+    snprintf(bad_path, sizeof(bad_path), "%s.bad", path);
+
+    // loaded back, it gives the same results, and keeps them when saved over
+    CHECK(loc_pointindex_save(&index, path));
+    loaded = loc_pointindex_load(path);
+    CHECK(loaded != NULL);
+    loc_pointindex_destroy(&index);
+    CHECK(index == NULL);
+
+    if (loaded) {
+        CHECK(loc_pointindex_get_count(&loaded) == TEST_POINTS);
+        for (i = 0; i < TEST_POINTS; i++) {
+            point = loc_pointindex_get_point(&loaded, i);
+            if (point.latitude != gPoints[i].latitude || point.longitude != gPoints[i].longitude)
+                break;
+        }
+        CHECK(i == TEST_POINTS);
+
+        check_queries(&loaded, queries);
+
+        CHECK(loc_pointindex_save(&loaded, path));
+        check_queries(&loaded, queries);
+        loc_pointindex_destroy(&loaded);
+    }
+
+    check_corrupted(path, bad_path);
+    CHECK(loc_pointindex_load("/nonexistent/loc_pointindex_test") == NULL);
+
+    unlink(path);
+    unlink(bad_path);
+
+    printf("%s: %d points, %d queries, %d failures\n", argv[0], TEST_POINTS, TEST_QUERIES, gFailures);
+
+    return gFailures ? 1 : 0;
+}